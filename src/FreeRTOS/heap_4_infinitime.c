@@ -47,6 +47,7 @@ task.h is included from an application file. */
 
 #include "FreeRTOS.h"
 #include "task.h"
+#include "heap_4_infinitime.h"
 
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
 
@@ -60,6 +61,14 @@ task.h is included from an application file. */
 /* Assumes 8bit bytes! */
 #define heapBITS_PER_BYTE		( ( size_t ) 8 )
 
+/* The owner of an allocated block is stored in the two bits of xBlockSize
+below xBlockAllocatedBit. */
+#define heapOWNER_SHIFT			( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 3 )
+#define heapOWNER_MASK			( ( ( size_t ) 3 ) << heapOWNER_SHIFT )
+
+/* Number of tasks that can be assigned an owner with vPortHeapSetTaskOwner(). */
+#define heapMAX_OWNER_TASKS		( 4 )
+
 /* Define the linked list structure.  This is used to link free blocks in order
 of their memory address. */
 typedef struct A_BLOCK_LINK
@@ -106,9 +115,47 @@ static size_t xBlockAllocatedBit = 0;
 
 static size_t xHeapSize = 0;
 
+/* Allocation counters, and the blocks and bytes (including the block headers)
+currently allocated by each owner. */
+static size_t xNumberOfSuccessfulAllocations = 0;
+static size_t xNumberOfSuccessfulFrees = 0;
+static size_t xOwnerBlocks[ heapOWNER_COUNT ] = { 0 };
+static size_t xOwnerBytes[ heapOWNER_COUNT ] = { 0 };
+
+static TaskHandle_t xOwnerTasks[ heapMAX_OWNER_TASKS ] = { NULL };
+static HeapOwner_t xOwnerTaskOwners[ heapMAX_OWNER_TASKS ];
+
+/*-----------------------------------------------------------*/
+
+static HeapOwner_t prvGetTaskOwner( void )
+{
+ TaskHandle_t xTask;
+ size_t x;
+
+ if( xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED )
+ {
+   return heapOWNER_OTHER;
+ }
+
+ xTask = xTaskGetCurrentTaskHandle();
+ for( x = 0; x < heapMAX_OWNER_TASKS; x++ )
+ {
+   if( xOwnerTasks[ x ] == xTask )
+   {
+     return xOwnerTaskOwners[ x ];
+   }
+ }
+ return heapOWNER_OTHER;
+}
 /*-----------------------------------------------------------*/
 
 void *pvPortMalloc( size_t xWantedSize )
+{
+ return pvPortMallocOwned( xWantedSize, prvGetTaskOwner() );
+}
+/*-----------------------------------------------------------*/
+
+void *pvPortMallocOwned( size_t xWantedSize, HeapOwner_t xOwner )
 {
  BlockLink_t *pxBlock, *pxPreviousBlock, *pxNewBlockLink;
  void *pvReturn = NULL;
@@ -129,8 +176,8 @@ void *pvPortMalloc( size_t xWantedSize )
    /* Check the requested block size is not so large that the top bit is
    set.  The top bit of the block size member of the BlockLink_t structure
    is used to determine who owns the block - the application or the
-   kernel, so it must be free. */
-   if( ( xWantedSize & xBlockAllocatedBit ) == 0 )
+   kernel, so it must be free. The owner tag uses the two bits below it. */
+   if( ( xWantedSize & ( xBlockAllocatedBit | heapOWNER_MASK ) ) == 0 )
    {
      /* The wanted size is increased so it can contain a BlockLink_t
      structure in addition to the requested amount of bytes. */
@@ -222,9 +269,13 @@ void *pvPortMalloc( size_t xWantedSize )
            mtCOVERAGE_TEST_MARKER();
          }
 
+         xOwnerBlocks[ xOwner ]++;
+         xOwnerBytes[ xOwner ] += pxBlock->xBlockSize;
+         xNumberOfSuccessfulAllocations++;
+
          /* The block is being returned - it is allocated and owned
          by the application and has no "next" block. */
-         pxBlock->xBlockSize |= xBlockAllocatedBit;
+         pxBlock->xBlockSize |= xBlockAllocatedBit | ( ( size_t ) xOwner << heapOWNER_SHIFT );
          pxBlock->pxNextFreeBlock = NULL;
        }
        else
@@ -269,6 +320,7 @@ void vPortFree( void *pv )
 {
  uint8_t *puc = ( uint8_t * ) pv;
  BlockLink_t *pxLink;
+ HeapOwner_t xOwner;
 
  if( pv != NULL )
  {
@@ -289,10 +341,15 @@ void vPortFree( void *pv )
      {
        /* The block is being returned to the heap - it is no longer
        allocated. */
-       pxLink->xBlockSize &= ~xBlockAllocatedBit;
+       xOwner = ( HeapOwner_t ) ( ( pxLink->xBlockSize & heapOWNER_MASK ) >> heapOWNER_SHIFT );
+       pxLink->xBlockSize &= ~( xBlockAllocatedBit | heapOWNER_MASK );
 
        vTaskSuspendAll();
        {
+         xOwnerBlocks[ xOwner ]--;
+         xOwnerBytes[ xOwner ] -= pxLink->xBlockSize;
+         xNumberOfSuccessfulFrees++;
+
          /* Add this block to the list of free blocks. */
          xFreeBytesRemaining += pxLink->xBlockSize;
          traceFREE( pv, pxLink->xBlockSize );
@@ -331,6 +388,66 @@ size_t xPortGetHeapSize( void )
 }
 /*-----------------------------------------------------------*/
 
+void vPortGetHeapStatistics( HeapStatistics_t *pxHeapStats )
+{
+ BlockLink_t *pxBlock;
+ size_t x;
+
+ vTaskSuspendAll();
+ {
+   pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+   pxHeapStats->xSizeOfLargestFreeBlockInBytes = 0;
+   pxHeapStats->xNumberOfFreeBlocks = 0;
+
+   /* The free list is empty until the first allocation. */
+   if( pxEnd != NULL )
+   {
+     for( pxBlock = xStart.pxNextFreeBlock; pxBlock != pxEnd; pxBlock = pxBlock->pxNextFreeBlock )
+     {
+       pxHeapStats->xNumberOfFreeBlocks++;
+       if( pxBlock->xBlockSize > pxHeapStats->xSizeOfLargestFreeBlockInBytes )
+       {
+         pxHeapStats->xSizeOfLargestFreeBlockInBytes = pxBlock->xBlockSize;
+       }
+     }
+   }
+
+   pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+   pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+   pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+   for( x = 0; x < heapOWNER_COUNT; x++ )
+   {
+     pxHeapStats->xOwnerBlocks[ x ] = xOwnerBlocks[ x ];
+     pxHeapStats->xOwnerBytes[ x ] = xOwnerBytes[ x ];
+   }
+ }
+ ( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+void vPortHeapSetTaskOwner( HeapOwner_t xOwner )
+{
+ TaskHandle_t xTask = xTaskGetCurrentTaskHandle();
+ size_t x;
+
+ vTaskSuspendAll();
+ {
+   for( x = 0; x < heapMAX_OWNER_TASKS; x++ )
+   {
+     if( xOwnerTasks[ x ] == NULL || xOwnerTasks[ x ] == xTask )
+     {
+       xOwnerTasks[ x ] = xTask;
+       xOwnerTaskOwners[ x ] = xOwner;
+       break;
+     }
+   }
+ }
+ ( void ) xTaskResumeAll();
+
+ configASSERT( x < heapMAX_OWNER_TASKS );
+}
+/*-----------------------------------------------------------*/
+
 void vPortInitialiseBlocks( void )
 {
  /* This just exists to keep the linker quiet. */
@@ -478,10 +595,10 @@ void* pvPortRealloc(void* pv, size_t xWantedSize) {
  // Check allocate block
  if ((pxLink->xBlockSize & xBlockAllocatedBit) != 0) {
    // The block is being returned to the heap - it is no longer allocated.
-   block_size = (pxLink->xBlockSize & ~xBlockAllocatedBit) - xHeapStructSize;
+   block_size = (pxLink->xBlockSize & ~(xBlockAllocatedBit | heapOWNER_MASK)) - xHeapStructSize;
 
-   // Allocate a new buffer
-   pvReturn = pvPortMalloc(xWantedSize);
+   // Allocate a new buffer, for the same owner
+   pvReturn = pvPortMallocOwned(xWantedSize, (HeapOwner_t) ((pxLink->xBlockSize & heapOWNER_MASK) >> heapOWNER_SHIFT));
 
    // Check creation and determine the data size to be copied to the new buffer
    if (pvReturn != NULL) {
@@ -0,0 +1,54 @@
+#ifndef HEAP_4_INFINITIME_H
+#define HEAP_4_INFINITIME_H
+
+#include <stddef.h>
+#include "FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Component that owns an allocation. Allocations are attributed to the owner of
+the calling task (see vPortHeapSetTaskOwner()) unless the owner is given
+explicitly with pvPortMallocOwned(). At most 4 owners can be tracked. */
+typedef enum
+{
+  heapOWNER_OTHER = 0,
+  heapOWNER_LVGL,
+  heapOWNER_NIMBLE,
+  heapOWNER_SCREENS,
+  heapOWNER_COUNT
+} HeapOwner_t;
+
+typedef struct xHeapStatistics
+{
+  size_t xAvailableHeapSpaceInBytes;
+  size_t xSizeOfLargestFreeBlockInBytes;
+  size_t xNumberOfFreeBlocks;
+  size_t xMinimumEverFreeBytesRemaining;
+  size_t xNumberOfSuccessfulAllocations;
+  size_t xNumberOfSuccessfulFrees;
+  /* Blocks and bytes (including the block headers) currently allocated by each owner */
+  size_t xOwnerBlocks[ heapOWNER_COUNT ];
+  size_t xOwnerBytes[ heapOWNER_COUNT ];
+} HeapStatistics_t;
+
+void *pvPortMallocOwned( size_t xWantedSize, HeapOwner_t xOwner );
+
+/* Allocator of LVGL (LV_MEM_CUSTOM_ALLOC) */
+static inline void *pvPortMallocLvgl( size_t xWantedSize )
+{
+  return pvPortMallocOwned( xWantedSize, heapOWNER_LVGL );
+}
+
+/* Attributes the following allocations of the calling task to xOwner. */
+void vPortHeapSetTaskOwner( HeapOwner_t xOwner );
+
+/* Walks the free list, the scheduler is suspended meanwhile. */
+void vPortGetHeapStatistics( HeapStatistics_t *pxHeapStats );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEAP_4_INFINITIME_H */
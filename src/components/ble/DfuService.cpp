@@ -1,10 +1,14 @@
 #include "components/ble/DfuService.h"
+#include <algorithm>
 #include <cstring>
 #include "components/ble/BleController.h"
 #include "components/ble/NotificationManager.h"
+#include "components/firmwarevalidator/FirmwareValidator.h"
+#include "components/fs/FS.h"
 #include "components/settings/Settings.h"
 #include "drivers/SpiNorFlash.h"
 #include "systemtask/SystemTask.h"
+#include "utility/Crc16.h"
 #include <nrf_log.h>
 
 using namespace Pinetime::Controllers;
@@ -31,9 +35,11 @@ void TimeoutTimerCallback(TimerHandle_t xTimer) {
 
 DfuService::DfuService(Pinetime::System::SystemTask& systemTask,
                        Pinetime::Controllers::Ble& bleController,
-                       Pinetime::Drivers::SpiNorFlash& spiNorFlash)
+                       Pinetime::Drivers::SpiNorFlash& spiNorFlash,
+                       Pinetime::Controllers::FS& fs)
   : systemTask {systemTask},
     bleController {bleController},
+    fs {fs},
     dfuImage {spiNorFlash},
     characteristicDefinition {{
                                 .uuid = &packetCharacteristicUuid.u,
@@ -79,6 +85,69 @@ void DfuService::Init() {
   ASSERT(res == 0);
 }
 
+void DfuService::PreEraseSlot() {
+#ifndef PINETIME_IS_RECOVERY
+  if (systemTask.GetSettings().GetDfuAndFsMode() == Pinetime::Controllers::Settings::DfuAndFsMode::Disabled) {
+    return;
+  }
+  // Until the running firmware is validated, the slot contains the previous one, which the bootloader needs to revert
+  if (!Pinetime::Controllers::FirmwareValidator().IsValidated()) {
+    return;
+  }
+  // A DFU started before the delay elapsed
+  if (state != States::Idle) {
+    return;
+  }
+  uint32_t slotState = ReadSlotState();
+  if (slotState == slotErasedMagic) {
+    dfuImage.MarkErased();
+    slotStatePersisted = true;
+    return;
+  }
+  if (slotState != slotDirtyMagic) {
+    return;
+  }
+
+  NRF_LOG_INFO("[DFU] Erasing image slot in the background");
+  dfuImage.PreErase([this]() {
+    systemTask.PushMessage(Pinetime::System::Messages::OnDfuSlotErased);
+  });
+#endif
+}
+
+// Returns the magic number of the slot state file, 0 if there is none
+uint32_t DfuService::ReadSlotState() {
+  lfs_file_t file;
+  if (fs.FileOpen(&file, slotStateFile, LFS_O_RDONLY) != LFS_ERR_OK) {
+    return 0;
+  }
+  uint32_t magic = 0;
+  fs.FileRead(&file, reinterpret_cast<uint8_t*>(&magic), sizeof(magic));
+  fs.FileClose(&file);
+  return magic;
+}
+
+bool DfuService::WriteSlotState(uint32_t magic) {
+  lfs_info info;
+  if (fs.Stat("/.system", &info) != LFS_ERR_OK) {
+    fs.DirCreate("/.system");
+  }
+  lfs_file_t file;
+  if (fs.FileOpen(&file, slotStateFile, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) != LFS_ERR_OK) {
+    return false;
+  }
+  fs.FileWrite(&file, reinterpret_cast<const uint8_t*>(&magic), sizeof(magic));
+  fs.FileClose(&file);
+  return true;
+}
+
+void DfuService::PersistSlotState() {
+  if (!dfuImage.IsErased() || slotStatePersisted) {
+    return;
+  }
+  slotStatePersisted = WriteSlotState(slotErasedMagic);
+}
+
 int DfuService::OnServiceData(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context) {
 #ifndef PINETIME_IS_RECOVERY
   if (systemTask.GetSettings().GetDfuAndFsMode() == Pinetime::Controllers::Settings::DfuAndFsMode::Disabled) {
@@ -145,11 +214,20 @@ int DfuService::WritePacketHandler(uint16_t connectionHandle, os_mbuf* om) {
         vTaskDelay(pdMS_TO_TICKS(5));
       }
 
-      dfuImage.Erase();
-
-      uint8_t data[] {16, 1, 1};
-      notificationManager.Send(connectionHandle, controlPointCharacteristicHandle, data, 3);
-      state = States::Init;
+      // The slot is about to be written, the next firmware erases it in the background once it is validated
+      WriteSlotState(slotDirtyMagic);
+      slotStatePersisted = false;
+
+      // Erasing the slot takes seconds, the host task keeps serving the connection in the meantime.
+      // The response is sent once the slot is erased.
+      state = States::Erase;
+      xTimerStop(timeoutTimer, 0);
+      bool erased = dfuImage.Erase([this, connectionHandle](bool success) {
+        OnSlotErased(connectionHandle, success);
+      });
+      if (erased) {
+        OnSlotErased(connectionHandle, true);
+      }
     }
       return 0;
     case States::Init: {
@@ -177,8 +255,11 @@ int DfuService::WritePacketHandler(uint16_t connectionHandle, os_mbuf* om) {
 
     case States::Data: {
       nbPacketReceived++;
-      dfuImage.Append(om->om_data, om->om_len);
-      bytesReceived += om->om_len;
+      // Packets up to the negotiated MTU may span several chained mbufs
+      for (os_mbuf* buffer = om; buffer != nullptr; buffer = SLIST_NEXT(buffer, om_next)) {
+        dfuImage.Append(buffer->om_data, buffer->om_len);
+      }
+      bytesReceived += OS_MBUF_PKTLEN(om);
       bleController.FirmwareUpdateCurrentBytes(bytesReceived);
 
       if ((nbPacketReceived % nbPacketsToNotify) == 0 && bytesReceived != applicationSize) {
@@ -262,8 +343,7 @@ int DfuService::ControlPointHandler(uint16_t connectionHandle, os_mbuf* om) {
         NRF_LOG_INFO("[DFU] -> Receive firmware image requested, but we are not in Start Init");
         return 0;
       }
-      // TODO the chunk size is dependent of the implementation of the host application...
-      dfuImage.Init(20, applicationSize, expectedCrc);
+      dfuImage.Init(applicationSize, expectedCrc);
       NRF_LOG_INFO("[DFU] -> Starting receive firmware");
       state = States::Data;
       return 0;
@@ -311,6 +391,30 @@ int DfuService::ControlPointHandler(uint16_t connectionHandle, os_mbuf* om) {
   }
 }
 
+// Called from the timer task at the end of the erase started by the Start packet, or from the host task if the slot
+// was already erased
+void DfuService::OnSlotErased(uint16_t connectionHandle, bool success) {
+  if (state != States::Erase) {
+    return;
+  }
+  xTimerStart(timeoutTimer, 0);
+
+  if (!success) {
+    NRF_LOG_INFO("[DFU] -> Erase of the image slot failed");
+    bleController.State(Pinetime::Controllers::Ble::FirmwareUpdateStates::Error);
+    Reset();
+    uint8_t data[3] {static_cast<uint8_t>(Opcodes::Response),
+                     static_cast<uint8_t>(Opcodes::StartDFU),
+                     static_cast<uint8_t>(ErrorCodes::OperationFailed)};
+    notificationManager.Send(connectionHandle, controlPointCharacteristicHandle, data, 3);
+    return;
+  }
+
+  uint8_t data[] {16, 1, 1};
+  notificationManager.Send(connectionHandle, controlPointCharacteristicHandle, data, 3);
+  state = States::Init;
+}
+
 void DfuService::OnTimeout() {
   bleController.State(Pinetime::Controllers::Ble::FirmwareUpdateStates::Error);
   Reset();
@@ -366,39 +470,73 @@ void DfuService::NotificationManager::Reset() {
   xTimerStop(timer, 0);
 }
 
-void DfuService::DfuImage::Init(size_t chunkSize, size_t totalSize, uint16_t expectedCrc) {
-  if (chunkSize != 20)
-    return;
-  this->chunkSize = chunkSize;
+void DfuService::DfuImage::Init(size_t totalSize, uint16_t expectedCrc) {
+  WaitWrite();
   this->totalSize = totalSize;
   this->expectedCrc = expectedCrc;
   this->ready = true;
   totalWriteIndex = 0;
   bufferWriteIndex = 0;
+  activeBuffer = 0;
+  writeFailed = false;
+  receivedCrc = ComputeCrc(nullptr, 0, nullptr);
 }
 
-void DfuService::DfuImage::Append(uint8_t* data, size_t size) {
+void DfuService::DfuImage::Append(const uint8_t* data, size_t size) {
   if (!ready)
     return;
-  ASSERT(size <= 20);
-
-  std::memcpy(tempBuffer + bufferWriteIndex, data, size);
-  bufferWriteIndex += size;
 
-  if (bufferWriteIndex == bufferSize) {
-    spiNorFlash.Write(writeOffset + totalWriteIndex, tempBuffer, bufferWriteIndex);
-    totalWriteIndex += bufferWriteIndex;
-    bufferWriteIndex = 0;
+  while (size > 0 && totalWriteIndex + bufferWriteIndex < totalSize) {
+    size_t toCopy = std::min(size, bufferSize - bufferWriteIndex);
+    toCopy = std::min(toCopy, totalSize - (totalWriteIndex + bufferWriteIndex));
+    std::memcpy(buffers[activeBuffer] + bufferWriteIndex, data, toCopy);
+    receivedCrc = ComputeCrc(data, toCopy, &receivedCrc);
+    bufferWriteIndex += toCopy;
+    data += toCopy;
+    size -= toCopy;
+
+    if (bufferWriteIndex == bufferSize || totalWriteIndex + bufferWriteIndex == totalSize) {
+      FlushBuffer();
+    }
   }
 
-  if (bufferWriteIndex > 0 && totalWriteIndex + bufferWriteIndex == totalSize) {
-    spiNorFlash.Write(writeOffset + totalWriteIndex, tempBuffer, bufferWriteIndex);
-    totalWriteIndex += bufferWriteIndex;
+  if (totalWriteIndex == totalSize) {
+    WaitWrite();
     if (totalSize < maxSize)
       WriteMagicNumber();
   }
 }
 
+// Programs the active buffer in the background and switches to the other one
+void DfuService::DfuImage::FlushBuffer() {
+  // The other buffer may still be being programmed
+  WaitWrite();
+
+  writing = true;
+  bool started = spiNorFlash.WriteAsync(writeOffset + totalWriteIndex, buffers[activeBuffer], bufferWriteIndex, [this](bool success) {
+    if (!success) {
+      writeFailed = true;
+    }
+    writing = false;
+  });
+  if (!started) {
+    writing = false;
+    writeFailed = true;
+  }
+
+  totalWriteIndex += bufferWriteIndex;
+  bufferWriteIndex = 0;
+  activeBuffer = (activeBuffer + 1) % nbBuffers;
+}
+
+// Called from the host task. The write in progress programs a single page (bufferSize), which takes a few milliseconds
+// at most: far below the supervision timeout of the connection.
+void DfuService::DfuImage::WaitWrite() {
+  while (writing) {
+    vTaskDelay(1);
+  }
+}
+
 void DfuService::DfuImage::WriteMagicNumber() {
   uint32_t magic[4] = {
     // TODO When this variable is a static constexpr, the values written to the memory are not correct. Why?
@@ -412,49 +550,102 @@ void DfuService::DfuImage::WriteMagicNumber() {
   spiNorFlash.Write(offset, reinterpret_cast<const uint8_t*>(magic), 4 * sizeof(uint32_t));
 }
 
-void DfuService::DfuImage::Erase() {
-  for (size_t erased = 0; erased < maxSize; erased += 0x1000) {
-    spiNorFlash.SectorErase(writeOffset + erased);
+bool DfuService::DfuImage::Erase(const std::function<void(bool success)>& completed) {
+  std::function<void(bool success)> pending = completed;
+  taskENTER_CRITICAL();
+  bool wasErased = erased;
+  bool wasErasing = erasing;
+  erased = false;
+  if (!wasErased) {
+    // A background erase in progress completes it
+    eraseCompleted = std::move(pending);
+    erasing = true;
+  }
+  taskEXIT_CRITICAL();
+
+  if (wasErased) {
+    return true;
+  }
+  if (!wasErasing && !StartErase()) {
+    erasing = false;
+    eraseCompleted = nullptr;
+    completed(false);
+  }
+  return false;
+}
+
+bool DfuService::DfuImage::PreErase(const std::function<void()>& completed) {
+  if (erasing || erased) {
+    return false;
+  }
+  erasing = true;
+  preEraseCompleted = completed;
+  if (!StartErase()) {
+    erasing = false;
+    preEraseCompleted = nullptr;
+    return false;
+  }
+  return true;
+}
+
+bool DfuService::DfuImage::StartErase() {
+  // 64KB block erases for most of the slot (it starts on a 64KB boundary), sector erases for the remainder
+  return spiNorFlash.EraseAsync(writeOffset, maxSize, [this](bool success) {
+    OnErased(success);
+  });
+}
+
+// Called from the timer task
+void DfuService::DfuImage::OnErased(bool success) {
+  taskENTER_CRITICAL();
+  std::function<void(bool success)> updateCompleted = std::move(eraseCompleted);
+  eraseCompleted = nullptr;
+  // An update waiting for the erase writes the slot right away
+  erased = success && updateCompleted == nullptr;
+  erasing = false;
+  taskEXIT_CRITICAL();
+
+  std::function<void()> preErased = std::move(preEraseCompleted);
+  preEraseCompleted = nullptr;
+  if (updateCompleted != nullptr) {
+    updateCompleted(success);
+  } else if (success && preErased != nullptr) {
+    preErased();
   }
 }
 
 bool DfuService::DfuImage::Validate() {
-  uint32_t chunkSize = 200;
-  size_t currentOffset = 0;
-  uint16_t crc = 0;
+  WaitWrite();
+  if (writeFailed) {
+    return false;
+  }
 
-  bool first = true;
+#ifdef PINETIME_DFU_VERIFY_READBACK
+  // Also check what actually landed in the flash, reading both page buffers at once
+  uint8_t* readBuffer = &buffers[0][0];
+  size_t currentOffset = 0;
+  uint16_t crc = ComputeCrc(nullptr, 0, nullptr);
   while (currentOffset < totalSize) {
-    uint32_t readSize = (totalSize - currentOffset) > chunkSize ? chunkSize : (totalSize - currentOffset);
-
-    spiNorFlash.Read(writeOffset + currentOffset, tempBuffer, readSize);
-    if (first) {
-      crc = ComputeCrc(tempBuffer, readSize, NULL);
-      first = false;
-    } else
-      crc = ComputeCrc(tempBuffer, readSize, &crc);
+    size_t readSize = std::min(sizeof(buffers), totalSize - currentOffset);
+    spiNorFlash.Read(writeOffset + currentOffset, readBuffer, readSize);
+    crc = ComputeCrc(readBuffer, readSize, &crc);
     currentOffset += readSize;
   }
+  if (crc != receivedCrc) {
+    return false;
+  }
+#endif
 
-  return (crc == expectedCrc);
+  // The CRC is computed while the packets are received
+  return (receivedCrc == expectedCrc);
 }
 
 uint16_t DfuService::DfuImage::ComputeCrc(uint8_t const* p_data, uint32_t size, uint16_t const* p_crc) {
-  uint16_t crc = (p_crc == NULL) ? 0xFFFF : *p_crc;
-
-  for (uint32_t i = 0; i < size; i++) {
-    crc = static_cast<uint8_t>(crc >> 8) | (crc << 8);
-    crc ^= p_data[i];
-    crc ^= static_cast<uint8_t>(crc & 0xFF) >> 4;
-    crc ^= (crc << 8) << 4;
-    crc ^= ((crc & 0xFF) << 4) << 1;
-  }
-
-  return crc;
+  return Utility::Crc16(p_data, size, (p_crc == NULL) ? 0xFFFF : *p_crc);
 }
 
 bool DfuService::DfuImage::IsComplete() {
   if (!ready)
     return false;
-  return totalWriteIndex == totalSize;
+  return totalWriteIndex == totalSize && !writing;
 }
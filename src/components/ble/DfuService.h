@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <array>
+#include <functional>
 
 #define min // workaround: nimble's min/max macros conflict with libstdc++
 #define max
@@ -20,6 +21,7 @@ namespace Pinetime {
 
   namespace Controllers {
     class Ble;
+    class FS;
     class Settings;
     class NotificationManager;
 
@@ -27,8 +29,14 @@ namespace Pinetime {
     public:
       DfuService(Pinetime::System::SystemTask& systemTask,
                  Pinetime::Controllers::Ble& bleController,
-                 Pinetime::Drivers::SpiNorFlash& spiNorFlash);
+                 Pinetime::Drivers::SpiNorFlash& spiNorFlash,
+                 Pinetime::Controllers::FS& fs);
       void Init();
+      // Erases the image slot in the background so that the next DFU can start right away. Only a slot known to be
+      // written by a previous DFU is erased: a slot in an unknown state is left alone.
+      void PreEraseSlot();
+      // Records in the file system that the slot is erased, once the background erase is done
+      void PersistSlotState();
       int OnServiceData(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context);
       void OnTimeout();
       void Reset();
@@ -56,27 +64,54 @@ namespace Pinetime {
         DfuImage(Pinetime::Drivers::SpiNorFlash& spiNorFlash) : spiNorFlash {spiNorFlash} {
         }
 
-        void Init(size_t chunkSize, size_t totalSize, uint16_t expectedCrc);
-        void Erase();
-        void Append(uint8_t* data, size_t size);
+        void Init(size_t totalSize, uint16_t expectedCrc);
+        // Returns true if the slot has already been erased in the background. Otherwise, the slot is erased in the background
+        // (or the erase in progress is awaited) and completed is called from the timer task when it is done.
+        bool Erase(const std::function<void(bool success)>& completed);
+        // Starts erasing the slot in the background. completed is called from the timer task on success.
+        bool PreErase(const std::function<void()>& completed);
+
+        void MarkErased() {
+          erased = true;
+        }
+
+        bool IsErased() const {
+          return erased;
+        }
+
+        // Accepts packets of any size. Data is programmed one page at a time while the next page is being filled.
+        void Append(const uint8_t* data, size_t size);
         bool Validate();
         bool IsComplete();
 
       private:
         Pinetime::Drivers::SpiNorFlash& spiNorFlash;
-        static constexpr size_t bufferSize = 200;
+        // One flash page, so that each program operation is page aligned
+        static constexpr size_t bufferSize = 256;
+        static constexpr size_t nbBuffers = 2;
         bool ready = false;
-        size_t chunkSize = 0;
         size_t totalSize = 0;
         size_t maxSize = 475136;
         size_t bufferWriteIndex = 0;
         size_t totalWriteIndex = 0;
         static constexpr size_t writeOffset = 0x40000;
-        uint8_t tempBuffer[bufferSize];
+        uint8_t buffers[nbBuffers][bufferSize];
+        uint8_t activeBuffer = 0;
         uint16_t expectedCrc = 0;
-
+        uint16_t receivedCrc = 0;
+        volatile bool erasing = false;
+        volatile bool erased = false;
+        volatile bool writing = false;
+        volatile bool writeFailed = false;
+        std::function<void(bool success)> eraseCompleted;
+        std::function<void()> preEraseCompleted;
+
+        bool StartErase();
+        void OnErased(bool success);
+        void FlushBuffer();
+        void WaitWrite();
         void WriteMagicNumber();
-        uint16_t ComputeCrc(uint8_t const* p_data, uint32_t size, uint16_t const* p_crc);
+        static uint16_t ComputeCrc(uint8_t const* p_data, uint32_t size, uint16_t const* p_crc);
       };
 
       static constexpr ble_uuid128_t serviceUuid {
@@ -86,6 +121,7 @@ namespace Pinetime {
     private:
       Pinetime::System::SystemTask& systemTask;
       Pinetime::Controllers::Ble& bleController;
+      Pinetime::Controllers::FS& fs;
       DfuImage dfuImage;
       NotificationManager notificationManager;
 
@@ -117,7 +153,7 @@ namespace Pinetime {
       uint16_t controlPointCharacteristicHandle;
       uint16_t revisionCharacteristicHandle;
 
-      enum class States : uint8_t { Idle, Init, Start, Data, Validate, Validated };
+      enum class States : uint8_t { Idle, Init, Start, Erase, Data, Validate, Validated };
       States state = States::Idle;
 
       enum class ImageTypes : uint8_t {
@@ -160,8 +196,18 @@ namespace Pinetime {
       int SendDfuRevision(os_mbuf* om) const;
       int WritePacketHandler(uint16_t connectionHandle, os_mbuf* om);
       int ControlPointHandler(uint16_t connectionHandle, os_mbuf* om);
+      void OnSlotErased(uint16_t connectionHandle, bool success);
 
       TimerHandle_t timeoutTimer;
+
+      // Records whether the image slot is erased, or was written by a DFU since it was last erased
+      static constexpr const char* slotStateFile = "/.system/dfuslot.dat";
+      static constexpr uint32_t slotErasedMagic = 0x45524153;
+      static constexpr uint32_t slotDirtyMagic = 0x54524944;
+      bool slotStatePersisted = false;
+
+      uint32_t ReadSlotState();
+      bool WriteSlotState(uint32_t magic);
     };
   }
 }
\ No newline at end of file
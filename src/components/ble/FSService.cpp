@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <nrf_log.h>
 #include "FSService.h"
 #include "components/ble/BleController.h"
@@ -19,6 +20,7 @@ int FSServiceCallback(uint16_t conn_handle, uint16_t attr_handle, struct ble_gat
 FSService::FSService(Pinetime::System::SystemTask& systemTask, Pinetime::Controllers::FS& fs)
   : systemTask {systemTask},
     fs {fs},
+    installer {fs},
     characteristicDefinition {{.uuid = &fsVersionUuid.u,
                                .access_cb = FSServiceCallback,
                                .arg = this,
@@ -28,7 +30,8 @@ FSService::FSService(Pinetime::System::SystemTask& systemTask, Pinetime::Control
                                 .uuid = &fsTransferUuid.u,
                                 .access_cb = FSServiceCallback,
                                 .arg = this,
-                                .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_READ | BLE_GATT_CHR_F_NOTIFY,
+                                .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_WRITE_NO_RSP | BLE_GATT_CHR_F_READ |
+                                         BLE_GATT_CHR_F_NOTIFY,
                                 .val_handle = &transferCharacteristicHandle,
                               },
                               {0}},
@@ -77,128 +80,116 @@ int FSService::OnFSServiceRequested(uint16_t connectionHandle, uint16_t attribut
 int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
   auto command = static_cast<commands>(om->om_data[0]);
   NRF_LOG_INFO("[FS_S] -> FSCommandHandler Command %d", command);
-  // Just always make sure we are awake...
-  systemTask.PushMessage(Pinetime::System::Messages::StartFileTransfer);
-  vTaskDelay(10);
-  while (systemTask.IsSleeping()) {
-    vTaskDelay(100); // 50ms
+  // Data chunks of the session in progress skip the wake up handshake, the session holds a wake lock
+  bool sessionCommand = (command == commands::READ_PACING && state == FSState::READ) ||
+                        (command == commands::WRITE_DATA && (state == FSState::WRITE || state == FSState::INSTALL));
+  if (!sessionCommand) {
+    CloseSession();
+    // Just always make sure we are awake...
+    systemTask.PushMessage(Pinetime::System::Messages::StartFileTransfer);
+    vTaskDelay(10);
+    while (systemTask.IsSleeping()) {
+      vTaskDelay(100); // 50ms
+    }
   }
   lfs_dir_t dir = {0};
   lfs_info info = {0};
-  lfs_file f = {0};
   switch (command) {
     case commands::READ: {
       NRF_LOG_INFO("[FS_S] -> Read");
       auto* header = (ReadHeader*) om->om_data;
       uint16_t plen = header->pathlen;
-      if (plen > maxpathlen) { //> counts for null term
-        return -1;
+      if (plen >= maxpathlen) { // leaves room for the null terminator
+        ReadResponse resp {};
+        resp.command = commands::READ_DATA;
+        resp.status = (int8_t) LFS_ERR_NAMETOOLONG;
+        resp.chunkoff = header->chunkoff;
+        Notify(connectionHandle, &resp, sizeof(ReadResponse), nullptr, 0);
+        break;
       }
       memcpy(filepath, header->pathstr, plen);
       filepath[plen] = 0; // Copy and null terminate string
-      ReadResponse resp;
-      os_mbuf* om;
-      resp.command = commands::READ_DATA;
-      resp.status = 0x01;
-      resp.chunkoff = header->chunkoff;
-      int res = fs.Stat(filepath, &info);
-      if (res == LFS_ERR_NOENT && info.type != LFS_TYPE_DIR) {
-        resp.status = (int8_t) res;
-        resp.chunklen = 0;
-        resp.totallen = 0;
-        om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
-      } else {
-        resp.chunklen = std::min(header->chunksize, info.size); // TODO add mtu somehow
-        resp.totallen = info.size;
-        fs.FileOpen(&f, filepath, LFS_O_RDONLY);
-        fs.FileSeek(&f, header->chunkoff);
-        uint8_t fileData[resp.chunklen] = {0};
-        resp.chunklen = fs.FileRead(&f, fileData, resp.chunklen);
-        om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
-        os_mbuf_append(om, fileData, resp.chunklen);
-        fs.FileClose(&f);
-      }
-
-      ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
+      window = std::max<uint8_t>(header->window, 1);
+      SendReadData(connectionHandle, header->chunkoff, header->chunksize);
       break;
     }
     case commands::READ_PACING: {
       NRF_LOG_INFO("[FS_S] -> Readpacing");
-      auto* header = (ReadHeader*) om->om_data;
-      ReadResponse resp;
-      resp.command = commands::READ_DATA;
-      resp.status = 0x01;
-      resp.chunkoff = header->chunkoff;
-      int res = fs.Stat(filepath, &info);
-      if (res == LFS_ERR_NOENT && info.type != LFS_TYPE_DIR) {
-        resp.status = (int8_t) res;
-        resp.chunklen = 0;
-        resp.totallen = 0;
-      } else {
-        resp.chunklen = std::min(header->chunksize, info.size); // TODO add mtu somehow
-        resp.totallen = info.size;
-        fs.FileOpen(&f, filepath, LFS_O_RDONLY);
-        fs.FileSeek(&f, header->chunkoff);
-      }
-      os_mbuf* om;
-      if (resp.chunklen > 0) {
-        uint8_t fileData[resp.chunklen] = {0};
-        resp.chunklen = fs.FileRead(&f, fileData, resp.chunklen);
-        om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
-        os_mbuf_append(om, fileData, resp.chunklen);
-      } else {
-        resp.chunklen = 0;
-        om = ble_hs_mbuf_from_flat(&resp, sizeof(ReadResponse));
-      }
-      fs.FileClose(&f);
-      ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
+      auto* header = (ReadPacing*) om->om_data;
+      SendReadData(connectionHandle, header->chunkoff, header->chunksize);
       break;
     }
     case commands::WRITE: {
       NRF_LOG_INFO("[FS_S] -> Write");
       auto* header = (WriteHeader*) om->om_data;
+      WriteResponse resp {};
+      resp.command = commands::WRITE_PACING;
+      resp.offset = header->offset;
+      resp.modTime = 0;
       uint16_t plen = header->pathlen;
-      if (plen > maxpathlen) { //> counts for null term
-        return -1;             // TODO make this actually return a BLE notif
+      if (plen >= maxpathlen) { // leaves room for the null terminator
+        resp.status = (int8_t) LFS_ERR_NAMETOOLONG;
+        Notify(connectionHandle, &resp, sizeof(WriteResponse), nullptr, 0);
+        break;
       }
       memcpy(filepath, header->pathstr, plen);
       filepath[plen] = 0; // Copy and null terminate string
       fileSize = header->totalSize;
-      WriteResponse resp;
-      resp.command = commands::WRITE_PACING;
-      resp.offset = header->offset;
-      resp.modTime = 0;
+      window = std::max<uint8_t>(header->window, 1);
+      chunksSinceAck = 0;
 
-      int res = fs.FileOpen(&f, filepath, LFS_O_RDWR | LFS_O_CREAT);
-      if (res == 0) {
-        fs.FileClose(&f);
-        resp.status = (res == 0) ? 0x01 : (int8_t) res;
-      }
-      resp.freespace = std::min(fs.getSize() - (fs.GetFSSize() * fs.getBlockSize()), fileSize - header->offset);
-      auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(WriteResponse));
-      ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
+      int res = OpenSession(FSState::WRITE, LFS_O_RDWR | LFS_O_CREAT);
+      resp.status = (res == 0) ? 0x01 : (int8_t) res;
+      resp.freespace = std::min<uint32_t>(FreeSpace(), fileSize - header->offset);
+      Notify(connectionHandle, &resp, sizeof(WriteResponse), nullptr, 0);
       break;
     }
     case commands::WRITE_DATA: {
       NRF_LOG_INFO("[FS_S] -> WriteData");
-      auto* header = (WritePacing*) om->om_data;
-      WriteResponse resp;
-      resp.command = commands::WRITE_PACING;
-      resp.offset = header->offset;
-      int res = 0;
-
-      if (!(res = fs.FileOpen(&f, filepath, LFS_O_RDWR | LFS_O_CREAT))) {
-        if ((res = fs.FileSeek(&f, header->offset)) >= 0) {
-          res = fs.FileWrite(&f, header->data, header->dataSize);
-        }
-        fs.FileClose(&f);
+      // Chunks up to the negotiated MTU may span several chained mbufs
+      uint32_t packetSize = OS_MBUF_PKTLEN(om);
+      if (packetSize < sizeof(WritePacing)) {
+        break;
       }
-      if (res < 0) {
-        resp.status = (int8_t) res;
+      WritePacing header;
+      os_mbuf_copydata(om, 0, sizeof(WritePacing), &header);
+      uint32_t dataSize = packetSize - sizeof(WritePacing);
+      if (header.dataSize != dataSize || dataSize > sizeof(chunkBuffer)) {
+        // The chunk doesn't match its header: nothing is written and the session ends, the client resends from the offset
+        WriteResponse resp {};
+        resp.command = (state == FSState::INSTALL) ? commands::INSTALL_PACING : commands::WRITE_PACING;
+        resp.status = (int8_t) LFS_ERR_INVAL;
+        resp.offset = header.offset;
+        resp.modTime = 0;
+        CloseSession();
+        resp.freespace = FreeSpace();
+        Notify(connectionHandle, &resp, sizeof(WriteResponse), nullptr, 0);
+        break;
+      }
+      os_mbuf_copydata(om, sizeof(WritePacing), dataSize, chunkBuffer);
+      if (state == FSState::INSTALL) {
+        InstallData(connectionHandle, header, chunkBuffer, dataSize);
+      } else {
+        WriteData(connectionHandle, header, chunkBuffer, dataSize);
       }
-      resp.freespace = std::min(fs.getSize() - (fs.GetFSSize() * fs.getBlockSize()), fileSize - header->offset);
-      auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(WriteResponse));
-      ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
+      break;
+    }
+    case commands::INSTALL: {
+      NRF_LOG_INFO("[FS_S] -> Install");
+      auto* header = (InstallHeader*) om->om_data;
+      window = std::max<uint8_t>(header->window, 1);
+      chunksSinceAck = 0;
+      installer.Begin();
+      state = FSState::INSTALL;
+      systemTask.PushMessage(Pinetime::System::Messages::StartFileTransfer);
+
+      WriteResponse resp {};
+      resp.command = commands::INSTALL_PACING;
+      resp.status = 0x01;
+      resp.offset = 0;
+      resp.modTime = 0;
+      resp.freespace = FreeSpace();
+      Notify(connectionHandle, &resp, sizeof(WriteResponse), nullptr, 0);
       break;
     }
     case commands::DELETE: {
@@ -211,6 +202,10 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       DelResponse resp {};
       resp.command = commands::DELETE_STATUS;
       int res = fs.FileDelete(path);
+      freeSpaceValid = false;
+      if (res == 0) {
+        installer.OnFileModified(path);
+      }
       resp.status = (res == 0) ? 0x01 : (int8_t) res;
       auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(DelResponse));
       ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
@@ -308,6 +303,10 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       MoveResponse resp {};
       resp.command = commands::MOVE_STATUS;
       int8_t res = (int8_t) fs.Rename(header->pathstr, path);
+      if (res == 0) {
+        installer.OnFileModified(header->pathstr);
+        installer.OnFileModified(path);
+      }
       resp.status = (res == 0) ? 1 : res;
       auto* om = ble_hs_mbuf_from_flat(&resp, sizeof(MoveResponse));
       ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om);
@@ -316,10 +315,199 @@ int FSService::FSCommandHandler(uint16_t connectionHandle, os_mbuf* om) {
       break;
   }
   NRF_LOG_INFO("[FS_S] -> done ");
-  systemTask.PushMessage(Pinetime::System::Messages::StopFileTransfer);
+  if (!sessionCommand) {
+    systemTask.PushMessage(Pinetime::System::Messages::StopFileTransfer);
+  }
+  return 0;
+}
+
+void FSService::Reset() {
+  CloseSession();
+  freeSpaceValid = false;
+}
+
+int FSService::OpenSession(FSState newState, int flags) {
+  lfs_info info = {0};
+  int res = fs.Stat(filepath, &info);
+  if (res == 0 && info.type == LFS_TYPE_DIR) {
+    return LFS_ERR_ISDIR;
+  }
+  if (res < 0 && !(res == LFS_ERR_NOENT && (flags & LFS_O_CREAT))) {
+    return res;
+  }
+  res = fs.FileOpen(&sessionFile, filepath, flags);
+  if (res < 0) {
+    return res;
+  }
+  if (newState == FSState::WRITE) {
+    installer.OnFileModified(filepath);
+  }
+  state = newState;
+  sessionPosition = 0;
+  sessionFileSize = info.size;
+  systemTask.PushMessage(Pinetime::System::Messages::StartFileTransfer);
   return 0;
 }
 
+int FSService::CloseSession() {
+  FSState previousState = state;
+  if (previousState == FSState::IDLE) {
+    return 0;
+  }
+  state = FSState::IDLE;
+  systemTask.PushMessage(Pinetime::System::Messages::StopFileTransfer);
+  if (previousState == FSState::INSTALL) {
+    // The installation resumes from the manifest on the next INSTALL
+    installer.Abort();
+    freeSpaceValid = false;
+    return 0;
+  }
+  return fs.FileClose(&sessionFile);
+}
+
+// Sends up to window chunks, starting at offset. The session ends with the last chunk of the file.
+void FSService::SendReadData(uint16_t connectionHandle, uint32_t offset, uint32_t chunkSize) {
+  ReadResponse resp {};
+  resp.command = commands::READ_DATA;
+  resp.status = 0x01;
+  resp.chunkoff = offset;
+
+  int res = 0;
+  if (state != FSState::READ) {
+    res = OpenSession(FSState::READ, LFS_O_RDONLY);
+  }
+  if (res < 0) {
+    resp.status = (int8_t) res;
+    Notify(connectionHandle, &resp, sizeof(ReadResponse), nullptr, 0);
+    return;
+  }
+
+  uint32_t mtuChunkSize = ble_att_mtu(connectionHandle) - 3 - sizeof(ReadResponse);
+  chunkSize = std::min({chunkSize, mtuChunkSize, static_cast<uint32_t>(maxChunkSize)});
+  for (uint8_t i = 0; i < window && state == FSState::READ; i++) {
+    if (offset != sessionPosition) {
+      res = fs.FileSeek(&sessionFile, offset);
+      sessionPosition = offset;
+    }
+    if (res >= 0) {
+      uint32_t remaining = (sessionFileSize > offset) ? sessionFileSize - offset : 0;
+      res = fs.FileRead(&sessionFile, chunkBuffer, std::min(chunkSize, remaining));
+    }
+
+    resp.chunkoff = offset;
+    resp.totallen = sessionFileSize;
+    if (res < 0) {
+      resp.status = (int8_t) res;
+      resp.chunklen = 0;
+    } else {
+      resp.chunklen = res;
+      offset += res;
+      sessionPosition = offset;
+    }
+    if (res <= 0 || offset >= sessionFileSize) {
+      CloseSession();
+    }
+    Notify(connectionHandle, &resp, sizeof(ReadResponse), chunkBuffer, resp.chunklen);
+  }
+}
+
+// Acknowledges every window chunks, on error, and at the end of the file, which also closes the session
+void FSService::WriteData(uint16_t connectionHandle, const WritePacing& header, const uint8_t* data, uint32_t dataSize) {
+  WriteResponse resp {};
+  resp.command = commands::WRITE_PACING;
+  resp.status = 0x01;
+  resp.offset = header.offset;
+  resp.modTime = 0;
+
+  int res = 0;
+  if (state != FSState::WRITE) {
+    res = OpenSession(FSState::WRITE, LFS_O_RDWR | LFS_O_CREAT);
+  }
+  if (res >= 0 && header.offset != sessionPosition) {
+    res = fs.FileSeek(&sessionFile, header.offset);
+    sessionPosition = header.offset;
+  }
+  if (res >= 0) {
+    res = fs.FileWrite(&sessionFile, data, dataSize);
+  }
+  if (res >= 0) {
+    sessionPosition += res;
+    if (sessionPosition > sessionFileSize) {
+      uint32_t growth = sessionPosition - sessionFileSize;
+      freeSpace = FreeSpace() - std::min(growth, FreeSpace());
+      sessionFileSize = sessionPosition;
+    }
+  }
+
+  bool last = (res < 0) || (header.offset + dataSize >= static_cast<uint32_t>(fileSize));
+  if (last) {
+    // Closing the file commits it to the flash
+    int closeResult = CloseSession();
+    if (res >= 0) {
+      res = closeResult;
+    }
+  }
+  if (res < 0) {
+    resp.status = (int8_t) res;
+  }
+
+  chunksSinceAck++;
+  if (last || chunksSinceAck >= window) {
+    chunksSinceAck = 0;
+    resp.freespace = std::min<uint32_t>(FreeSpace(), fileSize - header.offset);
+    Notify(connectionHandle, &resp, sizeof(WriteResponse), nullptr, 0);
+  }
+}
+
+// Acknowledges with the offset of the next byte expected by the installer, immediately when the client has to jump to it
+void FSService::InstallData(uint16_t connectionHandle, const WritePacing& header, const uint8_t* data, uint32_t dataSize) {
+  uint32_t nextOffset = installer.Write(header.offset, data, dataSize);
+
+  WriteResponse resp {};
+  resp.command = commands::INSTALL_PACING;
+  resp.status = 0x01;
+  resp.offset = nextOffset;
+  resp.modTime = 0;
+
+  bool done = installer.GetStatus() != ResourceInstaller::Status::InProgress;
+  if (installer.GetStatus() == ResourceInstaller::Status::Failed) {
+    resp.status = (int8_t) installer.GetError();
+  }
+  if (done) {
+    CloseSession();
+  }
+
+  chunksSinceAck++;
+  if (done || nextOffset != header.offset + dataSize || chunksSinceAck >= window) {
+    chunksSinceAck = 0;
+    resp.freespace = FreeSpace();
+    Notify(connectionHandle, &resp, sizeof(WriteResponse), nullptr, 0);
+  }
+}
+
+uint32_t FSService::FreeSpace() {
+  if (!freeSpaceValid) {
+    freeSpace = fs.getSize() - (fs.GetFSSize() * fs.getBlockSize());
+    freeSpaceValid = true;
+  }
+  return freeSpace;
+}
+
+// Several notifications can be queued at once: when the mbuf pool is exhausted, wait for the previous ones to be sent
+void FSService::Notify(uint16_t connectionHandle, const void* header, size_t headerSize, const uint8_t* data, size_t dataSize) {
+  for (uint8_t attempt = 0; attempt < maxNotifyAttempts; attempt++) {
+    os_mbuf* om = ble_hs_mbuf_from_flat(header, headerSize);
+    if (om != nullptr && dataSize > 0 && os_mbuf_append(om, data, dataSize) != 0) {
+      os_mbuf_free_chain(om);
+      om = nullptr;
+    }
+    if (om != nullptr && ble_gattc_notify_custom(connectionHandle, transferCharacteristicHandle, om) != BLE_HS_ENOMEM) {
+      return;
+    }
+    vTaskDelay(1);
+  }
+}
+
 // Loads resp with file data given a valid filepath header and resp
 void FSService::prepareReadDataResp(ReadHeader* header, ReadResponse* resp) {
   // uint16_t plen = header->pathlen;
@@ -5,7 +5,10 @@
 #undef max
 #undef min
 
+#include <algorithm>
+
 #include "components/fs/FS.h"
+#include "components/fs/ResourceInstaller.h"
 
 namespace Pinetime {
   namespace System {
@@ -24,6 +27,8 @@ namespace Pinetime {
 
       int OnFSServiceRequested(uint16_t connectionHandle, uint16_t attributeHandle, ble_gatt_access_ctxt* context);
       void NotifyFSRaw(uint16_t connectionHandle);
+      // Closes the file transfer in progress, if any
+      void Reset();
 
     private:
       Pinetime::System::SystemTask& systemTask;
@@ -35,7 +40,7 @@ namespace Pinetime {
       static constexpr uint16_t FSServiceId {0xFEBB};
       static constexpr uint16_t fsVersionId {0x0100};
       static constexpr uint16_t fsTransferId {0x0200};
-      uint16_t fsVersion = {0x0004};
+      uint16_t fsVersion = {0x0005};
       static constexpr uint16_t maxpathlen = 256;
       static constexpr ble_uuid16_t fsServiceUuid {
         .u {.type = BLE_UUID_TYPE_16},
@@ -69,20 +74,41 @@ namespace Pinetime {
         LISTDIR = 0x50,
         LISTDIR_ENTRY = 0x51,
         MOVE = 0x60,
-        MOVE_STATUS = 0x61
+        MOVE_STATUS = 0x61,
+        INSTALL = 0x70,
+        INSTALL_PACING = 0x71
       };
       enum class FSState : uint8_t {
         IDLE = 0x00,
         READ = 0x01,
         WRITE = 0x02,
+        INSTALL = 0x03,
       };
-      FSState state;
+      FSState state = FSState::IDLE;
       char filepath[maxpathlen]; // TODO ..ugh fixed filepath len
       int fileSize;
 
+      // Since v5, the file stays open during a READ or WRITE session, until the end of the file is reached,
+      // another command is received or the connection is closed. The session holds a wake lock.
+      lfs_file_t sessionFile;
+      uint32_t sessionPosition = 0;
+      uint32_t sessionFileSize = 0;
+      // Number of chunks sent per READ/READ_PACING request, or of WRITE_DATA chunks per acknowledgement
+      uint8_t window = 1;
+      uint8_t chunksSinceAck = 0;
+
+      // Traversing the file system to compute the free space is slow: it is computed once and then
+      // decremented by the data written during write sessions
+      uint32_t freeSpace = 0;
+      bool freeSpaceValid = false;
+
+      static constexpr uint8_t maxNotifyAttempts = 20;
+
+      ResourceInstaller installer;
+
       using ReadHeader = struct __attribute__((packed)) {
         commands command;
-        uint8_t padding;
+        uint8_t window; // v5, padding before: number of chunks to send per request (0 = 1)
         uint16_t pathlen;
         uint32_t chunkoff;
         uint32_t chunksize;
@@ -109,7 +135,7 @@ namespace Pinetime {
 
       using WriteHeader = struct __attribute__((packed)) {
         commands command;
-        uint8_t padding;
+        uint8_t window; // v5, padding before: number of WRITE_DATA chunks per acknowledgement (0 = 1)
         uint16_t pathlen;
         uint32_t offset;
         uint64_t modTime;
@@ -135,6 +161,15 @@ namespace Pinetime {
         uint8_t data[];
       };
 
+      // v5: installs a resource pack streamed with WRITE_DATA. INSTALL_PACING (WriteResponse) carries the offset of
+      // the next byte to send, which moves forward when an interrupted installation of the same pack is resumed.
+      using InstallHeader = struct __attribute__((packed)) {
+        commands command;
+        uint8_t window;
+        uint16_t padding;
+        uint32_t totalSize; // informative, the installer reads the size from the pack header
+      };
+
       using ListDirHeader = struct __attribute__((packed)) {
         commands command;
         uint8_t padding;
@@ -196,8 +231,22 @@ namespace Pinetime {
         uint8_t status;
       };
 
+      // Largest READ_DATA chunk that fits in a notification with the preferred ATT MTU
+      static constexpr size_t maxChunkSize = MYNEWT_VAL(BLE_ATT_PREFERRED_MTU) - 3 - sizeof(ReadResponse);
+      // Largest WRITE_DATA chunk that fits in a write with the preferred ATT MTU
+      static constexpr size_t maxWriteChunkSize = MYNEWT_VAL(BLE_ATT_PREFERRED_MTU) - 3 - sizeof(WritePacing);
+      // Holds the chunk of the read or write session, only one runs at a time
+      uint8_t chunkBuffer[std::max(maxChunkSize, maxWriteChunkSize)];
+
       int FSCommandHandler(uint16_t connectionHandle, os_mbuf* om);
       void prepareReadDataResp(ReadHeader* header, ReadResponse* resp);
+      int OpenSession(FSState newState, int flags);
+      int CloseSession();
+      void SendReadData(uint16_t connectionHandle, uint32_t offset, uint32_t chunkSize);
+      void WriteData(uint16_t connectionHandle, const WritePacing& header, const uint8_t* data, uint32_t dataSize);
+      void InstallData(uint16_t connectionHandle, const WritePacing& header, const uint8_t* data, uint32_t dataSize);
+      uint32_t FreeSpace();
+      void Notify(uint16_t connectionHandle, const void* header, size_t headerSize, const uint8_t* data, size_t dataSize);
     };
   }
 }
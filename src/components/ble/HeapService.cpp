@@ -0,0 +1,89 @@
+#include "components/ble/HeapService.h"
+#include <FreeRTOS.h>
+#include <heap_4_infinitime.h>
+#include <nrf_log.h>
+
+using namespace Pinetime::Controllers;
+
+namespace {
+  // 0006yyxx-78fc-48fe-8e23-433b3a1942d0
+  constexpr ble_uuid128_t CharUuid(uint8_t x, uint8_t y) {
+    return ble_uuid128_t {.u = {.type = BLE_UUID_TYPE_128},
+                          .value = {0xd0, 0x42, 0x19, 0x3a, 0x3b, 0x43, 0x23, 0x8e, 0xfe, 0x48, 0xfc, 0x78, x, y, 0x06, 0x00}};
+  }
+
+  // 00060000-78fc-48fe-8e23-433b3a1942d0
+  constexpr ble_uuid128_t BaseUuid() {
+    return CharUuid(0x00, 0x00);
+  }
+
+  constexpr ble_uuid128_t heapServiceUuid {BaseUuid()};
+  constexpr ble_uuid128_t heapStatisticsCharUuid {CharUuid(0x01, 0x00)};
+
+  struct __attribute__((packed)) HeapStatisticsPayload {
+    uint32_t heapSize;
+    uint32_t available;
+    uint32_t largestFreeBlock;
+    uint32_t freeBlocks;
+    uint32_t minimumEverFree;
+    uint32_t allocations;
+    uint32_t frees;
+    struct __attribute__((packed)) {
+      uint32_t blocks;
+      uint32_t bytes;
+    } owners[heapOWNER_COUNT];
+  };
+
+  int HeapServiceCallback(uint16_t /*conn_handle*/, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt, void* arg) {
+    auto* heapService = static_cast<HeapService*>(arg);
+    return heapService->OnHeapStatisticsRequested(attr_handle, ctxt);
+  }
+}
+
+HeapService::HeapService()
+  : characteristicDefinition {{.uuid = &heapStatisticsCharUuid.u,
+                               .access_cb = HeapServiceCallback,
+                               .arg = this,
+                               .flags = BLE_GATT_CHR_F_READ,
+                               .val_handle = &heapStatisticsHandle},
+                              {0}},
+    serviceDefinition {
+      {.type = BLE_GATT_SVC_TYPE_PRIMARY, .uuid = &heapServiceUuid.u, .characteristics = characteristicDefinition},
+      {0},
+    } {
+}
+
+void HeapService::Init() {
+  int res = 0;
+  res = ble_gatts_count_cfg(serviceDefinition);
+  ASSERT(res == 0);
+
+  res = ble_gatts_add_svcs(serviceDefinition);
+  ASSERT(res == 0);
+}
+
+int HeapService::OnHeapStatisticsRequested(uint16_t attributeHandle, ble_gatt_access_ctxt* context) {
+  if (attributeHandle != heapStatisticsHandle) {
+    return 0;
+  }
+
+  HeapStatistics_t statistics;
+  vPortGetHeapStatistics(&statistics);
+
+  HeapStatisticsPayload payload {.heapSize = xPortGetHeapSize(),
+                                 .available = statistics.xAvailableHeapSpaceInBytes,
+                                 .largestFreeBlock = statistics.xSizeOfLargestFreeBlockInBytes,
+                                 .freeBlocks = statistics.xNumberOfFreeBlocks,
+                                 .minimumEverFree = statistics.xMinimumEverFreeBytesRemaining,
+                                 .allocations = statistics.xNumberOfSuccessfulAllocations,
+                                 .frees = statistics.xNumberOfSuccessfulFrees,
+                                 .owners = {}};
+  for (uint8_t i = 0; i < heapOWNER_COUNT; i++) {
+    payload.owners[i].blocks = statistics.xOwnerBlocks[i];
+    payload.owners[i].bytes = statistics.xOwnerBytes[i];
+  }
+  NRF_LOG_INFO("Heap statistics : free = %d, largest = %d", payload.available, payload.largestFreeBlock);
+
+  int res = os_mbuf_append(context->om, &payload, sizeof(payload));
+  return (res == 0) ? 0 : BLE_ATT_ERR_INSUFFICIENT_RES;
+}
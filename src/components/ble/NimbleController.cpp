@@ -36,14 +36,14 @@ NimbleController::NimbleController(Pinetime::System::SystemTask& systemTask,
     dateTimeController {dateTimeController},
     spiNorFlash {spiNorFlash},
     fs {fs},
-    dfuService {systemTask, bleController, spiNorFlash},
+    dfuService {systemTask, bleController, spiNorFlash, fs},
 
     currentTimeClient {dateTimeController},
     anService {systemTask, notificationManager},
     alertNotificationClient {systemTask, notificationManager},
     currentTimeService {dateTimeController},
     musicService {*this},
-    weatherService {dateTimeController},
+    weatherService {systemTask, dateTimeController},
     batteryInformationService {batteryController},
     immediateAlertService {systemTask, notificationManager},
     heartRateService {*this, heartRateController},
@@ -98,6 +98,7 @@ void NimbleController::Init() {
   heartRateService.Init();
   motionService.Init();
   fsService.Init();
+  heapService.Init();
 
   int rc;
   rc = ble_hs_util_ensure_addr(0);
@@ -223,11 +224,13 @@ int NimbleController::OnGAPEvent(ble_gap_event* event) {
 
       currentTimeClient.Reset();
       alertNotificationClient.Reset();
+      fsService.Reset();
       connectionHandle = BLE_HS_CONN_HANDLE_NONE;
       if (bleController.IsConnected()) {
         bleController.Disconnect();
         fastAdvCount = 0;
         StartAdvertising();
+        systemTask.PushMessage(Pinetime::System::Messages::BleDisconnected);
       }
       break;
 
@@ -15,6 +15,7 @@
 #include "components/ble/DeviceInformationService.h"
 #include "components/ble/DfuService.h"
 #include "components/ble/FSService.h"
+#include "components/ble/HeapService.h"
 #include "components/ble/HeartRateService.h"
 #include "components/ble/ImmediateAlertService.h"
 #include "components/ble/MusicService.h"
@@ -81,6 +82,14 @@ namespace Pinetime {
       void EnableRadio();
       void DisableRadio();
 
+      void PreEraseDfuSlot() {
+        dfuService.PreEraseSlot();
+      }
+
+      void PersistDfuSlotState() {
+        dfuService.PersistSlotState();
+      }
+
     private:
       void PersistBond(struct ble_gap_conn_desc& desc);
       void RestoreBond();
@@ -106,6 +115,7 @@ namespace Pinetime {
       HeartRateService heartRateService;
       MotionService motionService;
       FSService fsService;
+      HeapService heapService;
       ServiceDiscovery serviceDiscovery;
 
       uint8_t addrType;
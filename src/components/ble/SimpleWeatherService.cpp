@@ -22,6 +22,7 @@
 #include <array>
 #include <cstring>
 #include <nrf_log.h>
+#include "systemtask/SystemTask.h"
 
 using namespace Pinetime::Controllers;
 
@@ -80,7 +81,8 @@ int WeatherCallback(uint16_t /*connHandle*/, uint16_t /*attrHandle*/, struct ble
   return static_cast<Pinetime::Controllers::SimpleWeatherService*>(arg)->OnCommand(ctxt);
 }
 
-SimpleWeatherService::SimpleWeatherService(DateTime& dateTimeController) : dateTimeController(dateTimeController) {
+SimpleWeatherService::SimpleWeatherService(System::SystemTask& systemTask, DateTime& dateTimeController)
+  : systemTask {systemTask}, dateTimeController {dateTimeController} {
 }
 
 void SimpleWeatherService::Init() {
@@ -103,6 +105,7 @@ int SimpleWeatherService::OnCommand(struct ble_gatt_access_ctxt* ctxt) {
                      currentWeather->maxTemperature.PreciseCelsius(),
                      currentWeather->iconId,
                      currentWeather->location.data());
+        systemTask.PushMessage(System::Messages::WeatherUpdated);
       }
       break;
     case MessageType::Forecast:
@@ -116,6 +119,7 @@ int SimpleWeatherService::OnCommand(struct ble_gatt_access_ctxt* ctxt) {
                        forecast->days[i]->maxTemperature.PreciseCelsius(),
                        forecast->days[i]->iconId);
         }
+        systemTask.PushMessage(System::Messages::WeatherUpdated);
       }
       break;
     default:
@@ -38,11 +38,15 @@
 int WeatherCallback(uint16_t connHandle, uint16_t attrHandle, struct ble_gatt_access_ctxt* ctxt, void* arg);
 
 namespace Pinetime {
+  namespace System {
+    class SystemTask;
+  }
+
   namespace Controllers {
 
     class SimpleWeatherService {
     public:
-      explicit SimpleWeatherService(DateTime& dateTimeController);
+      SimpleWeatherService(System::SystemTask& systemTask, DateTime& dateTimeController);
 
       void Init();
 
@@ -179,6 +183,7 @@ namespace Pinetime {
 
       uint16_t eventHandle {};
 
+      Pinetime::System::SystemTask& systemTask;
       Pinetime::Controllers::DateTime& dateTimeController;
 
       std::optional<CurrentWeather> currentWeather;
@@ -36,7 +36,7 @@ namespace Pinetime {
       static constexpr uint16_t timerPeriod = timerFrequency / pwmFreq;
       // Warning: nimble reserves some PPIs
       // https://github.com/InfiniTimeOrg/InfiniTime/blob/034d83fe6baf1ab3875a34f8cee387e24410a824/src/libs/mynewt-nimble/nimble/drivers/nrf52/src/ble_phy.c#L53
-      // SpiMaster uses PPI 0 for an erratum workaround
+      // SpiMaster uses PPI 3, 6, 7 and group 0 for list transfers
       // Channel 1, 2 should be free to use
       static constexpr nrf_ppi_channel_t ppiBacklightOn = NRF_PPI_CHANNEL1;
       static constexpr nrf_ppi_channel_t ppiBacklightOff = NRF_PPI_CHANNEL2;
@@ -78,6 +78,28 @@ std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> Dat
   return currentDateTime;
 }
 
+TickType_t DateTime::TicksUntilNextSecond() {
+  return TicksUntilNext(false);
+}
+
+TickType_t DateTime::TicksUntilNextMinute() {
+  return TicksUntilNext(true);
+}
+
+TickType_t DateTime::TicksUntilNext(bool minute) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  uint32_t systickCounter = nrf_rtc_counter_get(portNRF_RTC_REG);
+  UpdateTime(systickCounter, false);
+  // The current second started at previousSystickCounter, the counter wraps at portNRF_RTC_MAXTICKS
+  uint32_t ticksInSecond = (systickCounter - previousSystickCounter) & portNRF_RTC_MAXTICKS;
+  TickType_t ticks = configTICK_RATE_HZ - ticksInSecond;
+  if (minute) {
+    ticks += (59 - localTime.tm_sec) * configTICK_RATE_HZ;
+  }
+  xSemaphoreGive(mutex);
+  return ticks;
+}
+
 void DateTime::UpdateTime(uint32_t systickCounter, bool forceUpdate) {
   // Handle systick counter overflow
   uint32_t systickDelta = 0;
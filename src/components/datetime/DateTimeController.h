@@ -132,6 +132,10 @@ namespace Pinetime {
         return CurrentDateTime() - std::chrono::seconds((tzOffset + dstOffset) * 15 * 60);
       }
 
+      // Number of ticks until the seconds, or the minutes, of CurrentDateTime() change
+      TickType_t TicksUntilNextSecond();
+      TickType_t TicksUntilNextMinute();
+
       std::chrono::seconds Uptime() const {
         return uptime;
       }
@@ -142,6 +146,7 @@ namespace Pinetime {
 
     private:
       void UpdateTime(uint32_t systickCounter, bool forceUpdate);
+      TickType_t TicksUntilNext(bool minute);
 
       std::tm localTime;
       int8_t tzOffset = 0;
@@ -1,4 +1,5 @@
 #include "components/fs/FS.h"
+#include "components/fs/ResourceInstaller.h"
 #include <cstring>
 #include <littlefs/lfs.h>
 #include <lvgl/lvgl.h>
@@ -14,14 +15,14 @@ FS::FS(Pinetime::Drivers::SpiNorFlash& driver)
       .erase = SectorErase,
       .sync = SectorSync,
 
-      .read_size = 16,
-      .prog_size = 8,
+      .read_size = profile.readSize,
+      .prog_size = profile.progSize,
       .block_size = blockSize,
       .block_count = size / blockSize,
       .block_cycles = 1000u,
 
-      .cache_size = 16,
-      .lookahead_size = 16,
+      .cache_size = profile.cacheSize,
+      .lookahead_size = profile.lookaheadSize,
 
       .name_max = 50,
       .attr_max = 50,
@@ -49,8 +50,8 @@ void FS::Init() {
 }
 
 void FS::VerifyResource() {
-  // validate the resource metadata
-  resourcesValid = true;
+  // validate the resource metadata: the manifest is only complete once every file of the pack has been checked
+  resourcesValid = ResourceInstaller::IsPackInstalled(*this);
 }
 
 int FS::FileOpen(lfs_file_t* file_p, const char* fileName, const int flags) {
@@ -73,6 +74,10 @@ int FS::FileSeek(lfs_file_t* file_p, uint32_t pos) {
   return lfs_file_seek(&lfs, file_p, pos, LFS_SEEK_SET);
 }
 
+int FS::FileSize(lfs_file_t* file_p) {
+  return lfs_file_size(&lfs, file_p);
+}
+
 int FS::FileDelete(const char* fileName) {
   return lfs_remove(&lfs, fileName);
 }
@@ -17,6 +17,7 @@ namespace Pinetime {
       int FileRead(lfs_file_t* file_p, uint8_t* buff, uint32_t size);
       int FileWrite(lfs_file_t* file_p, const uint8_t* buff, uint32_t size);
       int FileSeek(lfs_file_t* file_p, uint32_t pos);
+      int FileSize(lfs_file_t* file_p);
 
       int FileDelete(const char* fileName);
 
@@ -31,6 +32,11 @@ namespace Pinetime {
       int Stat(const char* path, lfs_info* info);
       void VerifyResource();
 
+      // The resource pack is completely installed, and no resource has been modified since
+      bool ResourcesValid() const {
+        return resourcesValid;
+      }
+
       static size_t getSize() {
         return size;
       }
@@ -39,6 +45,11 @@ namespace Pinetime {
         return blockSize;
       }
 
+      // Smallest read issued to the flash
+      static constexpr size_t getReadSize() {
+        return profile.readSize;
+      }
+
     private:
       Pinetime::Drivers::SpiNorFlash& flashDriver;
 
@@ -68,6 +79,31 @@ namespace Pinetime {
       static constexpr size_t size = 0x34C000;
       static constexpr size_t blockSize = 4096;
 
+      /* littlefs tuning profiles.
+       * read/prog sizes are the minimal I/O sizes and are kept as is (the programming granularity must
+       * not change on existing file systems). The caches are allocated once for the file system and once
+       * for each opened file, and a cache of 256 bytes matches the page size of the flash.
+       * The lookahead buffer holds 1 bit per block: 112 bytes cover the whole partition (844 blocks),
+       * so the allocator doesn't need to rescan the metadata every 128 blocks.
+       */
+      struct Profile {
+        lfs_size_t readSize;
+        lfs_size_t progSize;
+        lfs_size_t cacheSize;
+        lfs_size_t lookaheadSize;
+      };
+
+      static constexpr Profile lowRamProfile {16, 8, 64, 32};
+      static constexpr Profile throughputProfile {16, 8, 256, 112};
+#if defined(PINETIME_IS_RECOVERY) || defined(PINETIME_FS_LOW_RAM)
+      static constexpr Profile profile = lowRamProfile;
+#else
+      static constexpr Profile profile = throughputProfile;
+#endif
+      static_assert(profile.cacheSize % profile.readSize == 0 && profile.cacheSize % profile.progSize == 0);
+      static_assert(blockSize % profile.cacheSize == 0);
+      static_assert(profile.lookaheadSize % 8 == 0);
+
       bool resourcesValid = false;
       const struct lfs_config lfsConfig;
 
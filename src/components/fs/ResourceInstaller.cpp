@@ -0,0 +1,271 @@
+#include "components/fs/ResourceInstaller.h"
+#include <algorithm>
+#include <cstring>
+#include <nrf_log.h>
+#include "components/fs/FS.h"
+
+using namespace Pinetime::Controllers;
+
+ResourceInstaller::ResourceInstaller(FS& fs) : fs {fs} {
+}
+
+void ResourceInstaller::Begin() {
+  Abort();
+  status = Status::InProgress;
+  state = States::PackHeader;
+  error = 0;
+  position = 0;
+  packSize = 0;
+  headerIndex = 0;
+}
+
+uint32_t ResourceInstaller::Write(uint32_t offset, const uint8_t* data, size_t size) {
+  if (status != Status::InProgress || offset != position) {
+    return position;
+  }
+
+  while (size > 0 && status == Status::InProgress) {
+    uint32_t previousPosition = position;
+    size_t consumed = Consume(data, size);
+    if (position != previousPosition + consumed) {
+      // Resuming: the rest of the packet is before the new position
+      break;
+    }
+    data += consumed;
+    size -= consumed;
+  }
+  return position;
+}
+
+void ResourceInstaller::Abort() {
+  if (fileOpen) {
+    fs.FileClose(&file);
+    fileOpen = false;
+  }
+  if (status == Status::InProgress) {
+    status = Status::Idle;
+  }
+}
+
+bool ResourceInstaller::IsPackInstalled(FS& fs) {
+  Manifest manifest;
+  return ReadManifest(fs, manifest) && manifest.installedCount == manifest.entryCount;
+}
+
+void ResourceInstaller::OnFileModified(const char* filePath) {
+  // The target directories of the resources (see src/resources/*.json)
+  static constexpr const char* resourceDirectories[] = {"/fonts/", "/images/"};
+  for (const char* directory : resourceDirectories) {
+    if (std::strncmp(filePath, directory, std::strlen(directory)) == 0) {
+      fs.FileDelete(manifestFile);
+      fs.VerifyResource();
+      return;
+    }
+  }
+}
+
+// Processes the beginning of data (up to the end of the current header, path or file), and returns the number of bytes consumed
+size_t ResourceInstaller::Consume(const uint8_t* data, size_t size) {
+  size_t consumed = 0;
+  switch (state) {
+    case States::PackHeader:
+      consumed = FillHeader(data, size, sizeof(PackHeader));
+      position += consumed;
+      if (headerIndex == sizeof(PackHeader)) {
+        headerIndex = 0;
+        OnPackHeader();
+      }
+      break;
+    case States::EntryHeader:
+      consumed = FillHeader(data, size, sizeof(EntryHeader));
+      position += consumed;
+      if (headerIndex == sizeof(EntryHeader)) {
+        headerIndex = 0;
+        std::memcpy(&entry, headerBuffer, sizeof(EntryHeader));
+        if (entry.pathLength == 0 || entry.pathLength >= sizeof(path)) {
+          Fail(LFS_ERR_NAMETOOLONG);
+        } else if (entry.type != EntryTypes::File && (entry.type != EntryTypes::Delete || entry.size != 0)) {
+          Fail(LFS_ERR_INVAL);
+        } else {
+          pathIndex = 0;
+          state = States::Path;
+        }
+      }
+      break;
+    case States::Path:
+      consumed = std::min(size, entry.pathLength - pathIndex);
+      std::memcpy(path + pathIndex, data, consumed);
+      pathIndex += consumed;
+      position += consumed;
+      if (pathIndex == entry.pathLength) {
+        path[pathIndex] = 0;
+        OnPath();
+      }
+      break;
+    case States::Data:
+      consumed = std::min<size_t>(size, fileRemaining);
+      position += consumed;
+      OnData(data, consumed);
+      break;
+  }
+  return consumed;
+}
+
+size_t ResourceInstaller::FillHeader(const uint8_t* data, size_t size, size_t headerSize) {
+  size_t count = std::min(size, headerSize - headerIndex);
+  std::memcpy(headerBuffer + headerIndex, data, count);
+  headerIndex += count;
+  return count;
+}
+
+void ResourceInstaller::OnPackHeader() {
+  PackHeader header;
+  std::memcpy(&header, headerBuffer, sizeof(PackHeader));
+  if (header.magic != packMagic || header.version != packVersion || header.packSize < sizeof(PackHeader)) {
+    Fail(LFS_ERR_CORRUPT);
+    return;
+  }
+  packSize = header.packSize;
+  state = States::EntryHeader;
+
+  Manifest saved;
+  if (ReadManifest(fs, saved) && saved.packId == header.packId && saved.entryCount == header.entryCount) {
+    manifest = saved;
+    NRF_LOG_INFO("[ResourceInstaller] Resuming at entry %d/%d", manifest.installedCount, manifest.entryCount);
+    if (manifest.installedCount == manifest.entryCount) {
+      position = packSize;
+      status = Status::Completed;
+    } else {
+      position = manifest.resumeOffset;
+    }
+    return;
+  }
+
+  manifest = {manifestMagic, header.packId, header.entryCount, 0, sizeof(PackHeader)};
+  int res = SaveManifest();
+  if (res < 0) {
+    Fail(res);
+  } else if (manifest.entryCount == 0) {
+    status = Status::Completed;
+  }
+}
+
+void ResourceInstaller::OnPath() {
+  if (entry.type == EntryTypes::Delete) {
+    int res = fs.FileDelete(path);
+    if (res < 0 && res != LFS_ERR_NOENT) {
+      Fail(res);
+      return;
+    }
+    CompleteEntry();
+    return;
+  }
+
+  CreateParentDirectories(path);
+  int res = fs.FileOpen(&file, path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+  if (res < 0) {
+    Fail(res);
+    return;
+  }
+  fileOpen = true;
+  fileRemaining = entry.size;
+  fileCrc = 0xFFFFFFFF;
+  state = States::Data;
+  if (fileRemaining == 0) {
+    OnData(nullptr, 0);
+  }
+}
+
+void ResourceInstaller::OnData(const uint8_t* data, size_t size) {
+  if (size > 0) {
+    int res = fs.FileWrite(&file, data, size);
+    if (res != static_cast<int>(size)) {
+      Fail((res < 0) ? res : LFS_ERR_NOSPC);
+      return;
+    }
+    fileCrc = lfs_crc(fileCrc, data, size);
+    fileRemaining -= size;
+  }
+  if (fileRemaining > 0) {
+    return;
+  }
+
+  fileOpen = false;
+  int res = fs.FileClose(&file);
+  if (res < 0) {
+    Fail(res);
+    return;
+  }
+  if ((fileCrc ^ 0xFFFFFFFF) != entry.crc) {
+    NRF_LOG_INFO("[ResourceInstaller] CRC error on entry %d", manifest.installedCount);
+    fs.FileDelete(path);
+    Fail(LFS_ERR_CORRUPT);
+    return;
+  }
+  CompleteEntry();
+}
+
+void ResourceInstaller::CompleteEntry() {
+  state = States::EntryHeader;
+  manifest.installedCount++;
+  manifest.resumeOffset = position;
+  bool last = manifest.installedCount == manifest.entryCount;
+  if (last && position != packSize) {
+    Fail(LFS_ERR_CORRUPT);
+    return;
+  }
+
+  int res = SaveManifest();
+  if (res < 0) {
+    Fail(res);
+    return;
+  }
+  if (last) {
+    status = Status::Completed;
+    fs.VerifyResource();
+  }
+}
+
+void ResourceInstaller::Fail(int newError) {
+  NRF_LOG_INFO("[ResourceInstaller] Installation failed at offset %d : %d", position, newError);
+  if (fileOpen) {
+    fs.FileClose(&file);
+    fileOpen = false;
+    fs.FileDelete(path);
+  }
+  error = newError;
+  status = Status::Failed;
+}
+
+void ResourceInstaller::CreateParentDirectories(const char* filePath) {
+  char directory[sizeof(path)];
+  for (size_t i = 1; filePath[i] != 0; i++) {
+    if (filePath[i] == '/') {
+      std::memcpy(directory, filePath, i);
+      directory[i] = 0;
+      fs.DirCreate(directory); // Fails with LFS_ERR_EXIST if the directory is already there
+    }
+  }
+}
+
+int ResourceInstaller::SaveManifest() {
+  CreateParentDirectories(manifestFile);
+  lfs_file_t manifestHandle;
+  int res = fs.FileOpen(&manifestHandle, manifestFile, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC);
+  if (res < 0) {
+    return res;
+  }
+  res = fs.FileWrite(&manifestHandle, reinterpret_cast<const uint8_t*>(&manifest), sizeof(Manifest));
+  int closeResult = fs.FileClose(&manifestHandle);
+  return (res < 0) ? res : closeResult;
+}
+
+bool ResourceInstaller::ReadManifest(FS& fs, Manifest& manifest) {
+  lfs_file_t manifestHandle;
+  if (fs.FileOpen(&manifestHandle, manifestFile, LFS_O_RDONLY) != LFS_ERR_OK) {
+    return false;
+  }
+  int res = fs.FileRead(&manifestHandle, reinterpret_cast<uint8_t*>(&manifest), sizeof(Manifest));
+  fs.FileClose(&manifestHandle);
+  return res == static_cast<int>(sizeof(Manifest)) && manifest.magic == manifestMagic;
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <littlefs/lfs.h>
+
+namespace Pinetime {
+  namespace Controllers {
+    class FS;
+
+    /* Installs a resource pack built by src/resources/generate-package.py (--pack).
+     * The pack is parsed while it is received: each file is written straight to its destination and checked against its CRC32.
+     * The manifest is updated after each entry, so an interrupted installation resumes at the first incomplete entry.
+     *
+     * Pack format (little endian): a PackHeader followed by entryCount entries, each made of an EntryHeader,
+     * the path (pathLength bytes, not null terminated) and the content of the file (size bytes).
+     */
+    class ResourceInstaller {
+    public:
+      enum class Status : uint8_t { Idle, InProgress, Completed, Failed };
+
+      explicit ResourceInstaller(FS& fs);
+
+      void Begin();
+      // Consumes data received at offset and returns the offset of the next byte to send. Data that is not at the
+      // expected offset is ignored, and the offset jumps forward when the installation of the same pack is resumed.
+      uint32_t Write(uint32_t offset, const uint8_t* data, size_t size);
+      // Closes the file being written, the installation can be resumed later
+      void Abort();
+
+      Status GetStatus() const {
+        return status;
+      }
+
+      int GetError() const {
+        return error;
+      }
+
+      uint32_t GetPackSize() const {
+        return packSize;
+      }
+
+      // Reads the manifest only, files are not checked again
+      static bool IsPackInstalled(FS& fs);
+      // Called when a file is modified outside of an installation: a resource no longer matches the pack, which must be
+      // installed again from the start
+      void OnFileModified(const char* filePath);
+
+    private:
+      static constexpr uint32_t packMagic = 0x50525449;     // "ITRP"
+      static constexpr uint32_t manifestMagic = 0x4D525449; // "ITRM"
+      static constexpr uint16_t packVersion = 1;
+      static constexpr const char* manifestFile = "/.system/resources.dat";
+
+      enum class EntryTypes : uint8_t { File = 0, Delete = 1 };
+      enum class States : uint8_t { PackHeader, EntryHeader, Path, Data };
+
+      struct __attribute__((packed)) PackHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t entryCount;
+        uint32_t packSize;
+        uint32_t packId; // CRC32 of everything after the header
+      };
+
+      struct __attribute__((packed)) EntryHeader {
+        EntryTypes type;
+        uint8_t pathLength;
+        uint16_t padding;
+        uint32_t size;
+        uint32_t crc;
+      };
+
+      struct __attribute__((packed)) Manifest {
+        uint32_t magic;
+        uint32_t packId;
+        uint16_t entryCount;
+        uint16_t installedCount;
+        uint32_t resumeOffset;
+      };
+
+      FS& fs;
+      Status status = Status::Idle;
+      States state = States::PackHeader;
+      int error = 0;
+      uint32_t position = 0;
+      uint32_t packSize = 0;
+
+      // Fixed size headers can be split across several packets
+      uint8_t headerBuffer[sizeof(PackHeader)];
+      size_t headerIndex = 0;
+      EntryHeader entry;
+      char path[64];
+      size_t pathIndex = 0;
+
+      Manifest manifest;
+      lfs_file_t file;
+      bool fileOpen = false;
+      uint32_t fileRemaining = 0;
+      uint32_t fileCrc = 0;
+
+      size_t Consume(const uint8_t* data, size_t size);
+      size_t FillHeader(const uint8_t* data, size_t size, size_t headerSize);
+      void OnPackHeader();
+      void OnPath();
+      void OnData(const uint8_t* data, size_t size);
+      void CompleteEntry();
+      void Fail(int newError);
+      void CreateParentDirectories(const char* filePath);
+      int SaveManifest();
+      static bool ReadManifest(FS& fs, Manifest& manifest);
+    };
+  }
+}
@@ -5,10 +5,15 @@
 using namespace Pinetime::Controllers;
 
 void HeartRateController::Update(HeartRateController::States newState, uint8_t heartRate) {
+  bool changed = newState != state;
   this->state = newState;
   if (this->heartRate != heartRate) {
     this->heartRate = heartRate;
     service->OnNewHeartRateValue(heartRate);
+    changed = true;
+  }
+  if (changed && systemTask != nullptr) {
+    systemTask->PushMessage(System::Messages::HeartRateUpdated);
   }
 }
 
@@ -33,3 +38,7 @@ void HeartRateController::SetHeartRateTask(Pinetime::Applications::HeartRateTask
 void HeartRateController::SetService(Pinetime::Controllers::HeartRateService* service) {
   this->service = service;
 }
+
+void HeartRateController::Register(Pinetime::System::SystemTask* systemTask) {
+  this->systemTask = systemTask;
+}
@@ -33,12 +33,14 @@ namespace Pinetime {
       }
 
       void SetService(Pinetime::Controllers::HeartRateService* service);
+      void Register(System::SystemTask* systemTask);
 
     private:
       Applications::HeartRateTask* task = nullptr;
       States state = States::Stopped;
       uint8_t heartRate = 0;
       Pinetime::Controllers::HeartRateService* service = nullptr;
+      System::SystemTask* systemTask = nullptr;
     };
   }
 }
\ No newline at end of file
@@ -1,36 +1,57 @@
 #include "components/rle/RleDecoder.h"
+#include <algorithm>
+#include <cstring>
 
 using namespace Pinetime::Tools;
 
+namespace {
+  // Writes count pixels in big endian order (as sent to the display), 2 pixels per 32 bits store
+  void Fill(uint8_t* output, size_t count, uint16_t color) {
+    const uint8_t pixels[4] = {static_cast<uint8_t>(color >> 8),
+                               static_cast<uint8_t>(color & 0xff),
+                               static_cast<uint8_t>(color >> 8),
+                               static_cast<uint8_t>(color & 0xff)};
+    if (count > 0 && (reinterpret_cast<uintptr_t>(output) & 0x03) == 0x02) {
+      std::memcpy(output, pixels, 2);
+      output += 2;
+      count--;
+    }
+    uint32_t pattern;
+    std::memcpy(&pattern, pixels, sizeof(pattern));
+    for (; count >= 2; count -= 2) {
+      std::memcpy(output, &pattern, sizeof(pattern));
+      output += sizeof(pattern);
+    }
+    if (count > 0) {
+      std::memcpy(output, pixels, 2);
+    }
+  }
+}
+
 RleDecoder::RleDecoder(const uint8_t* buffer, size_t size) : buffer {buffer}, size {size} {
 }
 
 RleDecoder::RleDecoder(const uint8_t* buffer, size_t size, uint16_t foregroundColor, uint16_t backgroundColor) : RleDecoder {buffer, size} {
   this->foregroundColor = foregroundColor;
   this->backgroundColor = backgroundColor;
+  color = backgroundColor;
 }
 
-void RleDecoder::DecodeNext(uint8_t* output, size_t maxBytes) {
-  for (; encodedBufferIndex < size; encodedBufferIndex++) {
-    uint8_t rl = buffer[encodedBufferIndex] - processedCount;
-    while (rl) {
-      output[bp] = color >> 8;
-      output[bp + 1] = color & 0xff;
-      bp += 2;
-      rl -= 1;
-      processedCount++;
+size_t RleDecoder::DecodeNext(uint8_t* output, size_t maxBytes) {
+  size_t written = 0;
+  size_t maxPixels = maxBytes / 2;
+  while (written < maxPixels && encodedBufferIndex < size) {
+    uint8_t runLength = buffer[encodedBufferIndex];
+    size_t count = std::min<size_t>(runLength - processedCount, maxPixels - written);
+    Fill(output + written * 2, count, color);
+    written += count;
+    processedCount += count;
 
-      if (bp >= maxBytes) {
-        bp = 0;
-        y += 1;
-        return;
-      }
+    if (processedCount == runLength) {
+      processedCount = 0;
+      encodedBufferIndex++;
+      color = (color == backgroundColor) ? foregroundColor : backgroundColor;
     }
-    processedCount = 0;
-
-    if (color == backgroundColor)
-      color = foregroundColor;
-    else
-      color = backgroundColor;
   }
+  return written * 2;
 }
@@ -7,6 +7,7 @@ namespace Pinetime {
   namespace Tools {
     /* 1-bit RLE decoder. Provide the encoded buffer to the constructor and then call DecodeNext() by
      * specifying the output (decoded) buffer and the maximum number of bytes this buffer can handle.
+     * Pixels are written in big endian order, ready to be sent to the display, and the buffer can hold several lines.
      *
      * Code from https://github.com/daniel-thompson/wasp-bootloader by Daniel Thompson released under the MIT license.
      */
@@ -15,19 +16,19 @@ namespace Pinetime {
       RleDecoder(const uint8_t* buffer, size_t size);
       RleDecoder(const uint8_t* buffer, size_t size, uint16_t foregroundColor, uint16_t backgroundColor);
 
-      void DecodeNext(uint8_t* output, size_t maxBytes);
+      // Fills output with whole runs and returns the number of bytes written (less than maxBytes at the end of the image)
+      size_t DecodeNext(uint8_t* output, size_t maxBytes);
 
     private:
       const uint8_t* buffer;
       size_t size;
 
       size_t encodedBufferIndex = 0;
-      int y = 0;
-      uint16_t bp = 0;
       uint16_t foregroundColor = 0xffff;
       uint16_t backgroundColor = 0;
       uint16_t color = backgroundColor;
-      int processedCount = 0;
+      // Pixels of the current run already written
+      size_t processedCount = 0;
     };
   }
 }
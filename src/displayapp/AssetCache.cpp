@@ -0,0 +1,178 @@
+#include "displayapp/AssetCache.h"
+#include <cstring>
+#include <FreeRTOS.h>
+#include <task.h>
+#include "components/fs/FS.h"
+#include "displayapp/StreamingFont.h"
+
+using namespace Pinetime::Components;
+
+namespace {
+  // Skips the drive letter of LVGL paths
+  const char* FilePath(const char* path) {
+    return (path[0] != 0 && path[1] == ':') ? path + 2 : path;
+  }
+}
+
+AssetCache::AssetCache(Pinetime::Controllers::FS& filesystem) : filesystem {filesystem} {
+}
+
+lv_font_t* AssetCache::GetFont(const char* path) {
+  return static_cast<lv_font_t*>(Get(path, Types::Font));
+}
+
+const lv_img_dsc_t* AssetCache::GetImage(const char* path) {
+  return static_cast<const lv_img_dsc_t*>(Get(path, Types::Image));
+}
+
+void AssetCache::Release(const void* asset) {
+  if (asset == nullptr) {
+    return;
+  }
+  for (auto& entry : entries) {
+    if (entry.asset == asset && entry.references > 0) {
+      entry.references--;
+      break;
+    }
+  }
+  Trim(budget);
+}
+
+size_t AssetCache::Flush() {
+  size_t cachedBytes = statistics.cachedBytes;
+  Trim(0);
+  return cachedBytes - statistics.cachedBytes;
+}
+
+void* AssetCache::Get(const char* path, Types type) {
+  for (auto& entry : entries) {
+    if (entry.asset != nullptr && entry.type == type && std::strcmp(entry.path, path) == 0) {
+      entry.references++;
+      entry.lastUse = ++useCounter;
+      statistics.hits++;
+      return entry.asset;
+    }
+  }
+
+  Entry* entry = FreeEntry();
+  if (entry == nullptr) {
+    return nullptr;
+  }
+
+  TickType_t start = xTaskGetTickCount();
+  size_t size = 0;
+  void* asset = Load(path, type, size);
+  statistics.loads++;
+  statistics.loadTimeMs += (xTaskGetTickCount() - start) * 1000 / configTICK_RATE_HZ;
+  if (asset == nullptr) {
+    return nullptr;
+  }
+
+  *entry = {path, asset, size, ++useCounter, 1, type};
+  statistics.cachedBytes += size;
+  Trim(budget);
+  return asset;
+}
+
+void* AssetCache::Load(const char* path, Types type, size_t& size) {
+  if (type == Types::Image) {
+    return LoadImage(path, size);
+  }
+
+  lfs_info info {};
+  if (filesystem.Stat(FilePath(path), &info) != LFS_ERR_OK || info.type != LFS_TYPE_REG) {
+    return nullptr;
+  }
+  if (info.size > streamingThreshold) {
+    lv_font_t* font = StreamingFont::Load(path);
+    size = StreamingFont::Size(font);
+    return font;
+  }
+  // lv_font_load() doesn't report what it allocates. It keeps every table of the file in RAM, the size of the file
+  // is close to it.
+  size = info.size;
+  return lv_font_load(path);
+}
+
+// Reads a LVGL binary image (header followed by the pixels) into a single allocation, with the descriptor first
+lv_img_dsc_t* AssetCache::LoadImage(const char* path, size_t& size) {
+  const char* filePath = FilePath(path);
+  lfs_info info {};
+  if (filesystem.Stat(filePath, &info) != LFS_ERR_OK || info.type != LFS_TYPE_REG || info.size < sizeof(lv_img_header_t)) {
+    return nullptr;
+  }
+
+  uint32_t dataSize = info.size - sizeof(lv_img_header_t);
+  auto* image = static_cast<lv_img_dsc_t*>(lv_mem_alloc(sizeof(lv_img_dsc_t) + dataSize));
+  if (image == nullptr) {
+    return nullptr;
+  }
+  uint8_t* data = reinterpret_cast<uint8_t*>(image + 1);
+
+  lfs_file_t file;
+  bool loaded = false;
+  if (filesystem.FileOpen(&file, filePath, LFS_O_RDONLY) == LFS_ERR_OK) {
+    loaded = filesystem.FileRead(&file, reinterpret_cast<uint8_t*>(&image->header), sizeof(lv_img_header_t)) ==
+               static_cast<int>(sizeof(lv_img_header_t)) &&
+             filesystem.FileRead(&file, data, dataSize) == static_cast<int>(dataSize);
+    filesystem.FileClose(&file);
+  }
+  if (!loaded) {
+    lv_mem_free(image);
+    return nullptr;
+  }
+
+  image->data_size = dataSize;
+  image->data = data;
+  size = sizeof(lv_img_dsc_t) + dataSize;
+  return image;
+}
+
+// Returns an empty entry, evicting the least recently used released asset if needed
+AssetCache::Entry* AssetCache::FreeEntry() {
+  Entry* oldest = nullptr;
+  for (auto& entry : entries) {
+    if (entry.asset == nullptr) {
+      return &entry;
+    }
+    if (entry.references == 0 && (oldest == nullptr || entry.lastUse < oldest->lastUse)) {
+      oldest = &entry;
+    }
+  }
+  if (oldest != nullptr) {
+    Evict(*oldest);
+  }
+  return oldest;
+}
+
+void AssetCache::Evict(Entry& entry) {
+  if (entry.type == Types::Font) {
+    auto* font = static_cast<lv_font_t*>(entry.asset);
+    if (StreamingFont::Owns(font)) {
+      StreamingFont::Free(font);
+    } else {
+      lv_font_free(font);
+    }
+  } else {
+    lv_img_cache_invalidate_src(entry.asset);
+    lv_mem_free(entry.asset);
+  }
+  statistics.cachedBytes -= entry.size;
+  entry = {};
+}
+
+// Evicts released assets, least recently used first, until the cache holds at most limit bytes
+void AssetCache::Trim(size_t limit) {
+  while (statistics.cachedBytes > limit) {
+    Entry* oldest = nullptr;
+    for (auto& entry : entries) {
+      if (entry.asset != nullptr && entry.references == 0 && (oldest == nullptr || entry.lastUse < oldest->lastUse)) {
+        oldest = &entry;
+      }
+    }
+    if (oldest == nullptr) {
+      return;
+    }
+    Evict(*oldest);
+  }
+}
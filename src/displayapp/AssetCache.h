@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <lvgl/lvgl.h>
+
+namespace Pinetime {
+  namespace Controllers {
+    class FS;
+  }
+
+  namespace Components {
+    /* Keeps the fonts and images loaded from the file system ("F:/..." paths) in RAM after they are released,
+     * so that returning to a screen doesn't read and parse them from the SPI flash again.
+     * Released assets are evicted in least recently used order when they exceed the byte budget.
+     * Images are loaded as in-memory descriptors, LVGL's image cache entries are invalidated on eviction.
+     * Large fonts (the big digits of the watch faces) are loaded with StreamingFont, which reads the glyph bitmaps on demand.
+     * Paths are not copied: they must be string literals.
+     */
+    class AssetCache {
+    public:
+      struct Statistics {
+        uint32_t hits = 0;
+        uint32_t loads = 0;
+        uint32_t loadTimeMs = 0;
+        size_t cachedBytes = 0;
+      };
+
+      explicit AssetCache(Pinetime::Controllers::FS& filesystem);
+
+      AssetCache(const AssetCache&) = delete;
+      AssetCache& operator=(const AssetCache&) = delete;
+      AssetCache(AssetCache&&) = delete;
+      AssetCache& operator=(AssetCache&&) = delete;
+
+      // Return nullptr if the asset cannot be loaded. Each successful call must be balanced by Release().
+      lv_font_t* GetFont(const char* path);
+      const lv_img_dsc_t* GetImage(const char* path);
+      void Release(const void* asset);
+      // Evicts every released asset, returns the number of bytes freed
+      size_t Flush();
+
+      Statistics GetStatistics() const {
+        return statistics;
+      }
+
+    private:
+      enum class Types : uint8_t { Font, Image };
+
+      struct Entry {
+        const char* path = nullptr;
+        void* asset = nullptr;
+        size_t size = 0;
+        uint32_t lastUse = 0;
+        uint8_t references = 0;
+        Types type = Types::Font;
+      };
+
+      static constexpr size_t budget = 10 * 1024;
+      static constexpr uint8_t maxEntries = 8;
+      // Size of the font files above which only their glyph index is loaded in RAM
+      static constexpr uint32_t streamingThreshold = 4 * 1024;
+
+      Pinetime::Controllers::FS& filesystem;
+      std::array<Entry, maxEntries> entries;
+      uint32_t useCounter = 0;
+      Statistics statistics;
+
+      void* Get(const char* path, Types type);
+      void* Load(const char* path, Types type, size_t& size);
+      lv_img_dsc_t* LoadImage(const char* path, size_t& size);
+      Entry* FreeEntry();
+      void Evict(Entry& entry);
+      void Trim(size_t limit);
+    };
+  }
+}
@@ -0,0 +1,237 @@
+#include "displayapp/CompressedImage.h"
+#include <cstring>
+
+using namespace Pinetime::Components;
+
+void CompressedImage::RegisterDecoder() {
+  lv_img_decoder_t* decoder = lv_img_decoder_create();
+  lv_img_decoder_set_info_cb(decoder, Info);
+  lv_img_decoder_set_open_cb(decoder, OpenDecoder);
+  lv_img_decoder_set_read_line_cb(decoder, ReadLine);
+  lv_img_decoder_set_close_cb(decoder, CloseDecoder);
+}
+
+bool CompressedImage::ReadHeaders(const void* source, lv_img_header_t& imageHeader, Header& header) {
+  lv_img_src_t sourceType = lv_img_src_get_type(source);
+  if (sourceType == LV_IMG_SRC_VARIABLE) {
+    const auto* image = static_cast<const lv_img_dsc_t*>(source);
+    if (image->header.cf != LV_IMG_CF_USER_ENCODED_0 || image->data_size < sizeof(Header)) {
+      return false;
+    }
+    imageHeader = image->header;
+    std::memcpy(&header, image->data, sizeof(Header));
+  } else if (sourceType == LV_IMG_SRC_FILE) {
+    lv_fs_file_t file;
+    if (lv_fs_open(&file, static_cast<const char*>(source), LV_FS_MODE_RD) != LV_FS_RES_OK) {
+      return false;
+    }
+    uint32_t headerRead = 0;
+    uint32_t read = 0;
+    bool valid = lv_fs_read(&file, &imageHeader, sizeof(lv_img_header_t), &headerRead) == LV_FS_RES_OK &&
+                 imageHeader.cf == LV_IMG_CF_USER_ENCODED_0 && lv_fs_read(&file, &header, sizeof(Header), &read) == LV_FS_RES_OK &&
+                 headerRead == sizeof(lv_img_header_t) && read == sizeof(Header);
+    lv_fs_close(&file);
+    if (!valid) {
+      return false;
+    }
+  } else {
+    return false;
+  }
+  return header.version == version && header.rowsPerBlock > 0 &&
+         (header.format == Formats::TrueColorAlpha || header.format == Formats::Indexed1Bit);
+}
+
+lv_res_t CompressedImage::Info(lv_img_decoder_t* /*decoder*/, const void* source, lv_img_header_t* header) {
+  lv_img_header_t imageHeader;
+  Header compressedHeader;
+  if (!ReadHeaders(source, imageHeader, compressedHeader)) {
+    return LV_RES_INV;
+  }
+  // Lines are decoded to this format, which is what LVGL draws
+  header->cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+  header->w = imageHeader.w;
+  header->h = imageHeader.h;
+  header->always_zero = 0;
+  return LV_RES_OK;
+}
+
+lv_res_t CompressedImage::OpenDecoder(lv_img_decoder_t* /*decoder*/, lv_img_decoder_dsc_t* dsc) {
+  auto* image = new CompressedImage;
+  if (!image->Open(dsc->src)) {
+    image->Close();
+    delete image;
+    return LV_RES_INV;
+  }
+  dsc->user_data = image;
+  dsc->img_data = nullptr;
+  return LV_RES_OK;
+}
+
+lv_res_t CompressedImage::ReadLine(lv_img_decoder_t* /*decoder*/,
+                                   lv_img_decoder_dsc_t* dsc,
+                                   lv_coord_t x,
+                                   lv_coord_t y,
+                                   lv_coord_t len,
+                                   uint8_t* buf) {
+  auto* image = static_cast<CompressedImage*>(dsc->user_data);
+  if (x < 0 || y < 0 || len < 0 || x + len > image->imageHeader.w || y >= image->imageHeader.h || !image->DecodeRow(y)) {
+    return LV_RES_INV;
+  }
+  image->ConvertRow(x, len, buf);
+  return LV_RES_OK;
+}
+
+void CompressedImage::CloseDecoder(lv_img_decoder_t* /*decoder*/, lv_img_decoder_dsc_t* dsc) {
+  auto* image = static_cast<CompressedImage*>(dsc->user_data);
+  if (image != nullptr) {
+    image->Close();
+    delete image;
+    dsc->user_data = nullptr;
+  }
+}
+
+bool CompressedImage::Open(const void* source) {
+  if (!ReadHeaders(source, imageHeader, header)) {
+    return false;
+  }
+  if (lv_img_src_get_type(source) == LV_IMG_SRC_FILE) {
+    if (lv_fs_open(&file, static_cast<const char*>(source), LV_FS_MODE_RD) != LV_FS_RES_OK) {
+      return false;
+    }
+    isFile = true;
+  } else {
+    data = static_cast<const lv_img_dsc_t*>(source)->data;
+    dataSize = static_cast<const lv_img_dsc_t*>(source)->data_size;
+  }
+
+  blockOffsetsStart = sizeof(Header);
+  if (header.format == Formats::Indexed1Bit) {
+    lv_color32_t colors[2];
+    if (!Seek(sizeof(Header)) || !Read(colors, sizeof(colors))) {
+      return false;
+    }
+    for (uint8_t i = 0; i < 2; i++) {
+      palette[i] = lv_color_make(colors[i].ch.red, colors[i].ch.green, colors[i].ch.blue);
+      paletteOpacity[i] = colors[i].ch.alpha;
+    }
+    blockOffsetsStart += sizeof(colors);
+  }
+
+  rowSize = (header.format == Formats::Indexed1Bit) ? (imageHeader.w + 7) / 8 * UnitSize() : imageHeader.w * UnitSize();
+  row = new uint8_t[rowSize];
+  return true;
+}
+
+void CompressedImage::Close() {
+  if (isFile) {
+    lv_fs_close(&file);
+    isFile = false;
+  }
+  delete[] row;
+  row = nullptr;
+}
+
+// Positions are relative to the end of the lv_img_header_t
+bool CompressedImage::Seek(uint32_t newPosition) {
+  if (isFile && lv_fs_seek(&file, sizeof(lv_img_header_t) + newPosition) != LV_FS_RES_OK) {
+    return false;
+  }
+  position = newPosition;
+  return true;
+}
+
+bool CompressedImage::Read(void* buffer, size_t size) {
+  if (isFile) {
+    uint32_t read = 0;
+    if (lv_fs_read(&file, buffer, size, &read) != LV_FS_RES_OK || read != size) {
+      return false;
+    }
+  } else {
+    if (position + size > dataSize) {
+      return false;
+    }
+    std::memcpy(buffer, data + position, size);
+  }
+  position += size;
+  return true;
+}
+
+bool CompressedImage::DecodeRow(int32_t y) {
+  if (y == currentRow) {
+    return true;
+  }
+
+  // Rows can only be decoded in order: moving backward or far ahead restarts from the beginning of the block
+  if (currentRow < 0 || y < currentRow || y - currentRow > header.rowsPerBlock) {
+    uint32_t block = y / header.rowsPerBlock;
+    uint32_t blockOffset = 0;
+    if (!Seek(blockOffsetsStart + block * sizeof(uint32_t)) || !Read(&blockOffset, sizeof(blockOffset))) {
+      currentRow = -1;
+      return false;
+    }
+    currentRow = static_cast<int32_t>(block * header.rowsPerBlock) - 1;
+    nextRowPosition = blockOffset;
+  }
+
+  while (currentRow < y) {
+    if (!DecodeNextRow()) {
+      currentRow = -1;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CompressedImage::DecodeNextRow() {
+  if (position != nextRowPosition && !Seek(nextRowPosition)) {
+    return false;
+  }
+
+  size_t unitSize = UnitSize();
+  size_t written = 0;
+  while (written < rowSize) {
+    uint8_t control;
+    if (!Read(&control, 1)) {
+      return false;
+    }
+    if (control < 0x80) {
+      size_t size = (control + 1) * unitSize;
+      if (written + size > rowSize || !Read(row + written, size)) {
+        return false;
+      }
+      written += size;
+    } else {
+      size_t count = control - 0x80 + 2;
+      if (written + count * unitSize > rowSize || !Read(row + written, unitSize)) {
+        return false;
+      }
+      for (size_t i = 1; i < count; i++) {
+        std::memcpy(row + written + i * unitSize, row + written, unitSize);
+      }
+      written += count * unitSize;
+    }
+  }
+
+  nextRowPosition = position;
+  currentRow++;
+  return true;
+}
+
+void CompressedImage::ConvertRow(lv_coord_t x, lv_coord_t length, uint8_t* buffer) const {
+  if (header.format == Formats::TrueColorAlpha) {
+    std::memcpy(buffer, row + x * pixelSize, length * pixelSize);
+    return;
+  }
+
+  for (lv_coord_t i = 0; i < length; i++) {
+    lv_coord_t pixel = x + i;
+    uint8_t index = (row[pixel / 8] >> (7 - pixel % 8)) & 0x01;
+    std::memcpy(buffer, &palette[index], sizeof(lv_color_t));
+    buffer[sizeof(lv_color_t)] = paletteOpacity[index];
+    buffer += pixelSize;
+  }
+}
+
+size_t CompressedImage::UnitSize() const {
+  return (header.format == Formats::Indexed1Bit) ? 1 : pixelSize;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <lvgl/lvgl.h>
+
+namespace Pinetime {
+  namespace Components {
+    /* LVGL image decoder for the compressed images generated by src/resources/lv_img_conv.py (--compress).
+     * Images are decoded line by line when they are drawn, from a file ("F:/...") or from a lv_img_dsc_t
+     * holding the compressed data, so only the compressed bytes are read from the SPI flash.
+     *
+     * Format (little endian), after the lv_img_header_t (cf = LV_IMG_CF_USER_ENCODED_0):
+     *  - Header
+     *  - the palette (2 lv_color32_t) for Formats::Indexed1Bit
+     *  - the offset of every block of rowsPerBlock rows, from the start of the Header
+     *  - the rows, each one encoded on its own. A row is a sequence of runs of units (3 bytes ARGB8565_RBSWAP pixels
+     *    or 1 byte of 8 pixels of the indexed format). A control byte c < 0x80 is followed by c + 1 literal units,
+     *    and c >= 0x80 is followed by a single unit repeated c - 0x80 + 2 times.
+     */
+    class CompressedImage {
+    public:
+      static void RegisterDecoder();
+
+    private:
+      enum class Formats : uint8_t { TrueColorAlpha = 0, Indexed1Bit = 1 };
+
+      struct __attribute__((packed)) Header {
+        uint8_t version;
+        Formats format;
+        uint8_t rowsPerBlock;
+        uint8_t reserved;
+      };
+
+      static constexpr uint8_t version = 1;
+      static constexpr uint8_t pixelSize = LV_IMG_PX_SIZE_ALPHA_BYTE;
+
+      lv_fs_file_t file;
+      bool isFile = false;
+      const uint8_t* data = nullptr;
+      uint32_t dataSize = 0;
+      uint32_t position = 0;
+
+      Header header;
+      lv_img_header_t imageHeader;
+      lv_color_t palette[2];
+      lv_opa_t paletteOpacity[2];
+      uint32_t blockOffsetsStart = 0;
+
+      // Last row decoded, and where the next one starts
+      int32_t currentRow = -1;
+      uint32_t nextRowPosition = 0;
+      uint8_t* row = nullptr;
+      size_t rowSize = 0;
+
+      bool Open(const void* source);
+      void Close();
+      bool Read(void* buffer, size_t size);
+      bool Seek(uint32_t newPosition);
+      bool DecodeRow(int32_t y);
+      bool DecodeNextRow();
+      void ConvertRow(lv_coord_t x, lv_coord_t length, uint8_t* buffer) const;
+      size_t UnitSize() const;
+
+      static bool ReadHeaders(const void* source, lv_img_header_t& imageHeader, Header& header);
+      static lv_res_t Info(lv_img_decoder_t* decoder, const void* source, lv_img_header_t* header);
+      static lv_res_t OpenDecoder(lv_img_decoder_t* decoder, lv_img_decoder_dsc_t* dsc);
+      static lv_res_t
+      ReadLine(lv_img_decoder_t* decoder, lv_img_decoder_dsc_t* dsc, lv_coord_t x, lv_coord_t y, lv_coord_t len, uint8_t* buf);
+      static void CloseDecoder(lv_img_decoder_t* decoder, lv_img_decoder_dsc_t* dsc);
+    };
+  }
+}
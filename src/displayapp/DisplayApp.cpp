@@ -1,5 +1,6 @@
 #include "displayapp/DisplayApp.h"
 #include <libraries/log/nrf_log.h>
+#include <heap_4_infinitime.h>
 #include "displayapp/screens/HeartRate.h"
 #include "displayapp/screens/Motion.h"
 #include "displayapp/screens/Timer.h"
@@ -107,6 +108,7 @@ DisplayApp::DisplayApp(Drivers::St7789& lcd,
     filesystem {filesystem},
     spiNorFlash {spiNorFlash},
     lvgl {lcd, filesystem},
+    assetCache {filesystem},
     timer(this, TimerCallback),
     controllers {batteryController,
                  bleController,
@@ -125,8 +127,10 @@ DisplayApp::DisplayApp(Drivers::St7789& lcd,
                  nullptr,
                  this,
                  lvgl,
+                 assetCache,
                  nullptr,
                  nullptr} {
+  lvgl.SetAssetCache(&assetCache);
 }
 
 void DisplayApp::Start(System::BootErrors error) {
@@ -142,6 +146,8 @@ void DisplayApp::Start(System::BootErrors error) {
 void DisplayApp::Process(void* instance) {
   auto* app = static_cast<DisplayApp*>(instance);
   NRF_LOG_INFO("displayapp task started!");
+  // LVGL allocations are tagged by LVGL itself, the rest of the allocations of this task belong to the screens
+  vPortHeapSetTaskOwner(heapOWNER_SCREENS);
   app->Init();
 
   if (app->bootError == System::BootErrors::TouchController) {
@@ -161,6 +167,7 @@ void DisplayApp::Init() {
   brightnessController.Init();
   ApplyBrightness();
   lvgl.Init();
+  lvgl.SetMeasurementMode(measureRendering);
 }
 
 TickType_t DisplayApp::CalculateSleepTime() {
@@ -201,7 +208,60 @@ TickType_t DisplayApp::CalculateSleepTime() {
   }
 }
 
+void DisplayApp::NotifyChange(Screens::Changes change) {
+  if (state != States::Idle && (currentScreen->Subscriptions() & static_cast<uint8_t>(change)) != 0) {
+    currentScreen->OnChange(change);
+  }
+}
+
+// Notifies the screen when the seconds or the minutes it subscribed to change, and schedules the next notification
+void DisplayApp::UpdateClock() {
+  uint8_t subscriptions = currentScreen->Subscriptions();
+  if ((subscriptions & Screens::ChangeMask(Screens::Changes::Second, Screens::Changes::Minute)) == 0) {
+    return;
+  }
+  auto change = ((subscriptions & static_cast<uint8_t>(Screens::Changes::Second)) != 0) ? Screens::Changes::Second
+                                                                                          : Screens::Changes::Minute;
+  // A screen that subscribes to the seconds after the minutes must not wait for the next minute
+  if (change == clockChange && static_cast<int32_t>(xTaskGetTickCount() - nextClockTick) < 0) {
+    return;
+  }
+  currentScreen->OnChange(change);
+  clockChange = change;
+  TickType_t ticks =
+    (change == Screens::Changes::Second) ? dateTimeController.TicksUntilNextSecond() : dateTimeController.TicksUntilNextMinute();
+  nextClockTick = xTaskGetTickCount() + ticks;
+}
+
+// LVGL has nothing to draw or animate, and no input to process
+bool DisplayApp::IsScreenIdle() {
+  return currentScreen->Subscriptions() != 0 && lv_disp_get_default()->inv_p == 0 && lv_anim_count_running() == 0 &&
+         !touchHandler.IsTouching() && lv_disp_get_inactive_time(nullptr) >= activityPeriod;
+}
+
+// Ticks until the next clock notification, or until the screen must be dimmed or turned off
+TickType_t DisplayApp::IdleTimeout() {
+  TickType_t timeout = portMAX_DELAY;
+  if ((currentScreen->Subscriptions() & Screens::ChangeMask(Screens::Changes::Second, Screens::Changes::Minute)) != 0) {
+    int32_t untilClockTick = static_cast<int32_t>(nextClockTick - xTaskGetTickCount());
+    timeout = (untilClockTick > 0) ? untilClockTick : 0;
+  }
+  if (!systemTask->IsSleepDisabled()) {
+    TickType_t inactiveTime = lv_disp_get_inactive_time(nullptr);
+    TickType_t dimTime = pdMS_TO_TICKS(settingsController.GetScreenTimeOut() - 2000);
+    TickType_t sleepTime = pdMS_TO_TICKS(settingsController.GetScreenTimeOut());
+    if (inactiveTime < dimTime) {
+      timeout = std::min(timeout, dimTime - inactiveTime);
+    } else if (inactiveTime < sleepTime) {
+      timeout = std::min(timeout, sleepTime - inactiveTime);
+    }
+  }
+  return timeout;
+}
+
 void DisplayApp::Refresh() {
+  wakeups++;
+
   auto LoadPreviousScreen = [this]() {
     FullRefreshDirections returnDirection;
     switch (appStackDirections.Pop()) {
@@ -246,6 +306,7 @@ void DisplayApp::Refresh() {
       // If not true, then wait that amount of time
       queueTimeout = CalculateSleepTime();
       if (queueTimeout == 0) {
+        UpdateClock();
         // Only advance the tick count when LVGL is done
         // Otherwise keep running the task handler while it still has things to draw
         // Note: under high graphics load, LVGL will always have more work to do
@@ -262,7 +323,12 @@ void DisplayApp::Refresh() {
       if (!currentScreen->IsRunning()) {
         LoadPreviousScreen();
       }
+      lvgl.BorrowBands();
+      UpdateClock();
       queueTimeout = lv_task_handler();
+      if (IsScreenIdle()) {
+        queueTimeout = IdleTimeout();
+      }
 
       if (!systemTask->IsSleepDisabled() && IsPastDimTime()) {
         if (!isDimmed) {
@@ -355,15 +421,34 @@ void DisplayApp::Refresh() {
         }
         if (state == States::AOD) {
           lcd.LowPowerOff();
+          // The frames of the always on display were sent with 12 bits per pixel
+          lv_obj_invalidate(lv_scr_act());
         } else {
           lcd.Wakeup();
         }
         lv_disp_trig_activity(nullptr);
         ApplyBrightness();
         state = States::Running;
+        // Changes aren't notified while sleeping
+        nextClockTick = xTaskGetTickCount();
         break;
       case Messages::UpdateBleConnection:
-        // Only used for recovery firmware
+        NotifyChange(Screens::Changes::Ble);
+        break;
+      case Messages::UpdateBattery:
+        NotifyChange(Screens::Changes::Battery);
+        break;
+      case Messages::UpdateNotifications:
+        NotifyChange(Screens::Changes::Notifications);
+        break;
+      case Messages::UpdateSteps:
+        NotifyChange(Screens::Changes::Steps);
+        break;
+      case Messages::UpdateHeartRate:
+        NotifyChange(Screens::Changes::HeartRate);
+        break;
+      case Messages::UpdateWeather:
+        NotifyChange(Screens::Changes::Weather);
         break;
       case Messages::NewNotification:
         LoadNewScreen(Apps::NotificationsPreview, DisplayApp::FullRefreshDirections::Down);
@@ -516,8 +601,27 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
   lv_disp_trig_activity(nullptr);
   motorController.StopRinging();
 
+  if (measureRendering) {
+    NRF_LOG_INFO("Screen %d: %d frames, %dms, %d flushes, %d bytes",
+                 static_cast<uint8_t>(currentApp),
+                 lvgl.GetScreenStatistics().frames,
+                 lvgl.GetScreenStatistics().renderTimeMs,
+                 lvgl.GetScreenStatistics().flushes,
+                 lvgl.GetScreenStatistics().bytes);
+    NRF_LOG_INFO("Screen %d: %d wakeups in %dms",
+                 static_cast<uint8_t>(currentApp),
+                 wakeups,
+                 (xTaskGetTickCount() - screenStartTime) * 1000 / configTICK_RATE_HZ);
+  }
+  lvgl.ResetScreenStatistics();
+  wakeups = 0;
+  screenStartTime = xTaskGetTickCount();
+  nextClockTick = screenStartTime;
+
   currentScreen.reset(nullptr);
   SetFullRefresh(direction);
+  // The new screen is drawn from scratch, with any direction
+  lvgl.RequestLargeBands();
 
   switch (app) {
     case Apps::Launcher: {
@@ -643,7 +747,9 @@ void DisplayApp::LoadScreen(Apps app, DisplayApp::FullRefreshDirections directio
                                                             watchdog,
                                                             motionController,
                                                             touchPanel,
-                                                            spiNorFlash);
+                                                            spiNorFlash,
+                                                            assetCache,
+                                                            filesystem);
       break;
     case Apps::FlashLight:
       currentScreen = std::make_unique<Screens::FlashLight>(*systemTask, brightnessController);
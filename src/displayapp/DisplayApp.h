@@ -6,6 +6,7 @@
 #include <systemtask/Messages.h>
 #include "displayapp/apps/Apps.h"
 #include "displayapp/LittleVgl.h"
+#include "displayapp/AssetCache.h"
 #include "displayapp/TouchEvents.h"
 #include "components/brightness/BrightnessController.h"
 #include "components/motor/MotorController.h"
@@ -104,6 +105,7 @@ namespace Pinetime {
 
       Pinetime::Controllers::FirmwareValidator validator;
       Pinetime::Components::LittleVgl lvgl;
+      Pinetime::Components::AssetCache assetCache;
       Pinetime::Controllers::Timer timer;
 
       AppControllers controllers;
@@ -112,6 +114,9 @@ namespace Pinetime {
       States state = States::Running;
       QueueHandle_t msgQueue;
 
+      // Logs the render time, flushes and display traffic of every frame, and their totals and the task wakeups for each screen
+      static constexpr bool measureRendering = false;
+
       static constexpr uint8_t queueSize = 10;
       static constexpr uint8_t itemSize = 1;
 
@@ -141,6 +146,20 @@ namespace Pinetime {
 
       bool isDimmed = false;
 
+      // Screens subscribed to Screens::Changes are notified by DisplayApp, which sleeps until the next change while they are idle
+      void NotifyChange(Screens::Changes change);
+      void UpdateClock();
+      bool IsScreenIdle();
+      TickType_t IdleTimeout();
+      TickType_t nextClockTick = 0;
+      Screens::Changes clockChange = Screens::Changes::Minute;
+      // Touch and button events are followed by LVGL events, animations and screen changes for a while
+      static constexpr TickType_t activityPeriod = pdMS_TO_TICKS(1000);
+
+      // Times the task woke up since the current screen was loaded
+      uint32_t wakeups = 0;
+      TickType_t screenStartTime = 0;
+
       TickType_t CalculateSleepTime();
       TickType_t alwaysOnFrameCount;
       TickType_t alwaysOnStartTime;
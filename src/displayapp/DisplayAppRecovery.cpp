@@ -91,9 +91,13 @@ void DisplayApp::Refresh() {
 
 void DisplayApp::DisplayLogo(uint16_t color) {
   Pinetime::Tools::RleDecoder rleDecoder(infinitime_nb, sizeof(infinitime_nb), color, colorBlack);
-  for (int i = 0; i < displayWidth; i++) {
-    rleDecoder.DecodeNext(displayBuffer, displayWidth * bytesPerPixel);
-    lcd.DrawBuffer(0, i, displayWidth, 1, reinterpret_cast<const uint8_t*>(displayBuffer), displayWidth * bytesPerPixel);
+  static constexpr size_t bytesPerDraw = displayWidth * bytesPerPixel * logoLinesPerDraw;
+  // The halves of the buffer are used alternately: DrawBuffer() returns before the transfer is done, but it waits
+  // for the end of the previous one, so a half is free again once the other one is being sent.
+  for (int i = 0; i < displayWidth; i += logoLinesPerDraw) {
+    uint8_t* lines = displayBuffer + ((i / logoLinesPerDraw) % 2) * bytesPerDraw;
+    rleDecoder.DecodeNext(lines, bytesPerDraw);
+    lcd.DrawBuffer(0, i, displayWidth, logoLinesPerDraw, lines, bytesPerDraw, nullptr);
   }
 }
 
@@ -102,7 +106,13 @@ void DisplayApp::DisplayOtaProgress(uint8_t percent, uint16_t color) {
   std::fill(displayBuffer, displayBuffer + (displayWidth * bytesPerPixel), color);
   for (int i = 0; i < barHeight; i++) {
     uint16_t barWidth = std::min(static_cast<float>(percent) * 2.4f, static_cast<float>(displayWidth));
-    lcd.DrawBuffer(0, displayWidth - barHeight + i, barWidth, 1, reinterpret_cast<const uint8_t*>(displayBuffer), barWidth * bytesPerPixel);
+    lcd.DrawBuffer(0,
+                   displayWidth - barHeight + i,
+                   barWidth,
+                   1,
+                   reinterpret_cast<const uint8_t*>(displayBuffer),
+                   barWidth * bytesPerPixel,
+                   nullptr);
   }
 }
 
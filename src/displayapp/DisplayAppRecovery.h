@@ -92,6 +92,9 @@ namespace Pinetime {
       static constexpr uint8_t displayWidth = 240;
       static constexpr uint8_t displayHeight = 240;
       static constexpr uint8_t bytesPerPixel = 2;
+      // The logo is decoded and sent a few lines at a time
+      static constexpr uint8_t logoLinesPerDraw = 2;
+      static_assert(displayHeight % logoLinesPerDraw == 0);
 
       static constexpr uint16_t colorWhite = 0xFFFF;
       static constexpr uint16_t colorGreen = 0x07E0;
@@ -100,7 +103,7 @@ namespace Pinetime {
       static constexpr uint16_t colorRed = 0xff00;
       static constexpr uint16_t colorRedSwapped = 0x00ff;
       static constexpr uint16_t colorBlack = 0x0000;
-      uint8_t displayBuffer[displayWidth * bytesPerPixel];
+      uint8_t displayBuffer[displayWidth * bytesPerPixel * logoLinesPerDraw * 2];
     };
   }
 }
@@ -1,8 +1,16 @@
 #include "displayapp/LittleVgl.h"
 #include "displayapp/InfiniTimeTheme.h"
+#include "displayapp/CompressedImage.h"
+#include "displayapp/AssetCache.h"
+#include "displayapp/Rgb444.h"
 
+#include <algorithm>
+#include <cstring>
+#include <iterator>
 #include <FreeRTOS.h>
 #include <task.h>
+#include <heap_4_infinitime.h>
+#include <libraries/log/nrf_log.h>
 #include "drivers/St7789.h"
 #include "littlefs/lfs.h"
 #include "components/fs/FS.h"
@@ -15,40 +23,131 @@ namespace {
     lv_theme_set_act(theme);
   }
 
+  /* Open file of the LVGL driver. LVGL's font and image loaders issue many small reads (a few bytes at a time),
+   * they are served from a buffer aligned on its size, which is refilled with a single read from littlefs.
+   * Reads larger than the buffer go straight to the destination.
+   */
+  struct LvglFile {
+    static constexpr uint32_t bufferSize = 64;
+
+    lfs_file_t file;
+    uint32_t size;
+    uint32_t position;
+    // Position of the littlefs file, which is only moved when reading
+    uint32_t lfsPosition;
+    uint32_t bufferStart;
+    uint32_t bufferCount;
+    uint8_t buffer[bufferSize];
+  };
+
+  static_assert(LvglFile::bufferSize % Pinetime::Controllers::FS::getReadSize() == 0);
+
   lv_fs_res_t lvglOpen(lv_fs_drv_t* drv, void* file_p, const char* path, lv_fs_mode_t /*mode*/) {
-    lfs_file_t* file = static_cast<lfs_file_t*>(file_p);
+    LvglFile* file = static_cast<LvglFile*>(file_p);
     Pinetime::Controllers::FS* filesys = static_cast<Pinetime::Controllers::FS*>(drv->user_data);
-    int res = filesys->FileOpen(file, path, LFS_O_RDONLY);
-    if (res == 0) {
-      if (file->type == 0) {
-        return LV_FS_RES_FS_ERR;
-      } else {
-        return LV_FS_RES_OK;
-      }
+    int res = filesys->FileOpen(&file->file, path, LFS_O_RDONLY);
+    if (res != 0) {
+      return LV_FS_RES_NOT_EX;
+    }
+    int size = filesys->FileSize(&file->file);
+    if (file->file.type == 0 || size < 0) {
+      filesys->FileClose(&file->file);
+      return LV_FS_RES_FS_ERR;
     }
-    return LV_FS_RES_NOT_EX;
+    file->size = static_cast<uint32_t>(size);
+    file->position = 0;
+    file->lfsPosition = 0;
+    file->bufferStart = 0;
+    file->bufferCount = 0;
+    return LV_FS_RES_OK;
   }
 
   lv_fs_res_t lvglClose(lv_fs_drv_t* drv, void* file_p) {
     Pinetime::Controllers::FS* filesys = static_cast<Pinetime::Controllers::FS*>(drv->user_data);
-    lfs_file_t* file = static_cast<lfs_file_t*>(file_p);
-    filesys->FileClose(file);
+    LvglFile* file = static_cast<LvglFile*>(file_p);
+    filesys->FileClose(&file->file);
 
     return LV_FS_RES_OK;
   }
 
+  // Reads from the current position of the littlefs file, moving it to position first if needed
+  int ReadAt(Pinetime::Controllers::FS* filesys, LvglFile* file, uint32_t position, uint8_t* buffer, uint32_t size) {
+    if (file->lfsPosition != position) {
+      int res = filesys->FileSeek(&file->file, position);
+      if (res < 0) {
+        return res;
+      }
+      file->lfsPosition = position;
+    }
+    int res = filesys->FileRead(&file->file, buffer, size);
+    if (res > 0) {
+      file->lfsPosition += res;
+    }
+    return res;
+  }
+
   lv_fs_res_t lvglRead(lv_fs_drv_t* drv, void* file_p, void* buf, uint32_t btr, uint32_t* br) {
     Pinetime::Controllers::FS* filesys = static_cast<Pinetime::Controllers::FS*>(drv->user_data);
-    lfs_file_t* file = static_cast<lfs_file_t*>(file_p);
-    filesys->FileRead(file, static_cast<uint8_t*>(buf), btr);
-    *br = btr;
+    LvglFile* file = static_cast<LvglFile*>(file_p);
+    uint8_t* destination = static_cast<uint8_t*>(buf);
+    uint32_t count = 0;
+
+    while (count < btr && file->position < file->size) {
+      uint32_t remaining = btr - count;
+      if (file->position >= file->bufferStart && file->position < file->bufferStart + file->bufferCount) {
+        uint32_t offset = file->position - file->bufferStart;
+        uint32_t chunk = std::min(remaining, file->bufferCount - offset);
+        std::memcpy(destination + count, file->buffer + offset, chunk);
+        count += chunk;
+        file->position += chunk;
+        continue;
+      }
+
+      if (remaining >= LvglFile::bufferSize) {
+        int res = ReadAt(filesys, file, file->position, destination + count, remaining);
+        if (res < 0) {
+          *br = count;
+          return LV_FS_RES_FS_ERR;
+        }
+        count += res;
+        file->position += res;
+        break;
+      }
+
+      uint32_t bufferStart = file->position - (file->position % LvglFile::bufferSize);
+      int res = ReadAt(filesys, file, bufferStart, file->buffer, LvglFile::bufferSize);
+      if (res < 0) {
+        file->bufferCount = 0;
+        *br = count;
+        return LV_FS_RES_FS_ERR;
+      }
+      file->bufferStart = bufferStart;
+      file->bufferCount = res;
+      if (file->position >= bufferStart + file->bufferCount) {
+        break;
+      }
+    }
+
+    *br = count;
     return LV_FS_RES_OK;
   }
 
-  lv_fs_res_t lvglSeek(lv_fs_drv_t* drv, void* file_p, uint32_t pos) {
-    Pinetime::Controllers::FS* filesys = static_cast<Pinetime::Controllers::FS*>(drv->user_data);
-    lfs_file_t* file = static_cast<lfs_file_t*>(file_p);
-    filesys->FileSeek(file, pos);
+  lv_fs_res_t lvglSeek(lv_fs_drv_t* /*drv*/, void* file_p, uint32_t pos) {
+    LvglFile* file = static_cast<LvglFile*>(file_p);
+    if (pos > file->size) {
+      return LV_FS_RES_INV_PARAM;
+    }
+    file->position = pos;
+    return LV_FS_RES_OK;
+  }
+
+  lv_fs_res_t lvglTell(lv_fs_drv_t* /*drv*/, void* file_p, uint32_t* pos_p) {
+    *pos_p = static_cast<LvglFile*>(file_p)->position;
+    return LV_FS_RES_OK;
+  }
+
+  lv_fs_res_t lvglSize(lv_fs_drv_t* /*drv*/, void* file_p, uint32_t* size_p) {
+    *size_p = static_cast<LvglFile*>(file_p)->size;
     return LV_FS_RES_OK;
   }
 }
@@ -58,14 +157,29 @@ static void disp_flush(lv_disp_drv_t* disp_drv, const lv_area_t* area, lv_color_
   lvgl->FlushDisplay(area, color_p);
 }
 
+static void wait_flush(lv_disp_drv_t* disp_drv) {
+  auto* lvgl = static_cast<LittleVgl*>(disp_drv->user_data);
+  lvgl->WaitFlush();
+}
+
+static void monitor(lv_disp_drv_t* disp_drv, uint32_t time, uint32_t /*px*/) {
+  auto* lvgl = static_cast<LittleVgl*>(disp_drv->user_data);
+  lvgl->OnFrameRendered(time);
+}
+
 static void rounder(lv_disp_drv_t* disp_drv, lv_area_t* area) {
   auto* lvgl = static_cast<LittleVgl*>(disp_drv->user_data);
+  // The areas of a capture are neither rounded nor coalesced, they are rendered away from the display
+  if (lvgl->IsCapturing()) {
+    return;
+  }
   if (lvgl->GetFullRefresh()) {
     area->x1 = 0;
     area->x2 = LV_HOR_RES - 1;
     area->y1 = 0;
     area->y2 = LV_VER_RES - 1;
   }
+  lvgl->CoalesceArea(area);
 }
 
 bool touchpad_read(lv_indev_drv_t* indev_drv, lv_indev_data_t* data) {
@@ -85,8 +199,11 @@ void LittleVgl::Init() {
 }
 
 void LittleVgl::InitDisplay() {
-  lv_disp_buf_init(&disp_buf_2, buf2_1, buf2_2, LV_HOR_RES_MAX * 4); /*Initialize the display buffer*/
-  lv_disp_drv_init(&disp_drv);                                       /*Basic initialization*/
+  flushCompleted = xSemaphoreCreateBinary();
+  ASSERT(flushCompleted != nullptr);
+
+  lv_disp_buf_init(&disp_buf_2, buf2_1, buf2_2, LV_HOR_RES_MAX * nbWriteLines); /*Initialize the display buffer*/
+  lv_disp_drv_init(&disp_drv);                                                  /*Basic initialization*/
 
   /*Set up the functions to access to your display*/
 
@@ -100,6 +217,8 @@ void LittleVgl::InitDisplay() {
   disp_drv.buffer = &disp_buf_2;
   disp_drv.user_data = this;
   disp_drv.rounder_cb = rounder;
+  disp_drv.wait_cb = wait_flush;
+  disp_drv.monitor_cb = monitor;
 
   /*Finally register the driver*/
   lv_disp_drv_register(&disp_drv);
@@ -119,43 +238,237 @@ void LittleVgl::InitFileSystem() {
   lv_fs_drv_t fs_drv;
   lv_fs_drv_init(&fs_drv);
 
-  fs_drv.file_size = sizeof(lfs_file_t);
+  fs_drv.file_size = sizeof(LvglFile);
   fs_drv.letter = 'F';
   fs_drv.open_cb = lvglOpen;
   fs_drv.close_cb = lvglClose;
   fs_drv.read_cb = lvglRead;
   fs_drv.seek_cb = lvglSeek;
+  fs_drv.tell_cb = lvglTell;
+  fs_drv.size_cb = lvglSize;
 
   fs_drv.user_data = &filesystem;
 
   lv_fs_drv_register(&fs_drv);
+
+  CompressedImage::RegisterDecoder();
 }
 
 void LittleVgl::SetFullRefresh(FullRefreshDirections direction) {
   if (scrollDirection == FullRefreshDirections::None) {
     scrollDirection = direction;
-    if (scrollDirection == FullRefreshDirections::Down) {
-      lv_disp_set_direction(lv_disp_get_default(), 1);
-    } else if (scrollDirection == FullRefreshDirections::Right) {
-      lv_disp_set_direction(lv_disp_get_default(), 2);
-    } else if (scrollDirection == FullRefreshDirections::Left) {
-      lv_disp_set_direction(lv_disp_get_default(), 3);
-    } else if (scrollDirection == FullRefreshDirections::RightAnim) {
-      lv_disp_set_direction(lv_disp_get_default(), 5);
-    } else if (scrollDirection == FullRefreshDirections::LeftAnim) {
-      lv_disp_set_direction(lv_disp_get_default(), 4);
-    }
+    lv_disp_set_direction(lv_disp_get_default(), RenderDirection(scrollDirection));
   }
   fullRefresh = true;
+  RequestLargeBands();
+}
+
+// Order in which LVGL renders the bands of a full refresh, so that the scrolling of the display reveals them in sequence
+uint8_t LittleVgl::RenderDirection(FullRefreshDirections direction) {
+  switch (direction) {
+    case FullRefreshDirections::Down:
+      return 1;
+    case FullRefreshDirections::Right:
+      return 2;
+    case FullRefreshDirections::Left:
+      return 3;
+    case FullRefreshDirections::LeftAnim:
+      return 4;
+    case FullRefreshDirections::RightAnim:
+      return 5;
+    default:
+      return 0;
+  }
+}
+
+// Renders screen to the callback instead of the display. LVGL only renders the active screen, so screen takes its place
+// meanwhile. The areas already invalidated on the active screen are set aside, and are drawn by its next frame.
+void LittleVgl::CaptureScreen(lv_obj_t* screen, CaptureCallback callback, void* context) {
+  lv_disp_t* disp = lv_disp_get_default();
+  // The last band of the previous frame may still be in flight, the capture renders into the same buffers
+  while (disp_drv.buffer->flushing != 0) {
+    WaitFlush();
+  }
+
+  lv_area_t invalidAreas[LV_INV_BUF_SIZE];
+  uint8_t invalidAreasJoined[LV_INV_BUF_SIZE];
+  const uint16_t nbInvalidAreas = disp->inv_p;
+  std::copy_n(disp->inv_areas, nbInvalidAreas, invalidAreas);
+  std::copy_n(disp->inv_area_joined, nbInvalidAreas, invalidAreasJoined);
+  lv_area_t activePendingAreas[maxPendingAreas];
+  const uint8_t nbActivePendingAreas = nbPendingAreas;
+  std::copy_n(pendingAreas, nbPendingAreas, activePendingAreas);
+  disp->inv_p = 0;
+  nbPendingAreas = 0;
+
+  // The top and system layers are drawn over every screen, they are not part of the captured one.
+  // Setting the flags directly doesn't invalidate the layers, unlike lv_obj_set_hidden().
+  lv_obj_t* layers[] = {disp->top_layer, disp->sys_layer};
+  bool layersHidden[std::size(layers)];
+  for (size_t i = 0; i < std::size(layers); i++) {
+    layersHidden[i] = layers[i]->hidden;
+    layers[i]->hidden = 1;
+  }
+
+  lv_obj_t* activeScreen = disp->act_scr;
+  capture = callback;
+  captureContext = context;
+  // From the top to the bottom, even during a transition
+  lv_disp_set_direction(disp, 0);
+  disp->act_scr = screen;
+  lv_obj_invalidate(screen);
+  lv_refr_now(disp);
+
+  disp->act_scr = activeScreen;
+  for (size_t i = 0; i < std::size(layers); i++) {
+    layers[i]->hidden = layersHidden[i];
+  }
+  lv_disp_set_direction(disp, RenderDirection(scrollDirection));
+  capture = nullptr;
+  captureContext = nullptr;
+
+  std::copy_n(invalidAreas, nbInvalidAreas, disp->inv_areas);
+  std::copy_n(invalidAreasJoined, nbInvalidAreas, disp->inv_area_joined);
+  disp->inv_p = nbInvalidAreas;
+  std::copy_n(activePendingAreas, nbActivePendingAreas, pendingAreas);
+  nbPendingAreas = nbActivePendingAreas;
+}
+
+// Replaces the draw buffers of LVGL with larger bands for the next frames, if the heap can spare them.
+// The bands are returned to the heap once a frame is rendered and no transition is in progress.
+void LittleVgl::BorrowBands() {
+  if (!largeBandsRequested || borrowedBands != nullptr) {
+    return;
+  }
+  largeBandsRequested = false;
+  size_t largestFreeBlock = ReclaimHeap(2 * LV_HOR_RES_MAX * maxBandLines * sizeof(lv_color_t) + bandHeapReserve);
+  for (uint8_t lines = maxBandLines; lines > nbWriteLines; lines /= 2) {
+    size_t size = 2 * LV_HOR_RES_MAX * lines * sizeof(lv_color_t);
+    if (largestFreeBlock < size + bandHeapReserve) {
+      continue;
+    }
+    borrowedBands = static_cast<lv_color_t*>(pvPortMallocLvgl(size));
+    if (borrowedBands != nullptr) {
+      SetBands(borrowedBands, borrowedBands + LV_HOR_RES_MAX * lines, lines);
+    }
+    return;
+  }
+}
+
+size_t LittleVgl::ReclaimHeap(size_t size) {
+  HeapStatistics_t heap;
+  vPortGetHeapStatistics(&heap);
+  if (heap.xSizeOfLargestFreeBlockInBytes < size && assetCache != nullptr && assetCache->Flush() > 0) {
+    vPortGetHeapStatistics(&heap);
+  }
+  return heap.xSizeOfLargestFreeBlockInBytes;
+}
+
+void LittleVgl::ReleaseBands() {
+  SetBands(buf2_1, buf2_2, nbWriteLines);
+  vPortFree(borrowedBands);
+  borrowedBands = nullptr;
+}
+
+// Must be called between frames
+void LittleVgl::SetBands(lv_color_t* band1, lv_color_t* band2, uint8_t lines) {
+  // The last band of the previous frame may still be in flight
+  while (disp_buf_2.flushing != 0) {
+    WaitFlush();
+  }
+  lv_disp_buf_init(&disp_buf_2, band1, band2, LV_HOR_RES_MAX * lines);
+  bandLines = lines;
+}
+
+void LittleVgl::OnFrameRendered(uint32_t renderTimeMs) {
+  if (capture != nullptr) {
+    return;
+  }
+  frameStatistics.renderTimeMs = renderTimeMs;
+  screenStatistics.frames++;
+  screenStatistics.renderTimeMs += renderTimeMs;
+  screenStatistics.flushes += frameStatistics.flushes;
+  screenStatistics.bytes += frameStatistics.bytes;
+  if (measurementMode) {
+    NRF_LOG_INFO("Frame: %dms, %d flushes, %d bytes, %d lines bands",
+                 renderTimeMs,
+                 frameStatistics.flushes,
+                 frameStatistics.bytes,
+                 frameStatistics.bandLines);
+  }
+
+  if (borrowedBands != nullptr && scrollDirection == FullRefreshDirections::None && !fullRefresh) {
+    ReleaseBands();
+  }
 }
 
 bool LittleVgl::IsScrolling() {
   return scrollDirection != LittleVgl::FullRefreshDirections::None;
 }
 
+// Called for every invalidated area (through the rounder). Merges it with the areas already invalidated in this frame
+// when redrawing the pixels in between is cheaper than setting up another window. LVGL then joins the areas
+// that end up inside the merged one.
+void LittleVgl::CoalesceArea(lv_area_t* area) {
+  // The first area invalidated since LVGL emptied its list starts a new frame. The list is emptied when a frame is
+  // rendered, but also when nothing was flushed or the areas were dropped: the areas of that frame are not pending anymore.
+  if (lv_disp_get_default()->inv_p == 0) {
+    nbPendingAreas = 0;
+  }
+
+  // LVGL also calls the rounder with a 1 pixel wide area at the origin to compute the number of lines of the draw buffer
+  if (area->x1 == 0 && area->x2 == 0 && area->y1 == 0) {
+    return;
+  }
+
+  uint8_t i = 0;
+  while (i < nbPendingAreas) {
+    lv_area_t merged;
+    _lv_area_join(&merged, area, &pendingAreas[i]);
+    if (lv_area_get_size(&merged) <= lv_area_get_size(area) + lv_area_get_size(&pendingAreas[i]) + windowSetupCost) {
+      *area = merged;
+      pendingAreas[i] = pendingAreas[nbPendingAreas - 1];
+      nbPendingAreas--;
+      // The merged area may now be close enough to areas that were checked already
+      i = 0;
+    } else {
+      i++;
+    }
+  }
+
+  if (nbPendingAreas < maxPendingAreas) {
+    pendingAreas[nbPendingAreas] = *area;
+    nbPendingAreas++;
+  }
+}
+
+// Converts the pixels to the format of the display, returns the number of bytes to send
+size_t LittleVgl::PreparePixels(lv_color_t* pixels, size_t count) const {
+  if (lcd.GetPixelFormat() == Pinetime::Drivers::St7789::PixelFormats::Rgb444) {
+    return PackRgb444(pixels, count);
+  }
+  return count * sizeof(lv_color_t);
+}
+
 void LittleVgl::FlushDisplay(const lv_area_t* area, lv_color_t* color_p) {
   uint16_t y1, y2, width, height = 0;
 
+  if (capture != nullptr) {
+    capture(captureContext, area, color_p);
+    lv_disp_flush_ready(&disp_drv);
+    return;
+  }
+
+  if (!frameStarted) {
+    const auto& statistics = lcd.GetStatistics();
+    frameStart.areas = statistics.areas;
+    frameStart.bytes = statistics.bytes;
+    frameStart.commands = statistics.commands;
+    frameStarted = true;
+    frameFlushes = 0;
+  }
+  frameFlushes++;
+
   if ((scrollDirection == LittleVgl::FullRefreshDirections::Down) && (area->y2 == visibleNbLines - 1)) {
     writeOffset = ((writeOffset + totalNbLines) - visibleNbLines) % totalNbLines;
   } else if ((scrollDirection == FullRefreshDirections::Up) && (area->y1 == 0)) {
@@ -214,24 +527,54 @@ void LittleVgl::FlushDisplay(const lv_area_t* area, lv_color_t* color_p) {
     }
   }
 
+  // Read before the transfer starts: the interrupt that ends it clears the flag in lv_disp_flush_ready()
+  const bool lastBand = lv_disp_flush_is_last(&disp_drv);
+
+  // IMPORTANT!!!
+  // Inform the graphics library that you are ready with the flushing.
+  // This is done from the SPI interrupt handler once the last byte has been sent, so that LVGL
+  // can render the next band into the other buffer while this one is still being transferred.
+  auto flushReady = [this]() {
+    lv_disp_flush_ready(&disp_drv);
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    xSemaphoreGiveFromISR(flushCompleted, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+  };
+
   if (y2 < y1) {
     height = totalNbLines - y1;
 
     if (height > 0) {
-      lcd.DrawBuffer(area->x1, y1, width, height, reinterpret_cast<const uint8_t*>(color_p), width * height * 2);
+      size_t size = PreparePixels(color_p, width * height);
+      lcd.DrawBuffer(area->x1, y1, width, height, reinterpret_cast<const uint8_t*>(color_p), size, nullptr);
     }
 
     uint16_t pixOffset = width * height;
     height = y2 + 1;
-    lcd.DrawBuffer(area->x1, 0, width, height, reinterpret_cast<const uint8_t*>(color_p + pixOffset), width * height * 2);
+    size_t size = PreparePixels(color_p + pixOffset, width * height);
+    lcd.DrawBuffer(area->x1, 0, width, height, reinterpret_cast<const uint8_t*>(color_p + pixOffset), size, flushReady);
 
   } else {
-    lcd.DrawBuffer(area->x1, y1, width, height, reinterpret_cast<const uint8_t*>(color_p), width * height * 2);
+    size_t size = PreparePixels(color_p, width * height);
+    lcd.DrawBuffer(area->x1, y1, width, height, reinterpret_cast<const uint8_t*>(color_p), size, flushReady);
   }
 
-  // IMPORTANT!!!
-  // Inform the graphics library that you are ready with the flushing
-  lv_disp_flush_ready(&disp_drv);
+  if (lastBand) {
+    const auto& statistics = lcd.GetStatistics();
+    frameStatistics.areas = statistics.areas - frameStart.areas;
+    frameStatistics.bytes = statistics.bytes - frameStart.bytes;
+    frameStatistics.commands = statistics.commands - frameStart.commands;
+    frameStatistics.flushes = frameFlushes;
+    frameStatistics.bandLines = bandLines;
+    frameStarted = false;
+  }
+}
+
+void LittleVgl::WaitFlush() {
+  // Called by LVGL while the previous buffer is still being flushed.
+  // Block until the SPI transfer completes instead of letting LVGL spin on the flushing flag.
+  // The timeout only guards against a missed notification: LVGL checks the flag again after each call.
+  xSemaphoreTake(flushCompleted, pdMS_TO_TICKS(10));
 }
 
 void LittleVgl::SetNewTouchPoint(int16_t x, int16_t y, bool contact) {
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <FreeRTOS.h>
+#include <semphr.h>
 #include <lvgl/lvgl.h>
 #include <components/fs/FS.h>
 
@@ -9,9 +11,29 @@ namespace Pinetime {
   }
 
   namespace Components {
+    class AssetCache;
+
     class LittleVgl {
     public:
       enum class FullRefreshDirections { None, Up, Down, Left, Right, LeftAnim, RightAnim };
+      // Display traffic of the last rendered frame
+      struct FrameStatistics {
+        uint32_t areas = 0;
+        uint32_t bytes = 0;
+        uint32_t commands = 0;
+        uint32_t flushes = 0;
+        uint32_t renderTimeMs = 0;
+        uint8_t bandLines = 0;
+      };
+      // Accumulated since the last call to ResetScreenStatistics()
+      struct ScreenStatistics {
+        uint32_t frames = 0;
+        uint32_t renderTimeMs = 0;
+        uint32_t flushes = 0;
+        uint32_t bytes = 0;
+      };
+      // Receives the bands rendered by CaptureScreen(), from the top of the screen to the bottom
+      using CaptureCallback = void (*)(void* context, const lv_area_t* area, const lv_color_t* pixels);
       LittleVgl(Pinetime::Drivers::St7789& lcd, Pinetime::Controllers::FS& filesystem);
 
       LittleVgl(const LittleVgl&) = delete;
@@ -22,8 +44,35 @@ namespace Pinetime {
       void Init();
 
       void FlushDisplay(const lv_area_t* area, lv_color_t* color_p);
+      void CoalesceArea(lv_area_t* area);
+      void WaitFlush();
       bool GetTouchPadInfo(lv_indev_data_t* ptr);
       void SetFullRefresh(FullRefreshDirections direction);
+      // The next frames redraw the whole screen
+      void RequestLargeBands() {
+        largeBandsRequested = true;
+      }
+      // Must be called between frames, after the screen to draw is created
+      void BorrowBands();
+      // The released assets of this cache are flushed when the heap is short
+      void SetAssetCache(AssetCache* cache) {
+        assetCache = cache;
+      }
+      // Returns the largest free block of the heap, after flushing the released assets if it is smaller than size
+      size_t ReclaimHeap(size_t size);
+      void OnFrameRendered(uint32_t renderTimeMs);
+      // Logs the statistics of every frame
+      void SetMeasurementMode(bool enabled) {
+        measurementMode = enabled;
+      }
+      // Renders a screen, which doesn't have to be the active one, to callback instead of the display.
+      // The top and system layers are left out.
+      void CaptureScreen(lv_obj_t* screen, CaptureCallback callback, void* context);
+
+      bool IsCapturing() const {
+        return capture != nullptr;
+      }
+
       void SetNewTouchPoint(int16_t x, int16_t y, bool contact);
       void CancelTap();
       void ClearTouchState();
@@ -37,10 +86,26 @@ namespace Pinetime {
         return returnValue;
       }
 
+      const FrameStatistics& GetFrameStatistics() const {
+        return frameStatistics;
+      }
+
+      const ScreenStatistics& GetScreenStatistics() const {
+        return screenStatistics;
+      }
+
+      void ResetScreenStatistics() {
+        screenStatistics = {};
+      }
+
     private:
       void InitDisplay();
       void InitTouchpad();
       void InitFileSystem();
+      void SetBands(lv_color_t* band1, lv_color_t* band2, uint8_t lines);
+      void ReleaseBands();
+      size_t PreparePixels(lv_color_t* pixels, size_t count) const;
+      static uint8_t RenderDirection(FullRefreshDirections direction);
 
       Pinetime::Drivers::St7789& lcd;
       Pinetime::Controllers::FS& filesystem;
@@ -50,9 +115,19 @@ namespace Pinetime {
       lv_color_t buf2_2[LV_HOR_RES_MAX * 4];
 
       lv_disp_drv_t disp_drv;
+      SemaphoreHandle_t flushCompleted = nullptr;
 
       bool fullRefresh = false;
       static constexpr uint8_t nbWriteLines = 4;
+      // Full screen redraws (new screens and transitions) borrow larger bands from the heap, up to this number of lines.
+      // Fewer, larger bands save the window setup and the wait for the flush of each band.
+      static constexpr uint8_t maxBandLines = 16;
+      // Heap left in the largest free block after borrowing the bands
+      static constexpr size_t bandHeapReserve = 4096;
+      static_assert(LV_VER_RES_MAX % maxBandLines == 0);
+      bool largeBandsRequested = false;
+      lv_color_t* borrowedBands = nullptr;
+      uint8_t bandLines = nbWriteLines;
       static constexpr uint16_t totalNbLines = 320;
       static constexpr uint16_t visibleNbLines = 240;
 
@@ -64,6 +139,25 @@ namespace Pinetime {
       uint16_t writeOffset = 0;
       uint16_t scrollOffset = 0;
 
+      // Areas invalidated since LVGL last emptied its list of invalidated areas
+      static constexpr uint8_t maxPendingAreas = 16;
+      // Number of extra pixels worth redrawing to save a window (CASET, RASET, RAMWR and a render pass)
+      static constexpr uint32_t windowSetupCost = LV_HOR_RES_MAX;
+      lv_area_t pendingAreas[maxPendingAreas];
+      uint8_t nbPendingAreas = 0;
+
+      bool frameStarted = false;
+      uint32_t frameFlushes = 0;
+      FrameStatistics frameStart;
+      FrameStatistics frameStatistics;
+      ScreenStatistics screenStatistics;
+      bool measurementMode = false;
+
+      CaptureCallback capture = nullptr;
+      void* captureContext = nullptr;
+
+      AssetCache* assetCache = nullptr;
+
       lv_point_t touchPoint = {};
       bool tapped = false;
       bool isCancelled = false;
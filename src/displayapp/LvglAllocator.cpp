@@ -0,0 +1,61 @@
+#include "displayapp/LvglAllocator.h"
+#include <cstdint>
+#include <FreeRTOS.h>
+#include <heap_4_infinitime.h>
+#include <lvgl/lvgl.h>
+#include "utility/BlockPool.h"
+
+namespace {
+  // lv_mem_alloc() rounds the size up to 4 bytes and adds a 4 bytes header (lv_mem.c). An object is a node of the child list
+  // of its parent: the lv_obj_t follows the 2 pointers of the node (lv_ll.c).
+  constexpr size_t lvglHeaderSize = sizeof(uint32_t);
+  constexpr size_t objectSize = sizeof(lv_obj_t) + 2 * sizeof(void*) + lvglHeaderSize;
+
+  // Sized for the peak of the default watch face (WatchFaceDigital and its StatusIcons), other screens overflow to the heap.
+  // The counts are derived from the objects the screen creates, the peaks shown in SystemInfo should replace them:
+  // - small: style lists, local styles, style maps of 1 or 2 properties and short texts, 4 per label: 58
+  // - medium: label extended data (20 bytes) and longer texts: 14
+  // - large: 17 objects (including the screen and the 2 layers) and 4 tasks (lv_task_t, 36 bytes): 21
+  // Each count leaves room for lv_mem_realloc(), which allocates the new block before freeing the old one.
+  Pinetime::Utility::BlockPool<16, 60> smallPool;
+  Pinetime::Utility::BlockPool<32, 16> mediumPool;
+  Pinetime::Utility::BlockPool<objectSize, 24> largePool;
+  uint32_t heapAllocations = 0;
+}
+
+void* LvglAllocate(size_t size) {
+  void* pointer = nullptr;
+  if (size <= smallPool.blockSize) {
+    pointer = smallPool.Allocate();
+  }
+  if (pointer == nullptr && size <= mediumPool.blockSize) {
+    pointer = mediumPool.Allocate();
+  }
+  if (pointer == nullptr && size <= largePool.blockSize) {
+    pointer = largePool.Allocate();
+  }
+  if (pointer == nullptr) {
+    heapAllocations++;
+    pointer = pvPortMallocLvgl(size);
+  }
+  return pointer;
+}
+
+void LvglFree(void* pointer) {
+  if (smallPool.Owns(pointer)) {
+    smallPool.Free(pointer);
+  } else if (mediumPool.Owns(pointer)) {
+    mediumPool.Free(pointer);
+  } else if (largePool.Owns(pointer)) {
+    largePool.Free(pointer);
+  } else {
+    vPortFree(pointer);
+  }
+}
+
+Pinetime::Components::LvglPoolStatistics Pinetime::Components::GetLvglPoolStatistics() {
+  return {smallPool.Used() + mediumPool.Used() + largePool.Used(),
+          smallPool.blockCount + mediumPool.blockCount + largePool.blockCount,
+          {smallPool.Peak(), mediumPool.Peak(), largePool.Peak()},
+          heapAllocations};
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Allocator of LVGL (LV_MEM_CUSTOM_ALLOC/LV_MEM_CUSTOM_FREE). Small blocks, like the objects, their extended data and style lists, come
+// from fixed-size pools, larger ones from the FreeRTOS heap. Only the display task allocates LVGL memory.
+void* LvglAllocate(size_t size);
+void LvglFree(void* pointer);
+
+#ifdef __cplusplus
+}
+
+namespace Pinetime {
+  namespace Components {
+    struct LvglPoolStatistics {
+      size_t used;
+      size_t blocks;
+      // Per size class: small, medium, large
+      size_t peaks[3];
+      uint32_t heapAllocations;
+    };
+
+    LvglPoolStatistics GetLvglPoolStatistics();
+  }
+}
+#endif
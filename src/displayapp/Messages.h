@@ -8,7 +8,13 @@ namespace Pinetime {
         GoToSleep,
         GoToAOD,
         GoToRunning,
+        // Changes of the state shown by the screens, see Screens::Changes
         UpdateBleConnection,
+        UpdateBattery,
+        UpdateNotifications,
+        UpdateSteps,
+        UpdateHeartRate,
+        UpdateWeather,
         TouchEvent,
         ButtonPushed,
         ButtonLongPressed,
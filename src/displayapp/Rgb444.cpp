@@ -0,0 +1,28 @@
+#include "displayapp/Rgb444.h"
+#include <cstdint>
+
+// The output never overtakes the input, each pair of pixels is read before it is overwritten.
+size_t Pinetime::Components::PackRgb444(lv_color_t* pixels, size_t count) {
+  static_assert(LV_COLOR_DEPTH == 16 && LV_COLOR_16_SWAP == 1, "PackRgb444 expects byte swapped RGB565 pixels");
+  auto* data = reinterpret_cast<uint8_t*>(pixels);
+  size_t written = 0;
+  for (size_t i = 0; i < count; i += 2) {
+    const uint8_t* pixel = data + i * 2;
+    uint8_t r1 = pixel[0] >> 4;
+    uint8_t g1 = ((pixel[0] & 0x07) << 1) | (pixel[1] >> 7);
+    uint8_t b1 = (pixel[1] & 0x1f) >> 1;
+    if (i + 1 < count) {
+      uint8_t r2 = pixel[2] >> 4;
+      uint8_t g2 = ((pixel[2] & 0x07) << 1) | (pixel[3] >> 7);
+      uint8_t b2 = (pixel[3] & 0x1f) >> 1;
+      data[written++] = (r1 << 4) | g1;
+      data[written++] = (b1 << 4) | r2;
+      data[written++] = (g2 << 4) | b2;
+    } else {
+      // The 4 padding bits of the last pixel are ignored by the display
+      data[written++] = (r1 << 4) | g1;
+      data[written++] = b1 << 4;
+    }
+  }
+  return written;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+#include <lvgl/lvgl.h>
+
+namespace Pinetime {
+  namespace Components {
+    // Packs byte swapped RGB565 pixels to the RGB444 format of the ST7789 in place: 2 pixels take 3 bytes instead of 4.
+    // Returns the number of bytes to send.
+    size_t PackRgb444(lv_color_t* pixels, size_t count);
+  }
+}
@@ -0,0 +1,349 @@
+#include "displayapp/StreamingFont.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace Pinetime::Components;
+
+namespace {
+  // Each table starts with its size (including this header) and a 4 characters label
+  constexpr uint32_t tableHeaderSize = 8;
+  constexpr uint32_t maxCmaps = 511;
+
+  bool ReadAt(lv_fs_file_t& file, uint32_t position, void* buffer, uint32_t size) {
+    uint32_t count = 0;
+    return lv_fs_seek(&file, position) == LV_FS_RES_OK && lv_fs_read(&file, buffer, size, &count) == LV_FS_RES_OK && count == size;
+  }
+
+  bool ReadLabel(lv_fs_file_t& file, uint32_t position, const char* label, uint32_t& length) {
+    struct __attribute__((packed)) {
+      uint32_t length;
+      char label[4];
+    } tableHeader;
+    if (!ReadAt(file, position, &tableHeader, sizeof(tableHeader)) || std::memcmp(tableHeader.label, label, 4) != 0 ||
+        tableHeader.length < tableHeaderSize) {
+      return false;
+    }
+    length = tableHeader.length;
+    return true;
+  }
+
+  // Glyph metrics are packed MSB first, with the number of bits of each field given by the font header
+  class BitReader {
+  public:
+    explicit BitReader(const uint8_t* data) : data {data} {
+    }
+
+    uint32_t Read(uint8_t bits) {
+      uint32_t value = 0;
+      while (bits-- > 0) {
+        value = (value << 1) | ((data[position / 8] >> (7 - position % 8)) & 1);
+        position++;
+      }
+      return value;
+    }
+
+    int32_t ReadSigned(uint8_t bits) {
+      uint32_t value = Read(bits);
+      if (bits > 0 && (value & (1U << (bits - 1))) != 0) {
+        value |= ~0U << bits;
+      }
+      return static_cast<int32_t>(value);
+    }
+
+  private:
+    const uint8_t* data;
+    size_t position = 0;
+  };
+}
+
+lv_font_t* StreamingFont::Load(const char* path) {
+  auto* streamingFont = new StreamingFont(path);
+  if (!streamingFont->Parse()) {
+    delete streamingFont;
+    return nullptr;
+  }
+  return &streamingFont->font;
+}
+
+void StreamingFont::Free(lv_font_t* font) {
+  if (Owns(font)) {
+    delete static_cast<StreamingFont*>(font->user_data);
+  }
+}
+
+bool StreamingFont::Owns(const lv_font_t* font) {
+  return font != nullptr && font->get_glyph_bitmap == GetGlyphBitmap;
+}
+
+size_t StreamingFont::Size(const lv_font_t* font) {
+  return Owns(font) ? static_cast<const StreamingFont*>(font->user_data)->allocatedSize : 0;
+}
+
+StreamingFont::StreamingFont(const char* path) : path {path} {
+}
+
+StreamingFont::~StreamingFont() {
+  if (fileOpen) {
+    lv_fs_close(&file);
+  }
+}
+
+bool StreamingFont::Parse() {
+  if (lv_fs_open(&file, path, LV_FS_MODE_RD) != LV_FS_RES_OK) {
+    return false;
+  }
+  // The bitmaps are read from the same file as long as the font is loaded, opening it costs a lookup in the file system
+  fileOpen = true;
+  allocatedSize += file.drv->file_size;
+
+  uint32_t headLength = 0;
+  uint32_t cmapsLength = 0;
+  Header header;
+  if (!ReadLabel(file, 0, "head", headLength) || !ReadAt(file, tableHeaderSize, &header, sizeof(Header)) ||
+      !LoadCmaps(headLength, cmapsLength) || !LoadGlyphs(headLength + cmapsLength, header)) {
+    return false;
+  }
+
+  dsc.bpp = header.bitsPerPixel;
+  dsc.bitmap_format = header.compressionId;
+  dsc.kern_dsc = nullptr;
+  dsc.kern_classes = 0;
+  dsc.kern_scale = 0;
+
+  font.base_line = -header.descent;
+  font.line_height = header.ascent - header.descent;
+  font.subpx = header.subpixelsMode;
+  font.get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt;
+  font.get_glyph_bitmap = GetGlyphBitmap;
+  font.dsc = &dsc;
+  font.user_data = this;
+
+  if (slotSize > 0) {
+    size_t slots = std::clamp<size_t>(cacheBudget / slotSize, minSlots, maxSlots);
+    slotCount = static_cast<uint8_t>(std::min<size_t>(slots, glyphCount - 1));
+    cache.reset(new uint8_t[slotSize * slotCount]);
+    allocatedSize += slotSize * slotCount;
+  }
+  return true;
+}
+
+bool StreamingFont::LoadCmaps(uint32_t start, uint32_t& length) {
+  uint32_t count = 0;
+  if (!ReadLabel(file, start, "cmap", length) || !ReadAt(file, start + tableHeaderSize, &count, sizeof(count)) || count == 0 ||
+      count > maxCmaps) {
+    return false;
+  }
+  std::unique_ptr<CmapTable[]> tables {new CmapTable[count]};
+  if (!ReadAt(file, start + tableHeaderSize + sizeof(count), tables.get(), count * sizeof(CmapTable))) {
+    return false;
+  }
+
+  // All the lists are stored in a single allocation, each one starting on a 16 bits boundary
+  size_t listsSize = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    switch (tables[i].formatType) {
+      case LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL:
+        listsSize += (tables[i].dataEntriesCount + 1) / 2;
+        break;
+      case LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY:
+        break;
+      case LV_FONT_FMT_TXT_CMAP_SPARSE_FULL:
+        listsSize += 2 * tables[i].dataEntriesCount;
+        break;
+      case LV_FONT_FMT_TXT_CMAP_SPARSE_TINY:
+        listsSize += tables[i].dataEntriesCount;
+        break;
+      default:
+        return false;
+    }
+  }
+  cmaps.reset(new lv_font_fmt_txt_cmap_t[count]());
+  cmapLists.reset(new uint16_t[listsSize]);
+  allocatedSize += count * sizeof(lv_font_fmt_txt_cmap_t) + listsSize * sizeof(uint16_t);
+
+  uint16_t* list = cmapLists.get();
+  for (uint32_t i = 0; i < count; i++) {
+    const CmapTable& table = tables[i];
+    lv_font_fmt_txt_cmap_t& cmap = cmaps[i];
+    cmap.range_start = table.rangeStart;
+    cmap.range_length = table.rangeLength;
+    cmap.glyph_id_start = table.glyphIdStart;
+    cmap.type = static_cast<lv_font_fmt_txt_cmap_type_t>(table.formatType);
+
+    uint32_t dataStart = start + table.dataOffset;
+    uint16_t entries = table.dataEntriesCount;
+    switch (table.formatType) {
+      case LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL:
+        if (!ReadAt(file, dataStart, list, entries)) {
+          return false;
+        }
+        cmap.glyph_id_ofs_list = list;
+        cmap.list_length = table.rangeLength;
+        list += (entries + 1) / 2;
+        break;
+      case LV_FONT_FMT_TXT_CMAP_SPARSE_FULL:
+      case LV_FONT_FMT_TXT_CMAP_SPARSE_TINY:
+        if (!ReadAt(file, dataStart, list, entries * sizeof(uint16_t))) {
+          return false;
+        }
+        cmap.unicode_list = list;
+        cmap.list_length = entries;
+        list += entries;
+        if (table.formatType == LV_FONT_FMT_TXT_CMAP_SPARSE_FULL) {
+          if (!ReadAt(file, dataStart + entries * sizeof(uint16_t), list, entries * sizeof(uint16_t))) {
+            return false;
+          }
+          cmap.glyph_id_ofs_list = list;
+          list += entries;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  dsc.cmaps = cmaps.get();
+  dsc.cmap_num = count;
+  return true;
+}
+
+bool StreamingFont::LoadGlyphs(uint32_t start, const Header& header) {
+  uint32_t locaLength = 0;
+  uint32_t count = 0;
+  if (!ReadLabel(file, start, "loca", locaLength) || !ReadAt(file, start + tableHeaderSize, &count, sizeof(count)) || count == 0 ||
+      count > UINT16_MAX) {
+    return false;
+  }
+
+  glyphOffsets.reset(new uint32_t[count + 1]);
+  allocatedSize += (count + 1) * sizeof(uint32_t);
+  uint32_t offsetsStart = start + tableHeaderSize + sizeof(count);
+  if (header.indexToLocFormat == 0) {
+    std::unique_ptr<uint16_t[]> shortOffsets {new uint16_t[count]};
+    if (!ReadAt(file, offsetsStart, shortOffsets.get(), count * sizeof(uint16_t))) {
+      return false;
+    }
+    std::copy(shortOffsets.get(), shortOffsets.get() + count, glyphOffsets.get());
+  } else if (header.indexToLocFormat == 1) {
+    if (!ReadAt(file, offsetsStart, glyphOffsets.get(), count * sizeof(uint32_t))) {
+      return false;
+    }
+  } else {
+    return false;
+  }
+
+  uint32_t glyfStart = start + locaLength;
+  uint32_t glyfLength = 0;
+  if (!ReadLabel(file, glyfStart, "glyf", glyfLength)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    glyphOffsets[i] += glyfStart;
+  }
+  glyphOffsets[count] = glyfStart + glyfLength;
+
+  uint32_t headerBits = header.advanceWidthBits + 2 * header.xyBits + 2 * header.whBits;
+  if (headerBits > 64) {
+    return false;
+  }
+  glyphHeaderBits = static_cast<uint8_t>(headerBits);
+  uint32_t headerBytes = (headerBits + 7) / 8;
+
+  // Glyph 0 is reserved and stays empty, like in lv_font_load()
+  glyphs.reset(new lv_font_fmt_txt_glyph_dsc_t[count]());
+  allocatedSize += count * sizeof(lv_font_fmt_txt_glyph_dsc_t);
+  for (uint32_t i = 1; i < count; i++) {
+    if (glyphOffsets[i + 1] < glyphOffsets[i] || glyphOffsets[i + 1] - glyphOffsets[i] < headerBytes) {
+      return false;
+    }
+    uint8_t metrics[8];
+    if (!ReadAt(file, glyphOffsets[i], metrics, headerBytes)) {
+      return false;
+    }
+
+    BitReader bits {metrics};
+    lv_font_fmt_txt_glyph_dsc_t& glyph = glyphs[i];
+    uint32_t advance = (header.advanceWidthBits == 0) ? header.defaultAdvanceWidth : bits.Read(header.advanceWidthBits);
+    if (header.advanceWidthFormat == 0) {
+      advance *= 16;
+    }
+    glyph.adv_w = advance;
+    glyph.ofs_x = static_cast<int8_t>(bits.ReadSigned(header.xyBits));
+    glyph.ofs_y = static_cast<int8_t>(bits.ReadSigned(header.xyBits));
+    glyph.box_w = static_cast<uint8_t>(bits.Read(header.whBits));
+    glyph.box_h = static_cast<uint8_t>(bits.Read(header.whBits));
+    // Every bitmap is read at the start of a cache slot
+    glyph.bitmap_index = 0;
+
+    if (glyph.box_w * glyph.box_h != 0) {
+      size_t bitmapSize = glyphOffsets[i + 1] - glyphOffsets[i] - glyphHeaderBits / 8;
+      slotSize = std::max(slotSize, bitmapSize);
+    }
+  }
+
+  glyphCount = static_cast<uint16_t>(count);
+  dsc.glyph_dsc = glyphs.get();
+  return true;
+}
+
+// Returns the raw (possibly compressed) bitmap of the glyph, read from the file if it is not in the cache
+const uint8_t* StreamingFont::FetchBitmap(uint16_t glyphId) {
+  Slot* target = nullptr;
+  for (uint8_t i = 0; i < slotCount; i++) {
+    if (slots[i].glyphId == glyphId) {
+      slots[i].lastUse = ++useCounter;
+      return &cache[i * slotSize];
+    }
+    if (target == nullptr || slots[i].lastUse < target->lastUse) {
+      target = &slots[i];
+    }
+  }
+  if (target == nullptr) {
+    return nullptr;
+  }
+
+  uint8_t* bitmap = &cache[(target - slots) * slotSize];
+  uint32_t bitmapStart = glyphOffsets[glyphId] + glyphHeaderBits / 8;
+  uint32_t bitmapSize = glyphOffsets[glyphId + 1] - bitmapStart;
+  target->glyphId = 0;
+  if (!ReadAt(file, bitmapStart, bitmap, bitmapSize)) {
+    return nullptr;
+  }
+
+  // The bitmap follows the metrics without padding, realign it on the first byte
+  uint8_t shift = glyphHeaderBits % 8;
+  if (shift != 0) {
+    for (uint32_t i = 0; i < bitmapSize; i++) {
+      uint8_t next = (i + 1 < bitmapSize) ? bitmap[i + 1] : 0;
+      bitmap[i] = static_cast<uint8_t>((bitmap[i] << shift) | (next >> (8 - shift)));
+    }
+  }
+
+  target->glyphId = glyphId;
+  target->lastUse = ++useCounter;
+  return bitmap;
+}
+
+const uint8_t* StreamingFont::GetGlyphBitmap(const lv_font_t* font, uint32_t letter) {
+  auto* self = static_cast<StreamingFont*>(font->user_data);
+
+  // lv_font_fmt_txt remembers the glyph id of the last letter looked up, which is the one being drawn
+  if (self->dsc.last_letter != letter) {
+    lv_font_glyph_dsc_t glyph;
+    if (!lv_font_get_glyph_dsc_fmt_txt(font, &glyph, letter, 0)) {
+      return nullptr;
+    }
+  }
+  uint32_t glyphId = self->dsc.last_glyph_id;
+  if (glyphId == 0 || glyphId >= self->glyphCount || self->glyphs[glyphId].box_w * self->glyphs[glyphId].box_h == 0) {
+    return nullptr;
+  }
+
+  const uint8_t* bitmap = self->FetchBitmap(static_cast<uint16_t>(glyphId));
+  if (bitmap == nullptr) {
+    return nullptr;
+  }
+  // With bitmap_index always 0, lv_font_get_bitmap_fmt_txt() returns (or decompresses) the bitmap at the start of the slot
+  self->dsc.glyph_bitmap = bitmap;
+  return lv_font_get_bitmap_fmt_txt(font, letter);
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <lvgl/lvgl.h>
+
+namespace Pinetime {
+  namespace Components {
+    /* LVGL font driver for the binary fonts generated by lv_font_conv (--format bin) that keeps only the character maps
+     * and the glyph descriptors in RAM. The bitmap of a glyph is read from the file system when it is drawn, into a small
+     * cache of the last glyphs drawn. The file stays open as long as the font is loaded. Metrics and bitmap decoding are
+     * delegated to LVGL's lv_font_fmt_txt functions. Kerning tables are not loaded.
+     */
+    class StreamingFont {
+    public:
+      // Returns nullptr if the file cannot be parsed. The path is not copied: it must be a string literal.
+      static lv_font_t* Load(const char* path);
+      static void Free(lv_font_t* font);
+      // True if font was returned by Load()
+      static bool Owns(const lv_font_t* font);
+      // Bytes allocated for a font returned by Load(), 0 for nullptr
+      static size_t Size(const lv_font_t* font);
+
+      StreamingFont(const StreamingFont&) = delete;
+      StreamingFont& operator=(const StreamingFont&) = delete;
+      StreamingFont(StreamingFont&&) = delete;
+      StreamingFont& operator=(StreamingFont&&) = delete;
+
+    private:
+      struct __attribute__((packed)) Header {
+        uint32_t version;
+        uint16_t tablesCount;
+        uint16_t fontSize;
+        uint16_t ascent;
+        int16_t descent;
+        uint16_t typoAscent;
+        int16_t typoDescent;
+        uint16_t typoLineGap;
+        int16_t minY;
+        int16_t maxY;
+        uint16_t defaultAdvanceWidth;
+        uint16_t kerningScale;
+        uint8_t indexToLocFormat;
+        uint8_t glyphIdFormat;
+        uint8_t advanceWidthFormat;
+        uint8_t bitsPerPixel;
+        uint8_t xyBits;
+        uint8_t whBits;
+        uint8_t advanceWidthBits;
+        uint8_t compressionId;
+        uint8_t subpixelsMode;
+        uint8_t padding;
+      };
+
+      struct __attribute__((packed)) CmapTable {
+        uint32_t dataOffset;
+        uint32_t rangeStart;
+        uint16_t rangeLength;
+        uint16_t glyphIdStart;
+        uint16_t dataEntriesCount;
+        uint8_t formatType;
+        uint8_t padding;
+      };
+
+      struct Slot {
+        uint16_t glyphId = 0;
+        uint32_t lastUse = 0;
+      };
+
+      // Bytes of glyph bitmaps kept in RAM. A label is drawn band after band, and each band draws the glyphs it crosses:
+      // the cache holds at least the distinct glyphs of a time (HH:MM) so that each one is read once per frame.
+      static constexpr size_t cacheBudget = 2048;
+      static constexpr uint8_t minSlots = 5;
+      static constexpr uint8_t maxSlots = 8;
+
+      explicit StreamingFont(const char* path);
+      ~StreamingFont();
+
+      bool Parse();
+      bool LoadCmaps(uint32_t start, uint32_t& length);
+      bool LoadGlyphs(uint32_t start, const Header& header);
+      const uint8_t* FetchBitmap(uint16_t glyphId);
+
+      static const uint8_t* GetGlyphBitmap(const lv_font_t* font, uint32_t letter);
+
+      lv_font_t font {};
+      lv_font_fmt_txt_dsc_t dsc {};
+      const char* path;
+      lv_fs_file_t file {};
+      bool fileOpen = false;
+
+      std::unique_ptr<lv_font_fmt_txt_cmap_t[]> cmaps;
+      std::unique_ptr<uint16_t[]> cmapLists;
+      std::unique_ptr<lv_font_fmt_txt_glyph_dsc_t[]> glyphs;
+      // Offset of each glyph in the file, followed by the end of the last glyph
+      std::unique_ptr<uint32_t[]> glyphOffsets;
+      uint16_t glyphCount = 0;
+      // Size of the metrics preceding the bitmap of each glyph
+      uint8_t glyphHeaderBits = 0;
+
+      std::unique_ptr<uint8_t[]> cache;
+      size_t slotSize = 0;
+      uint8_t slotCount = 0;
+      Slot slots[maxSlots];
+      uint32_t useCounter = 0;
+      // The object and the tables allocated while parsing
+      size_t allocatedSize = sizeof(StreamingFont);
+    };
+  }
+}
@@ -70,6 +70,7 @@ namespace Pinetime {
     template <>
     struct AppTraits<Apps::Alarm> {
       static constexpr Apps app = Apps::Alarm;
+      using ScreenType = Screens::Alarm;
       static constexpr const char* icon = Screens::Symbols::bell;
 
       static Screens::Screen* Create(AppControllers& controllers) {
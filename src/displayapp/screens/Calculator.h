@@ -73,6 +73,7 @@ namespace Pinetime {
     template <>
     struct AppTraits<Apps::Calculator> {
       static constexpr Apps app = Apps::Calculator;
+      using ScreenType = Screens::Calculator;
       static constexpr const char* icon = Screens::Symbols::calculator;
 
       static Screens::Screen* Create(AppControllers& /* controllers */) {
@@ -43,6 +43,7 @@ namespace Pinetime {
     template <>
     struct AppTraits<Apps::HeartRate> {
       static constexpr Apps app = Apps::HeartRate;
+      using ScreenType = Screens::HeartRate;
       static constexpr const char* icon = Screens::Symbols::heartBeat;
 
       static Screens::Screen* Create(AppControllers& controllers) {
@@ -42,6 +42,7 @@ namespace Pinetime {
     template <>
     struct AppTraits<Apps::Metronome> {
       static constexpr Apps app = Apps::Metronome;
+      using ScreenType = Screens::Metronome;
       static constexpr const char* icon = Screens::Symbols::drum;
 
       static Screens::Screen* Create(AppControllers& controllers) {
@@ -36,6 +36,7 @@ namespace Pinetime {
     template <>
     struct AppTraits<Apps::Motion> {
       static constexpr Apps app = Apps::Motion;
+      using ScreenType = Screens::Motion;
       static constexpr const char* icon = "M";
 
       static Screens::Screen* Create(AppControllers& controllers) {
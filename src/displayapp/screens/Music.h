@@ -92,6 +92,7 @@ namespace Pinetime {
     template <>
     struct AppTraits<Apps::Music> {
       static constexpr Apps app = Apps::Music;
+      using ScreenType = Screens::Music;
       static constexpr const char* icon = Screens::Symbols::music;
 
       static Screens::Screen* Create(AppControllers& controllers) {
@@ -62,6 +62,7 @@ namespace Pinetime {
     template <>
     struct AppTraits<Apps::Navigation> {
       static constexpr Apps app = Apps::Navigation;
+      using ScreenType = Screens::Navigation;
       static constexpr const char* icon = Screens::Symbols::map;
 
       static Screens::Screen* Create(AppControllers& controllers) {
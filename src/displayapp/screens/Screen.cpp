@@ -1,6 +1,125 @@
 #include "displayapp/screens/Screen.h"
+#include <algorithm>
+#include <new>
+#include "displayapp/UserApps.h"
+#include "displayapp/screens/ApplicationList.h"
+#include "displayapp/screens/BatteryInfo.h"
+#include "displayapp/screens/CheckboxList.h"
+#include "displayapp/screens/Error.h"
+#include "displayapp/screens/FirmwareUpdate.h"
+#include "displayapp/screens/FirmwareValidation.h"
+#include "displayapp/screens/FlashLight.h"
+#include "displayapp/screens/Label.h"
+#include "displayapp/screens/List.h"
+#include "displayapp/screens/Notifications.h"
+#include "displayapp/screens/PassKey.h"
+#include "displayapp/screens/SystemInfo.h"
+#include "displayapp/screens/Tile.h"
+#include "displayapp/screens/settings/QuickSettings.h"
+#include "displayapp/screens/settings/Settings.h"
+#include "displayapp/screens/settings/SettingBluetooth.h"
+#include "displayapp/screens/settings/SettingChimes.h"
+#include "displayapp/screens/settings/SettingDisplay.h"
+#include "displayapp/screens/settings/SettingHeartRate.h"
+#include "displayapp/screens/settings/SettingOTA.h"
+#include "displayapp/screens/settings/SettingSetDate.h"
+#include "displayapp/screens/settings/SettingSetDateTime.h"
+#include "displayapp/screens/settings/SettingSetTime.h"
+#include "displayapp/screens/settings/SettingShakeThreshold.h"
+#include "displayapp/screens/settings/SettingSteps.h"
+#include "displayapp/screens/settings/SettingTimeFormat.h"
+#include "displayapp/screens/settings/SettingWakeUp.h"
+#include "displayapp/screens/settings/SettingWatchFace.h"
+#include "displayapp/screens/settings/SettingWeatherFormat.h"
+#include "utility/BlockPool.h"
+
 using namespace Pinetime::Applications::Screens;
 
+namespace {
+  using namespace Pinetime::Applications;
+
+  template <typename... Ts>
+  constexpr size_t MaxSize() {
+    return std::max({sizeof(Ts)...});
+  }
+
+  template <template <Apps...> typename T, Apps... ts>
+  consteval size_t MaxAppSize(T<ts...>) {
+    return MaxSize<typename AppTraits<ts>::ScreenType...>();
+  }
+
+  template <template <WatchFace...> typename T, WatchFace... ts>
+  consteval size_t MaxWatchFaceSize(T<ts...>) {
+    return MaxSize<typename WatchFaceTraits<ts>::ScreenType...>();
+  }
+
+  // DisplayApp deletes the current screen before it creates the next one: a single block holds the screen loaded by DisplayApp.
+  constexpr size_t appScreenSize = std::max({MaxAppSize(UserAppTypes {}),
+                                             MaxWatchFaceSize(UserWatchFaceTypes {}),
+                                             MaxSize<ApplicationList,
+                                                     BatteryInfo,
+                                                     Error,
+                                                     FirmwareUpdate,
+                                                     FirmwareValidation,
+                                                     FlashLight,
+                                                     Notifications,
+                                                     PassKey,
+                                                     QuickSettings,
+                                                     Settings,
+                                                     SettingBluetooth,
+                                                     SettingChimes,
+                                                     SettingDisplay,
+                                                     SettingHeartRate,
+                                                     SettingOTA,
+                                                     SettingSetDateTime,
+                                                     SettingShakeThreshold,
+                                                     SettingSteps,
+                                                     SettingTimeFormat,
+                                                     SettingWakeUp,
+                                                     SettingWatchFace,
+                                                     SettingWeatherFormat,
+                                                     SystemInfo>()});
+
+  // Page of the ScreenList of the current screen: ScreenList deletes the current page before it creates the next one
+  constexpr size_t pageScreenSize = MaxSize<CheckboxList, Label, List, SettingSetDate, SettingSetTime, Tile>();
+
+  Pinetime::Utility::BlockPool<appScreenSize, 1> appScreenPool;
+  Pinetime::Utility::BlockPool<pageScreenSize, 1> pageScreenPool;
+  uint32_t heapFallbacks = 0;
+}
+
+// Uses the smallest free block that fits, or the heap if there is none (screens not listed above or nested deeper)
+void* Screen::operator new(size_t size) {
+  void* pointer = nullptr;
+  if (size <= pageScreenPool.blockSize) {
+    pointer = pageScreenPool.Allocate();
+  }
+  if (pointer == nullptr && size <= appScreenPool.blockSize) {
+    pointer = appScreenPool.Allocate();
+  }
+  if (pointer == nullptr) {
+    heapFallbacks++;
+    pointer = ::operator new(size);
+  }
+  return pointer;
+}
+
+void Screen::operator delete(void* pointer) {
+  if (pageScreenPool.Owns(pointer)) {
+    pageScreenPool.Free(pointer);
+  } else if (appScreenPool.Owns(pointer)) {
+    appScreenPool.Free(pointer);
+  } else {
+    ::operator delete(pointer);
+  }
+}
+
+Screen::PoolStatistics Screen::GetPoolStatistics() {
+  return {static_cast<uint8_t>(appScreenPool.Used() + pageScreenPool.Used()),
+          static_cast<uint8_t>(appScreenPool.Peak() + pageScreenPool.Peak()),
+          heapFallbacks};
+}
+
 void Screen::RefreshTaskCallback(lv_task_t* task) {
   static_cast<Screen*>(task->user_data)->Refresh();
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include "displayapp/TouchEvents.h"
 #include <lvgl/lvgl.h>
@@ -9,6 +10,23 @@ namespace Pinetime {
     class DisplayApp;
 
     namespace Screens {
+      // State shown by screens, see Screen::Subscriptions()
+      enum class Changes : uint8_t {
+        Second = 0x01,
+        Minute = 0x02,
+        Battery = 0x04,
+        Ble = 0x08,
+        Notifications = 0x10,
+        Steps = 0x20,
+        HeartRate = 0x40,
+        Weather = 0x80,
+      };
+
+      template <typename... Ts>
+      constexpr uint8_t ChangeMask(Ts... changes) {
+        return (static_cast<uint8_t>(changes) | ...);
+      }
+
       class Screen {
       private:
         virtual void Refresh() {
@@ -19,12 +37,34 @@ namespace Pinetime {
 
         virtual ~Screen() = default;
 
+        // Screens are allocated from fixed-size pools sized for the largest screens, see Screen.cpp
+        static void* operator new(size_t size);
+        static void operator delete(void* pointer);
+
+        struct PoolStatistics {
+          uint8_t used;
+          uint8_t peak;
+          uint32_t heapFallbacks;
+        };
+
+        static PoolStatistics GetPoolStatistics();
+
         static void RefreshTaskCallback(lv_task_t* task);
 
         bool IsRunning() const {
           return running;
         }
 
+        /** @return the Changes (see ChangeMask()) DisplayApp notifies the screen of, or 0 if the screen refreshes itself with a
+         * lv_task. DisplayApp doesn't wake up for LVGL while a subscribed screen is idle, so it must not rely on lv_tasks. */
+        virtual uint8_t Subscriptions() const {
+          return 0;
+        }
+
+        virtual void OnChange(Changes /*change*/) {
+          Refresh();
+        }
+
         /** @return false if the button hasn't been handled by the app, true if it has been handled */
         virtual bool OnButtonPushed() {
           return false;
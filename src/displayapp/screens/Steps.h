@@ -46,6 +46,7 @@ namespace Pinetime {
     template <>
     struct AppTraits<Apps::Steps> {
       static constexpr Apps app = Apps::Steps;
+      using ScreenType = Screens::Steps;
       static constexpr const char* icon = Screens::Symbols::shoe;
 
       static Screens::Screen* Create(AppControllers& controllers) {
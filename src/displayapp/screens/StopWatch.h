@@ -59,6 +59,7 @@ namespace Pinetime::Applications {
   template <>
   struct AppTraits<Apps::StopWatch> {
     static constexpr Apps app = Apps::StopWatch;
+    using ScreenType = Screens::StopWatch;
     static constexpr const char* icon = Screens::Symbols::stopWatch;
 
     static Screens::Screen* Create(AppControllers& controllers) {
@@ -1,9 +1,12 @@
 #include <FreeRTOS.h>
 #include <algorithm>
 #include <task.h>
+#include <heap_4_infinitime.h>
 #include "displayapp/screens/SystemInfo.h"
 #include <lvgl/lvgl.h>
 #include "displayapp/DisplayApp.h"
+#include "displayapp/AssetCache.h"
+#include "displayapp/LvglAllocator.h"
 #include "displayapp/screens/Label.h"
 #include "Version.h"
 #include "BootloaderVersion.h"
@@ -11,6 +14,7 @@
 #include "components/ble/BleController.h"
 #include "components/brightness/BrightnessController.h"
 #include "components/datetime/DateTimeController.h"
+#include "components/fs/FS.h"
 #include "components/motion/MotionController.h"
 #include "drivers/Watchdog.h"
 #include "displayapp/InfiniTimeTheme.h"
@@ -39,7 +43,9 @@ SystemInfo::SystemInfo(Pinetime::Applications::DisplayApp* app,
                        const Pinetime::Drivers::Watchdog& watchdog,
                        Pinetime::Controllers::MotionController& motionController,
                        const Pinetime::Drivers::Cst816S& touchPanel,
-                       const Pinetime::Drivers::SpiNorFlash& spiNorFlash)
+                       const Pinetime::Drivers::SpiNorFlash& spiNorFlash,
+                       const Pinetime::Components::AssetCache& assetCache,
+                       const Pinetime::Controllers::FS& filesystem)
   : dateTimeController {dateTimeController},
     batteryController {batteryController},
     brightnessController {brightnessController},
@@ -48,6 +54,8 @@ SystemInfo::SystemInfo(Pinetime::Applications::DisplayApp* app,
     motionController {motionController},
     touchPanel {touchPanel},
     spiNorFlash {spiNorFlash},
+    assetCache {assetCache},
+    filesystem {filesystem},
     screens {app,
              0,
              {[this]() -> std::unique_ptr<Screen> {
@@ -64,6 +72,9 @@ SystemInfo::SystemInfo(Pinetime::Applications::DisplayApp* app,
               },
               [this]() -> std::unique_ptr<Screen> {
                 return CreateScreen5();
+              },
+              [this]() -> std::unique_ptr<Screen> {
+                return CreateScreen6();
               }},
              Screens::ScreenListModes::UpDown} {
 }
@@ -86,17 +97,19 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen1() {
                         "#808080 Build date#\n"
                         "%s\n"
                         "%s\n\n"
-                        "#808080 Bootloader# %s",
+                        "#808080 Bootloader# %s\n"
+                        "#808080 Resources# %s",
                         Version::Major(),
                         Version::Minor(),
                         Version::Patch(),
                         Version::GitCommitHash(),
                         __DATE__,
                         __TIME__,
-                        BootloaderVersion::VersionString());
+                        BootloaderVersion::VersionString(),
+                        filesystem.ResourcesValid() ? "OK" : "#FF0000 invalid#");
   lv_label_set_align(label, LV_LABEL_ALIGN_CENTER);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(0, 5, label);
+  return std::make_unique<Screens::Label>(0, 6, label);
 }
 
 std::unique_ptr<Screen> SystemInfo::CreateScreen2() {
@@ -175,7 +188,7 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen2() {
                         touchPanel.GetFwVersion(),
                         TARGET_DEVICE_NAME);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(1, 5, label);
+  return std::make_unique<Screens::Label>(1, 6, label);
 }
 
 extern int mallocFailedCount;
@@ -188,17 +201,19 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen3() {
   lv_label_set_recolor(label, true);
   const auto& bleAddr = bleController.Address();
   auto spiFlashId = spiNorFlash.GetIdentification();
+  auto assetStatistics = assetCache.GetStatistics();
+  auto lvglPoolStatistics = Pinetime::Components::GetLvglPoolStatistics();
+  auto screenPoolStatistics = Screen::GetPoolStatistics();
   lv_label_set_text_fmt(label,
                         "#808080 BLE MAC#\n"
                         " %02x:%02x:%02x:%02x:%02x:%02x\n"
-                        "\n"
                         "#808080 SPI Flash# %02x-%02x-%02x\n"
-                        "\n"
-                        "#808080 Memory heap#\n"
-                        " #808080 Free# %d/%d\n"
-                        " #808080 Min free# %d\n"
-                        " #808080 Alloc err# %d\n"
-                        " #808080 Ovrfl err# %d",
+                        "#808080 Assets# %d B\n"
+                        " #808080 Hit/load# %lu/%lu %lums\n"
+                        "#808080 LVGL pool# %d/%d\n"
+                        " #808080 Peak# %d/%d/%d #808080 Heap# %lu\n"
+                        "#808080 Screen pool# %d\n"
+                        " #808080 Peak# %d #808080 Heap# %lu",
                         bleAddr[5],
                         bleAddr[4],
                         bleAddr[3],
@@ -208,20 +223,65 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen3() {
                         spiFlashId.manufacturer,
                         spiFlashId.type,
                         spiFlashId.density,
-                        xPortGetFreeHeapSize(),
+                        assetStatistics.cachedBytes,
+                        assetStatistics.hits,
+                        assetStatistics.loads,
+                        assetStatistics.loadTimeMs,
+                        lvglPoolStatistics.used,
+                        lvglPoolStatistics.blocks,
+                        lvglPoolStatistics.peaks[0],
+                        lvglPoolStatistics.peaks[1],
+                        lvglPoolStatistics.peaks[2],
+                        lvglPoolStatistics.heapAllocations,
+                        screenPoolStatistics.used,
+                        screenPoolStatistics.peak,
+                        screenPoolStatistics.heapFallbacks);
+  lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
+  return std::make_unique<Screens::Label>(2, 6, label);
+}
+
+std::unique_ptr<Screen> SystemInfo::CreateScreen4() {
+  HeapStatistics_t heap;
+  vPortGetHeapStatistics(&heap);
+
+  lv_obj_t* label = lv_label_create(lv_scr_act(), nullptr);
+  lv_label_set_recolor(label, true);
+  lv_label_set_text_fmt(label,
+                        "#808080 Memory heap#\n"
+                        " #808080 Free# %d/%d\n"
+                        " #808080 Min free# %d\n"
+                        " #808080 Largest# %d\n"
+                        " #808080 Free blocks# %d\n"
+                        "#808080 Blocks/bytes#\n"
+                        " #808080 LVGL# %d/%d\n"
+                        " #808080 NimBLE# %d/%d\n"
+                        " #808080 Screens# %d/%d\n"
+                        " #808080 Other# %d/%d\n"
+                        "#808080 Alloc/ovrfl err# %d/%d",
+                        heap.xAvailableHeapSpaceInBytes,
                         xPortGetHeapSize(),
-                        xPortGetMinimumEverFreeHeapSize(),
+                        heap.xMinimumEverFreeBytesRemaining,
+                        heap.xSizeOfLargestFreeBlockInBytes,
+                        heap.xNumberOfFreeBlocks,
+                        heap.xOwnerBlocks[heapOWNER_LVGL],
+                        heap.xOwnerBytes[heapOWNER_LVGL],
+                        heap.xOwnerBlocks[heapOWNER_NIMBLE],
+                        heap.xOwnerBytes[heapOWNER_NIMBLE],
+                        heap.xOwnerBlocks[heapOWNER_SCREENS],
+                        heap.xOwnerBytes[heapOWNER_SCREENS],
+                        heap.xOwnerBlocks[heapOWNER_OTHER],
+                        heap.xOwnerBytes[heapOWNER_OTHER],
                         mallocFailedCount,
                         stackOverflowCount);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(2, 5, label);
+  return std::make_unique<Screens::Label>(3, 6, label);
 }
 
 bool SystemInfo::sortById(const TaskStatus_t& lhs, const TaskStatus_t& rhs) {
   return lhs.xTaskNumber < rhs.xTaskNumber;
 }
 
-std::unique_ptr<Screen> SystemInfo::CreateScreen4() {
+std::unique_ptr<Screen> SystemInfo::CreateScreen5() {
   static constexpr uint8_t maxTaskCount = 9;
   TaskStatus_t tasksStatus[maxTaskCount];
 
@@ -280,10 +340,10 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen4() {
     }
     lv_table_set_cell_value(infoTask, i + 1, 3, buffer);
   }
-  return std::make_unique<Screens::Label>(3, 5, infoTask);
+  return std::make_unique<Screens::Label>(4, 6, infoTask);
 }
 
-std::unique_ptr<Screen> SystemInfo::CreateScreen5() {
+std::unique_ptr<Screen> SystemInfo::CreateScreen6() {
   lv_obj_t* label = lv_label_create(lv_scr_act(), nullptr);
   lv_label_set_recolor(label, true);
   lv_label_set_text_static(label,
@@ -297,5 +357,5 @@ std::unique_ptr<Screen> SystemInfo::CreateScreen5() {
                            "#FFFF00 InfiniTime#");
   lv_label_set_align(label, LV_LABEL_ALIGN_CENTER);
   lv_obj_align(label, lv_scr_act(), LV_ALIGN_CENTER, 0, 0);
-  return std::make_unique<Screens::Label>(4, 5, label);
+  return std::make_unique<Screens::Label>(5, 6, label);
 }
@@ -1,6 +1,4 @@
 #include "displayapp/screens/WatchFaceAnalog.h"
-#include <cmath>
-#include <limits>
 #include <lvgl/lvgl.h>
 #include "displayapp/screens/BatteryIcon.h"
 #include "displayapp/screens/BleIcon.h"
@@ -16,32 +14,9 @@ namespace {
   constexpr int16_t MinuteLength = 90;
   constexpr int16_t SecondLength = 110;
 
-  // LVGL sin isn't constexpr (though it could be if it were C++) so fix size here
-  // All the types are hardcoded anyway and would need changing if the size changed
-  // sin(90) = 1 so the value of _lv_trigo_sin(90) is the scaling factor
-  constexpr int16_t LV_TRIG_SCALE = std::numeric_limits<int16_t>::max(); // = _lv_trigo_sin(90)
-
-  int16_t Cosine(int16_t angle) {
-    return _lv_trigo_sin(angle + 90);
-  }
-
-  int16_t Sine(int16_t angle) {
-    return _lv_trigo_sin(angle);
-  }
-
-  int16_t CoordinateXRelocate(int16_t x) {
-    return (x + LV_HOR_RES / 2);
-  }
-
-  int16_t CoordinateYRelocate(int16_t y) {
-    return std::abs(y - LV_HOR_RES / 2);
-  }
-
-  lv_point_t CoordinateRelocate(int16_t radius, int16_t angle) {
-    return lv_point_t {.x = CoordinateXRelocate(radius * static_cast<int32_t>(Sine(angle)) / LV_TRIG_SCALE),
-                       .y = CoordinateYRelocate(radius * static_cast<int32_t>(Cosine(angle)) / LV_TRIG_SCALE)};
-  }
-
+  // Angles of the hands in half degrees, see Widgets::ClockHands
+  constexpr uint16_t MinuteAngle = Pinetime::Applications::Widgets::ClockHands::fullTurn / 60;
+  constexpr uint16_t HourAngle = Pinetime::Applications::Widgets::ClockHands::fullTurn / 12;
 }
 
 WatchFaceAnalog::WatchFaceAnalog(Controllers::DateTime& dateTimeController,
@@ -121,56 +96,17 @@ WatchFaceAnalog::WatchFaceAnalog(Controllers::DateTime& dateTimeController,
   lv_label_set_align(label_date_day, LV_LABEL_ALIGN_CENTER);
   lv_obj_align(label_date_day, nullptr, LV_ALIGN_CENTER, 50, 0);
 
-  minute_body = lv_line_create(lv_scr_act(), nullptr);
-  minute_body_trace = lv_line_create(lv_scr_act(), nullptr);
-  hour_body = lv_line_create(lv_scr_act(), nullptr);
-  hour_body_trace = lv_line_create(lv_scr_act(), nullptr);
-  second_body = lv_line_create(lv_scr_act(), nullptr);
-
-  lv_style_init(&second_line_style);
-  lv_style_set_line_width(&second_line_style, LV_STATE_DEFAULT, 3);
-  lv_style_set_line_color(&second_line_style, LV_STATE_DEFAULT, LV_COLOR_RED);
-  lv_style_set_line_rounded(&second_line_style, LV_STATE_DEFAULT, true);
-  lv_obj_add_style(second_body, LV_LINE_PART_MAIN, &second_line_style);
-
-  lv_style_init(&minute_line_style);
-  lv_style_set_line_width(&minute_line_style, LV_STATE_DEFAULT, 7);
-  lv_style_set_line_color(&minute_line_style, LV_STATE_DEFAULT, LV_COLOR_WHITE);
-  lv_style_set_line_rounded(&minute_line_style, LV_STATE_DEFAULT, true);
-  lv_obj_add_style(minute_body, LV_LINE_PART_MAIN, &minute_line_style);
-
-  lv_style_init(&minute_line_style_trace);
-  lv_style_set_line_width(&minute_line_style_trace, LV_STATE_DEFAULT, 3);
-  lv_style_set_line_color(&minute_line_style_trace, LV_STATE_DEFAULT, LV_COLOR_WHITE);
-  lv_style_set_line_rounded(&minute_line_style_trace, LV_STATE_DEFAULT, false);
-  lv_obj_add_style(minute_body_trace, LV_LINE_PART_MAIN, &minute_line_style_trace);
-
-  lv_style_init(&hour_line_style);
-  lv_style_set_line_width(&hour_line_style, LV_STATE_DEFAULT, 7);
-  lv_style_set_line_color(&hour_line_style, LV_STATE_DEFAULT, LV_COLOR_WHITE);
-  lv_style_set_line_rounded(&hour_line_style, LV_STATE_DEFAULT, true);
-  lv_obj_add_style(hour_body, LV_LINE_PART_MAIN, &hour_line_style);
-
-  lv_style_init(&hour_line_style_trace);
-  lv_style_set_line_width(&hour_line_style_trace, LV_STATE_DEFAULT, 3);
-  lv_style_set_line_color(&hour_line_style_trace, LV_STATE_DEFAULT, LV_COLOR_WHITE);
-  lv_style_set_line_rounded(&hour_line_style_trace, LV_STATE_DEFAULT, false);
-  lv_obj_add_style(hour_body_trace, LV_LINE_PART_MAIN, &hour_line_style_trace);
-
-  taskRefresh = lv_task_create(RefreshTaskCallback, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_MID, this);
+  hands.Create(lv_scr_act());
+  minute_body = hands.AddHand({30, MinuteLength, 7, true, LV_COLOR_WHITE});
+  minute_body_trace = hands.AddHand({5, 31, 3, false, LV_COLOR_WHITE});
+  hour_body = hands.AddHand({30, HourLength, 7, true, LV_COLOR_WHITE});
+  hour_body_trace = hands.AddHand({5, 31, 3, false, LV_COLOR_WHITE});
+  second_body = hands.AddHand({-20, SecondLength, 3, true, LV_COLOR_RED});
 
   Refresh();
 }
 
 WatchFaceAnalog::~WatchFaceAnalog() {
-  lv_task_del(taskRefresh);
-
-  lv_style_reset(&hour_line_style);
-  lv_style_reset(&hour_line_style_trace);
-  lv_style_reset(&minute_line_style);
-  lv_style_reset(&minute_line_style_trace);
-  lv_style_reset(&second_line_style);
-
   lv_obj_clean(lv_scr_act());
 }
 
@@ -180,39 +116,23 @@ void WatchFaceAnalog::UpdateClock() {
   uint8_t second = dateTimeController.Seconds();
 
   if (sMinute != minute) {
-    auto const angle = minute * 6;
-    minute_point[0] = CoordinateRelocate(30, angle);
-    minute_point[1] = CoordinateRelocate(MinuteLength, angle);
-
-    minute_point_trace[0] = CoordinateRelocate(5, angle);
-    minute_point_trace[1] = CoordinateRelocate(31, angle);
-
-    lv_line_set_points(minute_body, minute_point, 2);
-    lv_line_set_points(minute_body_trace, minute_point_trace, 2);
+    uint16_t angle = minute * MinuteAngle;
+    hands.SetAngle(minute_body, angle);
+    hands.SetAngle(minute_body_trace, angle);
   }
 
   if (sHour != hour || sMinute != minute) {
     sHour = hour;
     sMinute = minute;
-    auto const angle = (hour * 30 + minute / 2);
-
-    hour_point[0] = CoordinateRelocate(30, angle);
-    hour_point[1] = CoordinateRelocate(HourLength, angle);
-
-    hour_point_trace[0] = CoordinateRelocate(5, angle);
-    hour_point_trace[1] = CoordinateRelocate(31, angle);
-
-    lv_line_set_points(hour_body, hour_point, 2);
-    lv_line_set_points(hour_body_trace, hour_point_trace, 2);
+    // The hour hand moves by half a degree every minute
+    uint16_t angle = (hour % 12) * HourAngle + minute * HourAngle / 60;
+    hands.SetAngle(hour_body, angle);
+    hands.SetAngle(hour_body_trace, angle);
   }
 
   if (sSecond != second) {
     sSecond = second;
-    auto const angle = second * 6;
-
-    second_point[0] = CoordinateRelocate(-20, angle);
-    second_point[1] = CoordinateRelocate(SecondLength, angle);
-    lv_line_set_points(second_body, second_point, 2);
+    hands.SetAngle(second_body, second * MinuteAngle);
   }
 }
 
@@ -221,6 +141,10 @@ void WatchFaceAnalog::SetBatteryIcon() {
   batteryIcon.SetBatteryPercentage(batteryPercent);
 }
 
+uint8_t WatchFaceAnalog::Subscriptions() const {
+  return ChangeMask(Changes::Second, Changes::Battery, Changes::Ble, Changes::Notifications);
+}
+
 void WatchFaceAnalog::Refresh() {
   isCharging = batteryController.IsCharging();
   if (isCharging.IsUpdated()) {
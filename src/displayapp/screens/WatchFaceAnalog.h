@@ -10,6 +10,7 @@
 #include "components/ble/BleController.h"
 #include "components/ble/NotificationManager.h"
 #include "displayapp/screens/BatteryIcon.h"
+#include "displayapp/widgets/ClockHands.h"
 #include "utility/DirtyValue.h"
 
 namespace Pinetime {
@@ -34,6 +35,7 @@ namespace Pinetime {
         ~WatchFaceAnalog() override;
 
         void Refresh() override;
+        uint8_t Subscriptions() const override;
 
       private:
         uint8_t sHour, sMinute, sSecond;
@@ -50,23 +52,12 @@ namespace Pinetime {
         lv_obj_t* large_scales;
         lv_obj_t* twelve;
 
-        lv_obj_t* hour_body;
-        lv_obj_t* hour_body_trace;
-        lv_obj_t* minute_body;
-        lv_obj_t* minute_body_trace;
-        lv_obj_t* second_body;
-
-        lv_point_t hour_point[2];
-        lv_point_t hour_point_trace[2];
-        lv_point_t minute_point[2];
-        lv_point_t minute_point_trace[2];
-        lv_point_t second_point[2];
-
-        lv_style_t hour_line_style;
-        lv_style_t hour_line_style_trace;
-        lv_style_t minute_line_style;
-        lv_style_t minute_line_style_trace;
-        lv_style_t second_line_style;
+        Widgets::ClockHands hands;
+        uint8_t hour_body;
+        uint8_t hour_body_trace;
+        uint8_t minute_body;
+        uint8_t minute_body_trace;
+        uint8_t second_body;
 
         lv_obj_t* label_date_day;
         lv_obj_t* plugIcon;
@@ -84,13 +75,13 @@ namespace Pinetime {
         void UpdateClock();
         void SetBatteryIcon();
 
-        lv_task_t* taskRefresh;
       };
     }
 
     template <>
     struct WatchFaceTraits<WatchFace::Analog> {
       static constexpr WatchFace watchFace = WatchFace::Analog;
+      using ScreenType = Screens::WatchFaceAnalog;
       static constexpr const char* name = "Analog";
 
       static Screens::Screen* Create(AppControllers& controllers) {
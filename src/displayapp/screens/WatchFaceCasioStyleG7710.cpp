@@ -21,7 +21,8 @@ WatchFaceCasioStyleG7710::WatchFaceCasioStyleG7710(Controllers::DateTime& dateTi
                                                    Controllers::Settings& settingsController,
                                                    Controllers::HeartRateController& heartRateController,
                                                    Controllers::MotionController& motionController,
-                                                   Controllers::FS& filesystem)
+                                                   Components::AssetCache& assetCache,
+                                                   Components::LittleVgl& lvgl)
   : currentDateTime {{}},
     batteryIcon(false),
     dateTimeController {dateTimeController},
@@ -30,23 +31,15 @@ WatchFaceCasioStyleG7710::WatchFaceCasioStyleG7710(Controllers::DateTime& dateTi
     notificatioManager {notificatioManager},
     settingsController {settingsController},
     heartRateController {heartRateController},
-    motionController {motionController} {
+    motionController {motionController},
+    assetCache {assetCache} {
 
-  lfs_file f = {};
-  if (filesystem.FileOpen(&f, "/fonts/lv_font_dots_40.bin", LFS_O_RDONLY) >= 0) {
-    filesystem.FileClose(&f);
-    font_dot40 = lv_font_load("F:/fonts/lv_font_dots_40.bin");
-  }
-
-  if (filesystem.FileOpen(&f, "/fonts/7segments_40.bin", LFS_O_RDONLY) >= 0) {
-    filesystem.FileClose(&f);
-    font_segment40 = lv_font_load("F:/fonts/7segments_40.bin");
-  }
+  font_dot40 = assetCache.GetFont("F:/fonts/lv_font_dots_40.bin");
+  font_segment40 = assetCache.GetFont("F:/fonts/7segments_40.bin");
+  font_segment115 = assetCache.GetFont("F:/fonts/7segments_115.bin");
 
-  if (filesystem.FileOpen(&f, "/fonts/7segments_115.bin", LFS_O_RDONLY) >= 0) {
-    filesystem.FileClose(&f);
-    font_segment115 = lv_font_load("F:/fonts/7segments_115.bin");
-  }
+  // The lines never change, they are drawn from the static layer
+  staticLayer.Create(lv_scr_act());
 
   label_battery_value = lv_label_create(lv_scr_act(), nullptr);
   lv_obj_align(label_battery_value, lv_scr_act(), LV_ALIGN_IN_TOP_RIGHT, 0, 0);
@@ -100,17 +93,17 @@ WatchFaceCasioStyleG7710::WatchFaceCasioStyleG7710(Controllers::DateTime& dateTi
   lv_style_set_line_color(&style_border, LV_STATE_DEFAULT, color_text);
   lv_style_set_line_rounded(&style_border, LV_STATE_DEFAULT, true);
 
-  line_icons = lv_line_create(lv_scr_act(), nullptr);
+  line_icons = lv_line_create(staticLayer.GetObject(), nullptr);
   lv_line_set_points(line_icons, line_icons_points, 3);
   lv_obj_add_style(line_icons, LV_LINE_PART_MAIN, &style_line);
   lv_obj_align(line_icons, nullptr, LV_ALIGN_IN_TOP_RIGHT, -10, 18);
 
-  line_day_of_week_number = lv_line_create(lv_scr_act(), nullptr);
+  line_day_of_week_number = lv_line_create(staticLayer.GetObject(), nullptr);
   lv_line_set_points(line_day_of_week_number, line_day_of_week_number_points, 4);
   lv_obj_add_style(line_day_of_week_number, LV_LINE_PART_MAIN, &style_border);
   lv_obj_align(line_day_of_week_number, nullptr, LV_ALIGN_IN_TOP_LEFT, 0, 8);
 
-  line_day_of_year = lv_line_create(lv_scr_act(), nullptr);
+  line_day_of_year = lv_line_create(staticLayer.GetObject(), nullptr);
   lv_line_set_points(line_day_of_year, line_day_of_year_points, 3);
   lv_obj_add_style(line_day_of_year, LV_LINE_PART_MAIN, &style_line);
   lv_obj_align(line_day_of_year, nullptr, LV_ALIGN_IN_TOP_RIGHT, 0, 60);
@@ -121,7 +114,7 @@ WatchFaceCasioStyleG7710::WatchFaceCasioStyleG7710(Controllers::DateTime& dateTi
   lv_obj_set_style_local_text_font(label_date, LV_LABEL_PART_MAIN, LV_STATE_DEFAULT, font_segment40);
   lv_label_set_text_static(label_date, "6-30");
 
-  line_date = lv_line_create(lv_scr_act(), nullptr);
+  line_date = lv_line_create(staticLayer.GetObject(), nullptr);
   lv_line_set_points(line_date, line_date_points, 3);
   lv_obj_add_style(line_date, LV_LINE_PART_MAIN, &style_line);
   lv_obj_align(line_date, nullptr, LV_ALIGN_IN_TOP_RIGHT, 0, 100);
@@ -131,7 +124,7 @@ WatchFaceCasioStyleG7710::WatchFaceCasioStyleG7710(Controllers::DateTime& dateTi
   lv_obj_set_style_local_text_font(label_time, LV_LABEL_PART_MAIN, LV_STATE_DEFAULT, font_segment115);
   lv_obj_align(label_time, lv_scr_act(), LV_ALIGN_CENTER, 0, 40);
 
-  line_time = lv_line_create(lv_scr_act(), nullptr);
+  line_time = lv_line_create(staticLayer.GetObject(), nullptr);
   lv_line_set_points(line_time, line_time_points, 3);
   lv_obj_add_style(line_time, LV_LINE_PART_MAIN, &style_line);
   lv_obj_align(line_time, nullptr, LV_ALIGN_IN_BOTTOM_RIGHT, 0, -25);
@@ -168,29 +161,24 @@ WatchFaceCasioStyleG7710::WatchFaceCasioStyleG7710(Controllers::DateTime& dateTi
   lv_label_set_text_static(stepIcon, Symbols::shoe);
   lv_obj_align(stepIcon, stepValue, LV_ALIGN_OUT_LEFT_MID, -5, 0);
 
-  taskRefresh = lv_task_create(RefreshTaskCallback, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_MID, this);
+  staticLayer.Capture(lvgl);
   Refresh();
 }
 
 WatchFaceCasioStyleG7710::~WatchFaceCasioStyleG7710() {
-  lv_task_del(taskRefresh);
 
   lv_style_reset(&style_line);
   lv_style_reset(&style_border);
 
-  if (font_dot40 != nullptr) {
-    lv_font_free(font_dot40);
-  }
-
-  if (font_segment40 != nullptr) {
-    lv_font_free(font_segment40);
-  }
+  lv_obj_clean(lv_scr_act());
 
-  if (font_segment115 != nullptr) {
-    lv_font_free(font_segment115);
-  }
+  assetCache.Release(font_dot40);
+  assetCache.Release(font_segment40);
+  assetCache.Release(font_segment115);
+}
 
-  lv_obj_clean(lv_scr_act());
+uint8_t WatchFaceCasioStyleG7710::Subscriptions() const {
+  return ChangeMask(Changes::Minute, Changes::Battery, Changes::Ble, Changes::Notifications, Changes::Steps, Changes::HeartRate);
 }
 
 void WatchFaceCasioStyleG7710::Refresh() {
@@ -11,6 +11,8 @@
 #include "components/ble/BleController.h"
 #include "utility/DirtyValue.h"
 #include "displayapp/apps/Apps.h"
+#include "displayapp/AssetCache.h"
+#include "displayapp/widgets/StaticLayer.h"
 
 namespace Pinetime {
   namespace Controllers {
@@ -34,10 +36,12 @@ namespace Pinetime {
                                  Controllers::Settings& settingsController,
                                  Controllers::HeartRateController& heartRateController,
                                  Controllers::MotionController& motionController,
-                                 Controllers::FS& filesystem);
+                                 Components::AssetCache& assetCache,
+                                 Components::LittleVgl& lvgl);
         ~WatchFaceCasioStyleG7710() override;
 
         void Refresh() override;
+        uint8_t Subscriptions() const override;
 
         static bool IsAvailable(Pinetime::Controllers::FS& filesystem);
 
@@ -86,6 +90,7 @@ namespace Pinetime {
         lv_obj_t* line_icons;
 
         BatteryIcon batteryIcon;
+        Widgets::StaticLayer staticLayer;
 
         Controllers::DateTime& dateTimeController;
         const Controllers::Battery& batteryController;
@@ -95,7 +100,7 @@ namespace Pinetime {
         Controllers::HeartRateController& heartRateController;
         Controllers::MotionController& motionController;
 
-        lv_task_t* taskRefresh;
+        Components::AssetCache& assetCache;
         lv_font_t* font_dot40 = nullptr;
         lv_font_t* font_segment40 = nullptr;
         lv_font_t* font_segment115 = nullptr;
@@ -105,6 +110,7 @@ namespace Pinetime {
     template <>
     struct WatchFaceTraits<WatchFace::CasioStyleG7710> {
       static constexpr WatchFace watchFace = WatchFace::CasioStyleG7710;
+      using ScreenType = Screens::WatchFaceCasioStyleG7710;
       static constexpr const char* name = "Casio G7710";
 
       static Screens::Screen* Create(AppControllers& controllers) {
@@ -115,7 +121,8 @@ namespace Pinetime {
                                                      controllers.settingsController,
                                                      controllers.heartRateController,
                                                      controllers.motionController,
-                                                     controllers.filesystem);
+                                                     controllers.assetCache,
+                                                     controllers.lvgl);
       };
 
       static bool IsAvailable(Pinetime::Controllers::FS& filesystem) {
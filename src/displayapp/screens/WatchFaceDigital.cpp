@@ -86,15 +86,18 @@ WatchFaceDigital::WatchFaceDigital(Controllers::DateTime& dateTimeController,
   lv_label_set_text_static(stepIcon, Symbols::shoe);
   lv_obj_align(stepIcon, stepValue, LV_ALIGN_OUT_LEFT_MID, -5, 0);
 
-  taskRefresh = lv_task_create(RefreshTaskCallback, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_MID, this);
   Refresh();
 }
 
 WatchFaceDigital::~WatchFaceDigital() {
-  lv_task_del(taskRefresh);
   lv_obj_clean(lv_scr_act());
 }
 
+uint8_t WatchFaceDigital::Subscriptions() const {
+  return ChangeMask(
+    Changes::Minute, Changes::Battery, Changes::Ble, Changes::Notifications, Changes::Steps, Changes::HeartRate, Changes::Weather);
+}
+
 void WatchFaceDigital::Refresh() {
   statusIcons.Update();
 
@@ -40,6 +40,7 @@ namespace Pinetime {
         ~WatchFaceDigital() override;
 
         void Refresh() override;
+        uint8_t Subscriptions() const override;
 
       private:
         uint8_t displayedHour = -1;
@@ -72,7 +73,6 @@ namespace Pinetime {
         Controllers::MotionController& motionController;
         Controllers::SimpleWeatherService& weatherService;
 
-        lv_task_t* taskRefresh;
         Widgets::StatusIcons statusIcons;
       };
     }
@@ -80,6 +80,7 @@ namespace Pinetime {
     template <>
     struct WatchFaceTraits<WatchFace::Digital> {
       static constexpr WatchFace watchFace = WatchFace::Digital;
+      using ScreenType = Screens::WatchFaceDigital;
       static constexpr const char* name = "Digital";
 
       static Screens::Screen* Create(AppControllers& controllers) {
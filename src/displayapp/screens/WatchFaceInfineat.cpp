@@ -125,24 +125,18 @@ WatchFaceInfineat::WatchFaceInfineat(Controllers::DateTime& dateTimeController,
                                      Controllers::NotificationManager& notificationManager,
                                      Controllers::Settings& settingsController,
                                      Controllers::MotionController& motionController,
-                                     Controllers::FS& filesystem)
+                                     Components::AssetCache& assetCache)
   : currentDateTime {{}},
     dateTimeController {dateTimeController},
     batteryController {batteryController},
     bleController {bleController},
     notificationManager {notificationManager},
     settingsController {settingsController},
-    motionController {motionController} {
-  lfs_file f = {};
-  if (filesystem.FileOpen(&f, "/fonts/teko.bin", LFS_O_RDONLY) >= 0) {
-    filesystem.FileClose(&f);
-    font_teko = lv_font_load("F:/fonts/teko.bin");
-  }
-
-  if (filesystem.FileOpen(&f, "/fonts/bebas.bin", LFS_O_RDONLY) >= 0) {
-    filesystem.FileClose(&f);
-    font_bebas = lv_font_load("F:/fonts/bebas.bin");
-  }
+    motionController {motionController},
+    assetCache {assetCache} {
+  font_teko = assetCache.GetFont("F:/fonts/teko.bin");
+  font_bebas = assetCache.GetFont("F:/fonts/bebas.bin");
+  imagePine = assetCache.GetImage("F:/images/pine_small.bin");
 
   // Side Cover
   static constexpr lv_point_t linePoints[nLines][2] = {{{30, 25}, {68, -8}},
@@ -167,7 +161,11 @@ WatchFaceInfineat::WatchFaceInfineat(Controllers::DateTime& dateTimeController,
   }
 
   logoPine = lv_img_create(lv_scr_act(), nullptr);
-  lv_img_set_src(logoPine, "F:/images/pine_small.bin");
+  if (imagePine != nullptr) {
+    lv_img_set_src(logoPine, imagePine);
+  } else {
+    lv_img_set_src(logoPine, "F:/images/pine_small.bin");
+  }
   lv_obj_set_pos(logoPine, 15, 106);
 
   lineBattery = lv_line_create(lv_scr_act(), nullptr);
@@ -296,21 +294,15 @@ WatchFaceInfineat::WatchFaceInfineat(Controllers::DateTime& dateTimeController,
   lv_label_set_text_static(labelBtnSettings, Symbols::settings);
   lv_obj_set_hidden(btnSettings, true);
 
-  taskRefresh = lv_task_create(RefreshTaskCallback, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_MID, this);
   Refresh();
 }
 
 WatchFaceInfineat::~WatchFaceInfineat() {
-  lv_task_del(taskRefresh);
-
-  if (font_bebas != nullptr) {
-    lv_font_free(font_bebas);
-  }
-  if (font_teko != nullptr) {
-    lv_font_free(font_teko);
-  }
-
   lv_obj_clean(lv_scr_act());
+
+  assetCache.Release(font_bebas);
+  assetCache.Release(font_teko);
+  assetCache.Release(imagePine);
 }
 
 bool WatchFaceInfineat::OnTouchEvent(Pinetime::Applications::TouchEvents event) {
@@ -390,6 +382,14 @@ void WatchFaceInfineat::UpdateSelected(lv_obj_t* object, lv_event_t event) {
   }
 }
 
+uint8_t WatchFaceInfineat::Subscriptions() const {
+  // The charging animation and the timeout of the settings button need the seconds
+  if (batteryController.IsCharging() || !lv_obj_get_hidden(btnSettings)) {
+    return ChangeMask(Changes::Second, Changes::Battery, Changes::Ble, Changes::Notifications, Changes::Steps);
+  }
+  return ChangeMask(Changes::Minute, Changes::Battery, Changes::Ble, Changes::Notifications, Changes::Steps);
+}
+
 void WatchFaceInfineat::Refresh() {
   notificationState = notificationManager.AreNewNotificationsAvailable();
   if (notificationState.IsUpdated()) {
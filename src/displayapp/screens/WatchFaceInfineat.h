@@ -9,6 +9,7 @@
 #include "components/datetime/DateTimeController.h"
 #include "utility/DirtyValue.h"
 #include "displayapp/apps/Apps.h"
+#include "displayapp/AssetCache.h"
 
 namespace Pinetime {
   namespace Controllers {
@@ -31,7 +32,7 @@ namespace Pinetime {
                           Controllers::NotificationManager& notificationManager,
                           Controllers::Settings& settingsController,
                           Controllers::MotionController& motionController,
-                          Controllers::FS& fs);
+                          Components::AssetCache& assetCache);
 
         ~WatchFaceInfineat() override;
 
@@ -41,6 +42,7 @@ namespace Pinetime {
         void CloseMenu();
 
         void Refresh() override;
+        uint8_t Subscriptions() const override;
 
         static bool IsAvailable(Pinetime::Controllers::FS& filesystem);
 
@@ -95,15 +97,17 @@ namespace Pinetime {
         void SetBatteryLevel(uint8_t batteryPercent);
         void ToggleBatteryIndicatorColor(bool showSideCover);
 
-        lv_task_t* taskRefresh;
+        Components::AssetCache& assetCache;
         lv_font_t* font_teko = nullptr;
         lv_font_t* font_bebas = nullptr;
+        const lv_img_dsc_t* imagePine = nullptr;
       };
     }
 
     template <>
     struct WatchFaceTraits<WatchFace::Infineat> {
       static constexpr WatchFace watchFace = WatchFace::Infineat;
+      using ScreenType = Screens::WatchFaceInfineat;
       static constexpr const char* name = "Infineat";
 
       static Screens::Screen* Create(AppControllers& controllers) {
@@ -113,7 +117,7 @@ namespace Pinetime {
                                               controllers.notificationManager,
                                               controllers.settingsController,
                                               controllers.motionController,
-                                              controllers.filesystem);
+                                              controllers.assetCache);
       };
 
       static bool IsAvailable(Pinetime::Controllers::FS& filesystem) {
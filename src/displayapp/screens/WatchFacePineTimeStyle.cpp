@@ -51,7 +51,8 @@ WatchFacePineTimeStyle::WatchFacePineTimeStyle(Controllers::DateTime& dateTimeCo
                                                Controllers::NotificationManager& notificationManager,
                                                Controllers::Settings& settingsController,
                                                Controllers::MotionController& motionController,
-                                               Controllers::SimpleWeatherService& weatherService)
+                                               Controllers::SimpleWeatherService& weatherService,
+                                               Components::LittleVgl& lvgl)
   : currentDateTime {{}},
     batteryIcon(false),
     dateTimeController {dateTimeController},
@@ -60,10 +61,14 @@ WatchFacePineTimeStyle::WatchFacePineTimeStyle(Controllers::DateTime& dateTimeCo
     notificationManager {notificationManager},
     settingsController {settingsController},
     motionController {motionController},
-    weatherService {weatherService} {
+    weatherService {weatherService},
+    lvgl {lvgl} {
+
+  // The bars and the calendar icon are drawn from the static layer, they only change while the menu is open
+  staticLayer.Create(lv_scr_act());
 
   // Create a 200px wide background rectangle
-  timebar = lv_obj_create(lv_scr_act(), nullptr);
+  timebar = lv_obj_create(staticLayer.GetObject(), nullptr);
   lv_obj_set_style_local_bg_color(timebar, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, Convert(settingsController.GetPTSColorBG()));
   lv_obj_set_style_local_radius(timebar, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, 0);
   lv_obj_set_size(timebar, 200, 240);
@@ -89,16 +94,16 @@ WatchFacePineTimeStyle::WatchFacePineTimeStyle(Controllers::DateTime& dateTimeCo
   lv_obj_align(timeAMPM, timebar, LV_ALIGN_IN_BOTTOM_LEFT, 2, -20);
 
   // Create a 40px wide bar down the right side of the screen
-  sidebar = lv_obj_create(lv_scr_act(), nullptr);
+  sidebar = lv_obj_create(staticLayer.GetObject(), nullptr);
   lv_obj_set_style_local_bg_color(sidebar, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, Convert(settingsController.GetPTSColorBar()));
   lv_obj_set_style_local_radius(sidebar, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, 0);
   lv_obj_set_size(sidebar, 40, 240);
   lv_obj_align(sidebar, lv_scr_act(), LV_ALIGN_IN_TOP_RIGHT, 0, 0);
 
   // Display icons
-  batteryIcon.Create(sidebar);
+  batteryIcon.Create(lv_scr_act());
   batteryIcon.SetColor(LV_COLOR_BLACK);
-  lv_obj_align(batteryIcon.GetObject(), nullptr, LV_ALIGN_IN_TOP_MID, 10, 2);
+  lv_obj_align(batteryIcon.GetObject(), sidebar, LV_ALIGN_IN_TOP_MID, 10, 2);
 
   plugIcon = lv_label_create(lv_scr_act(), nullptr);
   lv_label_set_text_static(plugIcon, Symbols::plug);
@@ -136,7 +141,7 @@ WatchFacePineTimeStyle::WatchFacePineTimeStyle(Controllers::DateTime& dateTimeCo
   }
 
   // Calendar icon
-  calendarOuter = lv_obj_create(lv_scr_act(), nullptr);
+  calendarOuter = lv_obj_create(staticLayer.GetObject(), nullptr);
   lv_obj_set_style_local_bg_color(calendarOuter, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_BLACK);
   lv_obj_set_style_local_radius(calendarOuter, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, 0);
   lv_obj_set_size(calendarOuter, 34, 34);
@@ -146,31 +151,31 @@ WatchFacePineTimeStyle::WatchFacePineTimeStyle(Controllers::DateTime& dateTimeCo
     lv_obj_align(calendarOuter, sidebar, LV_ALIGN_CENTER, 0, 0);
   }
 
-  calendarInner = lv_obj_create(lv_scr_act(), nullptr);
+  calendarInner = lv_obj_create(staticLayer.GetObject(), nullptr);
   lv_obj_set_style_local_bg_color(calendarInner, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_WHITE);
   lv_obj_set_style_local_radius(calendarInner, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, 0);
   lv_obj_set_size(calendarInner, 27, 27);
   lv_obj_align(calendarInner, calendarOuter, LV_ALIGN_CENTER, 0, 0);
 
-  calendarBar1 = lv_obj_create(lv_scr_act(), nullptr);
+  calendarBar1 = lv_obj_create(staticLayer.GetObject(), nullptr);
   lv_obj_set_style_local_bg_color(calendarBar1, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_BLACK);
   lv_obj_set_style_local_radius(calendarBar1, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, 0);
   lv_obj_set_size(calendarBar1, 3, 12);
   lv_obj_align(calendarBar1, calendarOuter, LV_ALIGN_IN_TOP_MID, -6, -3);
 
-  calendarBar2 = lv_obj_create(lv_scr_act(), nullptr);
+  calendarBar2 = lv_obj_create(staticLayer.GetObject(), nullptr);
   lv_obj_set_style_local_bg_color(calendarBar2, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_BLACK);
   lv_obj_set_style_local_radius(calendarBar2, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, 0);
   lv_obj_set_size(calendarBar2, 3, 12);
   lv_obj_align(calendarBar2, calendarOuter, LV_ALIGN_IN_TOP_MID, 6, -3);
 
-  calendarCrossBar1 = lv_obj_create(lv_scr_act(), nullptr);
+  calendarCrossBar1 = lv_obj_create(staticLayer.GetObject(), nullptr);
   lv_obj_set_style_local_bg_color(calendarCrossBar1, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_BLACK);
   lv_obj_set_style_local_radius(calendarCrossBar1, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, 0);
   lv_obj_set_size(calendarCrossBar1, 8, 3);
   lv_obj_align(calendarCrossBar1, calendarBar1, LV_ALIGN_IN_BOTTOM_MID, 0, 0);
 
-  calendarCrossBar2 = lv_obj_create(lv_scr_act(), nullptr);
+  calendarCrossBar2 = lv_obj_create(staticLayer.GetObject(), nullptr);
   lv_obj_set_style_local_bg_color(calendarCrossBar2, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, LV_COLOR_BLACK);
   lv_obj_set_style_local_radius(calendarCrossBar2, LV_BTN_PART_MAIN, LV_STATE_DEFAULT, 0);
   lv_obj_set_size(calendarCrossBar2, 8, 3);
@@ -394,12 +399,11 @@ WatchFacePineTimeStyle::WatchFacePineTimeStyle(Controllers::DateTime& dateTimeCo
   lv_label_set_text_static(lblSetOpts, Symbols::settings);
   lv_obj_set_hidden(btnSetOpts, true);
 
-  taskRefresh = lv_task_create(RefreshTaskCallback, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_MID, this);
+  staticLayer.Capture(lvgl);
   Refresh();
 }
 
 WatchFacePineTimeStyle::~WatchFacePineTimeStyle() {
-  lv_task_del(taskRefresh);
   lv_obj_clean(lv_scr_act());
 }
 
@@ -429,6 +433,7 @@ void WatchFacePineTimeStyle::CloseMenu() {
   lv_obj_set_hidden(btnClose, true);
   lv_obj_set_hidden(btnSteps, true);
   lv_obj_set_hidden(btnWeather, true);
+  staticLayer.Capture(lvgl);
 }
 
 bool WatchFacePineTimeStyle::OnButtonPushed() {
@@ -444,6 +449,10 @@ void WatchFacePineTimeStyle::SetBatteryIcon() {
   batteryIcon.SetBatteryPercentage(batteryPercent);
 }
 
+uint8_t WatchFacePineTimeStyle::Subscriptions() const {
+  return ChangeMask(Changes::Second, Changes::Battery, Changes::Ble, Changes::Notifications, Changes::Steps, Changes::Weather);
+}
+
 void WatchFacePineTimeStyle::Refresh() {
   isCharging = batteryController.IsCharging();
   if (isCharging.IsUpdated()) {
@@ -734,6 +743,7 @@ void WatchFacePineTimeStyle::UpdateSelected(lv_obj_t* object, lv_event_t event)
       }
     }
     if (object == btnSetColor) {
+      staticLayer.Release();
       lv_obj_set_hidden(btnSetColor, true);
       lv_obj_set_hidden(btnSetOpts, true);
       lv_obj_set_hidden(btnNextTime, false);
@@ -747,6 +757,7 @@ void WatchFacePineTimeStyle::UpdateSelected(lv_obj_t* object, lv_event_t event)
       lv_obj_set_hidden(btnClose, false);
     }
     if (object == btnSetOpts) {
+      staticLayer.Release();
       lv_obj_set_hidden(btnSetColor, true);
       lv_obj_set_hidden(btnSetOpts, true);
       lv_obj_set_hidden(btnSteps, false);
@@ -8,6 +8,7 @@
 #include "displayapp/screens/Screen.h"
 #include "displayapp/screens/BatteryIcon.h"
 #include "displayapp/Colors.h"
+#include "displayapp/widgets/StaticLayer.h"
 #include "components/datetime/DateTimeController.h"
 #include "components/ble/SimpleWeatherService.h"
 #include "components/ble/BleController.h"
@@ -33,13 +34,15 @@ namespace Pinetime {
                                Controllers::NotificationManager& notificationManager,
                                Controllers::Settings& settingsController,
                                Controllers::MotionController& motionController,
-                               Controllers::SimpleWeatherService& weather);
+                               Controllers::SimpleWeatherService& weather,
+                               Components::LittleVgl& lvgl);
         ~WatchFacePineTimeStyle() override;
 
         bool OnTouchEvent(TouchEvents event) override;
         bool OnButtonPushed() override;
 
         void Refresh() override;
+        uint8_t Subscriptions() const override;
 
         void UpdateSelected(lv_obj_t* object, lv_event_t event);
 
@@ -105,6 +108,7 @@ namespace Pinetime {
         lv_color_t needle_colors[1];
 
         BatteryIcon batteryIcon;
+        Widgets::StaticLayer staticLayer;
 
         Controllers::DateTime& dateTimeController;
         const Controllers::Battery& batteryController;
@@ -113,17 +117,18 @@ namespace Pinetime {
         Controllers::Settings& settingsController;
         Controllers::MotionController& motionController;
         Controllers::SimpleWeatherService& weatherService;
+        Components::LittleVgl& lvgl;
 
         void SetBatteryIcon();
         void CloseMenu();
 
-        lv_task_t* taskRefresh;
       };
     }
 
     template <>
     struct WatchFaceTraits<WatchFace::PineTimeStyle> {
       static constexpr WatchFace watchFace = WatchFace::PineTimeStyle;
+      using ScreenType = Screens::WatchFacePineTimeStyle;
       static constexpr const char* name = "PineTimeStyle";
 
       static Screens::Screen* Create(AppControllers& controllers) {
@@ -133,7 +138,8 @@ namespace Pinetime {
                                                    controllers.notificationManager,
                                                    controllers.settingsController,
                                                    controllers.motionController,
-                                                   *controllers.weatherController);
+                                                   *controllers.weatherController,
+                                                   controllers.lvgl);
       };
 
       static bool IsAvailable(Pinetime::Controllers::FS& /*filesystem*/) {
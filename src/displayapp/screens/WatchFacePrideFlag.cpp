@@ -163,12 +163,10 @@ WatchFacePrideFlag::WatchFacePrideFlag(Controllers::DateTime& dateTimeController
 
   UpdateScreen(settingsController.GetPrideFlag());
 
-  taskRefresh = lv_task_create(RefreshTaskCallback, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_MID, this);
   Refresh();
 }
 
 WatchFacePrideFlag::~WatchFacePrideFlag() {
-  lv_task_del(taskRefresh);
   lv_obj_clean(lv_scr_act());
 }
 
@@ -193,6 +191,10 @@ void WatchFacePrideFlag::CloseMenu() {
   lv_obj_set_hidden(btnPrevFlag, true);
 }
 
+uint8_t WatchFacePrideFlag::Subscriptions() const {
+  return ChangeMask(Changes::Second, Changes::Battery, Changes::Ble, Changes::Notifications, Changes::Steps);
+}
+
 void WatchFacePrideFlag::Refresh() {
   powerPresent = batteryController.IsPowerPresent();
   bleState = bleController.IsConnected();
@@ -282,6 +284,7 @@ void WatchFacePrideFlag::UpdateSelected(lv_obj_t* object, lv_event_t event) {
     settingsController.SetPrideFlag(valueFlag);
     if (flagChanged) {
       UpdateScreen(valueFlag);
+      Refresh();
     }
   }
 }
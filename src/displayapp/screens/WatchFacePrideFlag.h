@@ -37,6 +37,7 @@ namespace Pinetime {
         bool OnButtonPushed() override;
 
         void Refresh() override;
+        uint8_t Subscriptions() const override;
 
         void UpdateSelected(lv_obj_t* object, lv_event_t event);
 
@@ -75,7 +76,6 @@ namespace Pinetime {
         Controllers::Settings& settingsController;
         Controllers::MotionController& motionController;
 
-        lv_task_t* taskRefresh;
         void CloseMenu();
       };
     }
@@ -83,6 +83,7 @@ namespace Pinetime {
     template <>
     struct WatchFaceTraits<WatchFace::PrideFlag> {
       static constexpr WatchFace watchFace = WatchFace::PrideFlag;
+      using ScreenType = Screens::WatchFacePrideFlag;
       static constexpr const char* name = "Pride Flag";
 
       static Screens::Screen* Create(AppControllers& controllers) {
@@ -62,15 +62,17 @@ WatchFaceTerminal::WatchFaceTerminal(Controllers::DateTime& dateTimeController,
   lv_label_set_recolor(stepValue, true);
   lv_obj_align(stepValue, lv_scr_act(), LV_ALIGN_IN_LEFT_MID, 0, 0);
 
-  taskRefresh = lv_task_create(RefreshTaskCallback, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_MID, this);
   Refresh();
 }
 
 WatchFaceTerminal::~WatchFaceTerminal() {
-  lv_task_del(taskRefresh);
   lv_obj_clean(lv_scr_act());
 }
 
+uint8_t WatchFaceTerminal::Subscriptions() const {
+  return ChangeMask(Changes::Second, Changes::Battery, Changes::Ble, Changes::Notifications, Changes::Steps, Changes::HeartRate);
+}
+
 void WatchFaceTerminal::Refresh() {
   powerPresent = batteryController.IsPowerPresent();
   batteryPercentRemaining = batteryController.PercentRemaining();
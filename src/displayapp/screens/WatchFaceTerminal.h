@@ -34,6 +34,7 @@ namespace Pinetime {
         ~WatchFaceTerminal() override;
 
         void Refresh() override;
+        uint8_t Subscriptions() const override;
 
       private:
         Utility::DirtyValue<int> batteryPercentRemaining {};
@@ -65,13 +66,13 @@ namespace Pinetime {
         Controllers::HeartRateController& heartRateController;
         Controllers::MotionController& motionController;
 
-        lv_task_t* taskRefresh;
       };
     }
 
     template <>
     struct WatchFaceTraits<WatchFace::Terminal> {
       static constexpr WatchFace watchFace = WatchFace::Terminal;
+      using ScreenType = Screens::WatchFaceTerminal;
       static constexpr const char* name = "Terminal";
 
       static Screens::Screen* Create(AppControllers& controllers) {
@@ -46,6 +46,7 @@ namespace Pinetime {
     template <>
     struct AppTraits<Apps::Weather> {
       static constexpr Apps app = Apps::Weather;
+      using ScreenType = Screens::Weather;
       static constexpr const char* icon = Screens::Symbols::cloudSunRain;
 
       static Screens::Screen* Create(AppControllers& controllers) {
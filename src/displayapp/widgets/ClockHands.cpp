@@ -0,0 +1,145 @@
+#include "displayapp/widgets/ClockHands.h"
+#include <algorithm>
+#include <cstdlib>
+#include "nrf_assert.h"
+
+using namespace Pinetime::Applications::Widgets;
+
+namespace {
+  constexpr double pi = 3.14159265358979323846;
+  // Same scale as _lv_trigo_sin()
+  constexpr int16_t sineScale = INT16_MAX;
+
+  // Taylor series of sin(x), more than precise enough for 0 <= x <= pi/2
+  constexpr double TaylorSine(double x) {
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 10; n++) {
+      term *= -x * x / ((2 * n) * (2 * n + 1));
+      sum += term;
+    }
+    return sum;
+  }
+
+  // Sine of every half degree of the first quadrant, computed at compile time
+  constexpr auto sineTable = [] {
+    std::array<int16_t, ClockHands::fullTurn / 4 + 1> table {};
+    for (size_t i = 0; i < table.size(); i++) {
+      table[i] = static_cast<int16_t>(TaylorSine(i * pi / (ClockHands::fullTurn / 2)) * sineScale + 0.5);
+    }
+    return table;
+  }();
+
+  constexpr int16_t Sine(uint16_t angle) {
+    constexpr uint16_t quarter = ClockHands::fullTurn / 4;
+    angle %= ClockHands::fullTurn;
+    if (angle <= quarter) {
+      return sineTable[angle];
+    }
+    if (angle <= 2 * quarter) {
+      return sineTable[2 * quarter - angle];
+    }
+    if (angle <= 3 * quarter) {
+      return -sineTable[angle - 2 * quarter];
+    }
+    return -sineTable[4 * quarter - angle];
+  }
+
+  constexpr int16_t Cosine(uint16_t angle) {
+    return Sine(angle + ClockHands::fullTurn / 4);
+  }
+
+  static_assert(Sine(0) == 0 && Sine(180) == sineScale && Sine(360) == 0 && Sine(540) == -sineScale);
+}
+
+void ClockHands::Create(lv_obj_t* parent) {
+  object = lv_obj_create(parent, nullptr);
+  lv_obj_set_size(object, LV_HOR_RES, LV_VER_RES);
+  lv_obj_set_pos(object, 0, 0);
+  lv_obj_set_click(object, false);
+  lv_obj_set_user_data(object, this);
+  lv_obj_set_design_cb(object, Draw);
+}
+
+uint8_t ClockHands::AddHand(const Hand& hand) {
+  ASSERT(nbHands < maxHands);
+  hands[nbHands] = {hand, {0, 0}, {0, 0}, false};
+  return nbHands++;
+}
+
+void ClockHands::SetAngle(uint8_t hand, uint16_t angle) {
+  HandState& state = hands[hand];
+  lv_point_t start = Point(state.hand.innerRadius, angle);
+  lv_point_t end = Point(state.hand.outerRadius, angle);
+  if (state.visible && start.x == state.start.x && start.y == state.start.y && end.x == state.end.x && end.y == state.end.y) {
+    return;
+  }
+  if (state.visible) {
+    Invalidate(state);
+  }
+  state.start = start;
+  state.end = end;
+  state.visible = true;
+  Invalidate(state);
+}
+
+lv_point_t ClockHands::Point(int16_t radius, uint16_t angle) {
+  return lv_point_t {.x = static_cast<lv_coord_t>(LV_HOR_RES / 2 + radius * static_cast<int32_t>(Sine(angle)) / sineScale),
+                     .y = static_cast<lv_coord_t>(LV_VER_RES / 2 - radius * static_cast<int32_t>(Cosine(angle)) / sineScale)};
+}
+
+// Splits the hand in short pieces and invalidates the bounding box of each one, which is much smaller than the bounding box
+// of the whole hand unless it is nearly vertical or horizontal
+void ClockHands::Invalidate(const HandState& state) const {
+  // Half of the width, the rounded ends and the anti-aliasing
+  const lv_coord_t padding = state.hand.width / 2 + 2;
+  const int16_t dx = state.end.x - state.start.x;
+  const int16_t dy = state.end.y - state.start.y;
+  const int16_t boxes = 1 + std::max(std::abs(dx), std::abs(dy)) / boxLength;
+  lv_point_t from = state.start;
+  for (int16_t i = 1; i <= boxes; i++) {
+    lv_point_t to {static_cast<lv_coord_t>(state.start.x + dx * i / boxes), static_cast<lv_coord_t>(state.start.y + dy * i / boxes)};
+    lv_area_t area {static_cast<lv_coord_t>(std::min(from.x, to.x) - padding),
+                    static_cast<lv_coord_t>(std::min(from.y, to.y) - padding),
+                    static_cast<lv_coord_t>(std::max(from.x, to.x) + padding),
+                    static_cast<lv_coord_t>(std::max(from.y, to.y) + padding)};
+    lv_obj_invalidate_area(object, &area);
+    from = to;
+  }
+}
+
+lv_design_res_t ClockHands::Draw(lv_obj_t* obj, const lv_area_t* clipArea, lv_design_mode_t mode) {
+  if (mode == LV_DESIGN_COVER_CHK) {
+    return LV_DESIGN_RES_NOT_COVER;
+  }
+  if (mode != LV_DESIGN_DRAW_MAIN) {
+    return LV_DESIGN_RES_OK;
+  }
+
+  const auto* clockHands = static_cast<const ClockHands*>(lv_obj_get_user_data(obj));
+  for (uint8_t i = 0; i < clockHands->nbHands; i++) {
+    const HandState& state = clockHands->hands[i];
+    if (!state.visible) {
+      continue;
+    }
+    // Skips the hands outside of the area being redrawn
+    const lv_coord_t padding = state.hand.width / 2 + 2;
+    lv_area_t handArea {static_cast<lv_coord_t>(std::min(state.start.x, state.end.x) - padding),
+                        static_cast<lv_coord_t>(std::min(state.start.y, state.end.y) - padding),
+                        static_cast<lv_coord_t>(std::max(state.start.x, state.end.x) + padding),
+                        static_cast<lv_coord_t>(std::max(state.start.y, state.end.y) + padding)};
+    lv_area_t drawArea;
+    if (!_lv_area_intersect(&drawArea, &handArea, clipArea)) {
+      continue;
+    }
+
+    lv_draw_line_dsc_t lineDsc;
+    lv_draw_line_dsc_init(&lineDsc);
+    lineDsc.color = state.hand.color;
+    lineDsc.width = state.hand.width;
+    lineDsc.round_start = state.hand.rounded;
+    lineDsc.round_end = state.hand.rounded;
+    lv_draw_line(&state.start, &state.end, &drawArea, &lineDsc);
+  }
+  return LV_DESIGN_RES_OK;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <lvgl/lvgl.h>
+
+namespace Pinetime {
+  namespace Applications {
+    namespace Widgets {
+      // Hands of an analog clock, all drawn by a single object. Moving a hand only invalidates a few small boxes along its
+      // previous and new positions instead of the bounding boxes of the lines, so most of the dial isn't redrawn.
+      class ClockHands {
+      public:
+        struct Hand {
+          // A negative inner radius extends the hand past the centre
+          int16_t innerRadius;
+          int16_t outerRadius;
+          uint8_t width;
+          bool rounded;
+          lv_color_t color;
+        };
+
+        static constexpr uint8_t maxHands = 5;
+        // Angles are in half degrees, clockwise from 12 o'clock
+        static constexpr uint16_t fullTurn = 720;
+
+        void Create(lv_obj_t* parent);
+        // Hands are drawn in the order they are added. Returns the index of the hand
+        uint8_t AddHand(const Hand& hand);
+        void SetAngle(uint8_t hand, uint16_t angle);
+
+      private:
+        struct HandState {
+          Hand hand;
+          lv_point_t start;
+          lv_point_t end;
+          bool visible;
+        };
+
+        // Length of the hand covered by a single invalidated box
+        static constexpr int16_t boxLength = 32;
+
+        std::array<HandState, maxHands> hands;
+        uint8_t nbHands = 0;
+        lv_obj_t* object = nullptr;
+
+        void Invalidate(const HandState& state) const;
+        static lv_point_t Point(int16_t radius, uint16_t angle);
+        static lv_design_res_t Draw(lv_obj_t* obj, const lv_area_t* clipArea, lv_design_mode_t mode);
+      };
+    }
+  }
+}
@@ -0,0 +1,187 @@
+#include "displayapp/widgets/StaticLayer.h"
+#include <algorithm>
+#include <cstring>
+#include <FreeRTOS.h>
+#include <heap_4_infinitime.h>
+#include "displayapp/LittleVgl.h"
+
+using namespace Pinetime::Applications::Widgets;
+
+StaticLayer::~StaticLayer() {
+  // The object is deleted with the screen
+  lv_mem_free(cache);
+}
+
+void StaticLayer::Create(lv_obj_t* screen) {
+  object = lv_obj_create(screen, nullptr);
+  lv_obj_set_size(object, LV_HOR_RES, LV_VER_RES);
+  lv_obj_set_pos(object, 0, 0);
+  lv_obj_set_click(object, false);
+  lv_obj_set_user_data(object, this);
+  lv_obj_set_design_cb(object, Draw);
+  lv_obj_move_background(object);
+}
+
+bool StaticLayer::Capture(Components::LittleVgl& lvgl) {
+  Release();
+  if (lvgl.ReclaimHeap(budget + heapReserve) < budget + heapReserve) {
+    return false;
+  }
+  buffer = static_cast<uint8_t*>(lv_mem_alloc(budget));
+  if (buffer == nullptr) {
+    return false;
+  }
+  written = rowOffsetsSize;
+  nextRow = 0;
+  failed = false;
+
+  // Only the children are rendered, over a copy of the screen which has the same background
+  lv_obj_t* screen = lv_obj_get_parent(object);
+  lv_obj_t* captureScreen = lv_obj_create(nullptr, screen);
+  lv_obj_set_parent(object, captureScreen);
+  lvgl.CaptureScreen(captureScreen, Encode, this);
+  lv_obj_set_parent(object, screen);
+  lv_obj_move_background(object);
+  lv_obj_del(captureScreen);
+
+  if (failed || nextRow != LV_VER_RES) {
+    lv_mem_free(buffer);
+    buffer = nullptr;
+    return false;
+  }
+
+  // Keeps only the bytes used by the rows, if the heap can spare the copy
+  cache = buffer;
+  buffer = nullptr;
+  HeapStatistics_t heap;
+  vPortGetHeapStatistics(&heap);
+  if (heap.xSizeOfLargestFreeBlockInBytes >= written + heapReserve) {
+    auto* trimmed = static_cast<uint8_t*>(lv_mem_alloc(written));
+    if (trimmed != nullptr) {
+      std::memcpy(trimmed, cache, written);
+      lv_mem_free(cache);
+      cache = trimmed;
+    }
+  }
+
+  for (lv_obj_t* child = lv_obj_get_child(object, nullptr); child != nullptr; child = lv_obj_get_child(object, child)) {
+    lv_obj_set_hidden(child, true);
+  }
+  return true;
+}
+
+void StaticLayer::Release() {
+  if (cache == nullptr) {
+    return;
+  }
+  for (lv_obj_t* child = lv_obj_get_child(object, nullptr); child != nullptr; child = lv_obj_get_child(object, child)) {
+    lv_obj_set_hidden(child, false);
+  }
+  lv_mem_free(cache);
+  cache = nullptr;
+}
+
+void StaticLayer::Encode(void* context, const lv_area_t* area, const lv_color_t* pixels) {
+  static_cast<StaticLayer*>(context)->EncodeBand(area, pixels);
+}
+
+// The bands of a capture cover the whole width of the screen and come in order
+void StaticLayer::EncodeBand(const lv_area_t* area, const lv_color_t* pixels) {
+  const lv_coord_t width = lv_area_get_width(area);
+  if (failed || area->x1 != 0 || width != LV_HOR_RES || area->y1 != nextRow) {
+    failed = true;
+    return;
+  }
+
+  auto* rowOffsets = reinterpret_cast<uint16_t*>(buffer);
+  for (lv_coord_t y = area->y1; y <= area->y2; y++) {
+    if (written + maxRowSize > budget) {
+      failed = true;
+      return;
+    }
+    rowOffsets[y] = static_cast<uint16_t>(written);
+    written += EncodeRow(pixels, width, buffer + written);
+    pixels += width;
+  }
+  nextRow = area->y2 + 1;
+}
+
+size_t StaticLayer::EncodeRow(const lv_color_t* pixels, lv_coord_t length, uint8_t* output) {
+  const uint8_t* start = output;
+  lv_coord_t x = 0;
+  while (x < length) {
+    lv_coord_t count = 1;
+    while (x + count < length && count < maxRepeat && pixels[x + count].full == pixels[x].full) {
+      count++;
+    }
+    if (count >= 2) {
+      *output++ = static_cast<uint8_t>(0x80 + count - 2);
+      std::memcpy(output, &pixels[x], sizeof(lv_color_t));
+      output += sizeof(lv_color_t);
+      x += count;
+      continue;
+    }
+
+    // Literal pixels, up to the start of the next repeated one
+    while (x + count < length && count < maxLiterals &&
+           !(x + count + 1 < length && pixels[x + count].full == pixels[x + count + 1].full)) {
+      count++;
+    }
+    *output++ = static_cast<uint8_t>(count - 1);
+    std::memcpy(output, &pixels[x], count * sizeof(lv_color_t));
+    output += count * sizeof(lv_color_t);
+    x += count;
+  }
+  return output - start;
+}
+
+// Decodes the pixels x to x + length - 1 of the row y
+void StaticLayer::DecodeRow(lv_coord_t y, lv_coord_t x, lv_coord_t length, lv_color_t* pixels) const {
+  const uint8_t* data = cache + reinterpret_cast<const uint16_t*>(cache)[y];
+  const lv_coord_t end = x + length;
+  lv_coord_t position = 0;
+  while (position < end) {
+    const uint8_t control = *data++;
+    const bool repeated = control >= 0x80;
+    const lv_coord_t count = repeated ? control - 0x80 + 2 : control + 1;
+    const lv_coord_t from = std::max(position, x);
+    const lv_coord_t to = std::min<lv_coord_t>(position + count, end);
+    if (repeated) {
+      if (from < to) {
+        lv_color_t color;
+        std::memcpy(&color, data, sizeof(lv_color_t));
+        std::fill(pixels + (from - x), pixels + (to - x), color);
+      }
+      data += sizeof(lv_color_t);
+    } else {
+      if (from < to) {
+        std::memcpy(pixels + (from - x), data + (from - position) * sizeof(lv_color_t), (to - from) * sizeof(lv_color_t));
+      }
+      data += count * sizeof(lv_color_t);
+    }
+    position += count;
+  }
+}
+
+// Copies the cached pixels straight to the draw buffer: nothing is below the layer, the screen background is in the cache
+lv_design_res_t StaticLayer::Draw(lv_obj_t* obj, const lv_area_t* clipArea, lv_design_mode_t mode) {
+  const auto* layer = static_cast<const StaticLayer*>(lv_obj_get_user_data(obj));
+  if (mode == LV_DESIGN_COVER_CHK) {
+    bool covered = layer->cache != nullptr && _lv_area_is_in(clipArea, &obj->coords, 0);
+    return covered ? LV_DESIGN_RES_COVER : LV_DESIGN_RES_NOT_COVER;
+  }
+  lv_area_t drawArea;
+  if (mode != LV_DESIGN_DRAW_MAIN || layer->cache == nullptr || !_lv_area_intersect(&drawArea, clipArea, &obj->coords)) {
+    return LV_DESIGN_RES_OK;
+  }
+
+  lv_disp_buf_t* drawBuffer = lv_disp_get_buf(_lv_refr_get_disp_refreshing());
+  const lv_area_t& bufferArea = drawBuffer->area;
+  const lv_coord_t bufferWidth = lv_area_get_width(&bufferArea);
+  auto* bufferPixels = static_cast<lv_color_t*>(drawBuffer->buf_act);
+  for (lv_coord_t y = drawArea.y1; y <= drawArea.y2; y++) {
+    lv_color_t* pixels = bufferPixels + (y - bufferArea.y1) * bufferWidth + (drawArea.x1 - bufferArea.x1);
+    layer->DecodeRow(y - obj->coords.y1, drawArea.x1 - obj->coords.x1, lv_area_get_width(&drawArea), pixels);
+  }
+  return LV_DESIGN_RES_OK;
+}
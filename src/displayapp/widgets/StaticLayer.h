@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <lvgl/lvgl.h>
+
+namespace Pinetime {
+  namespace Components {
+    class LittleVgl;
+  }
+
+  namespace Applications {
+    namespace Widgets {
+      // Container for the decorations of a screen that don't change: backgrounds, frames, fixed icons... Capture() renders them
+      // once, with the screen background, into a run length encoded copy kept in RAM and hides them. The areas invalidated by the
+      // other objects are then filled from this copy, and these objects are drawn over it, instead of drawing the decorations again.
+      class StaticLayer {
+      public:
+        StaticLayer() = default;
+        ~StaticLayer();
+
+        StaticLayer(const StaticLayer&) = delete;
+        StaticLayer& operator=(const StaticLayer&) = delete;
+
+        // Covers the whole screen, below all its other objects
+        void Create(lv_obj_t* screen);
+
+        // The static objects are created in this container, visible
+        lv_obj_t* GetObject() const {
+          return object;
+        }
+
+        // Renders the children to the cache and hides them. Returns false, and leaves them as they are, if the cache doesn't fit
+        // in the budget.
+        bool Capture(Components::LittleVgl& lvgl);
+        // Shows the children again and frees the cache, they can then be modified
+        void Release();
+
+      private:
+        // The cache starts with the offset of every row, followed by the rows. A row is a sequence of runs: a control byte c < 0x80
+        // is followed by c + 1 literal pixels, and c >= 0x80 by a single pixel repeated c - 0x80 + 2 times.
+        static constexpr size_t budget = 8192;
+        // Heap left in the largest free block while capturing
+        static constexpr size_t heapReserve = 4096;
+        static constexpr size_t rowOffsetsSize = LV_VER_RES_MAX * sizeof(uint16_t);
+        static constexpr uint8_t maxLiterals = 0x80;
+        static constexpr uint8_t maxRepeat = 0xFF - 0x80 + 2;
+        static constexpr size_t maxRowSize = LV_HOR_RES_MAX * sizeof(lv_color_t) + (LV_HOR_RES_MAX + maxLiterals - 1) / maxLiterals;
+        static_assert(budget <= UINT16_MAX, "Row offsets are 16 bits");
+
+        lv_obj_t* object = nullptr;
+        uint8_t* cache = nullptr;
+
+        // Progress of the capture
+        uint8_t* buffer = nullptr;
+        size_t written = 0;
+        lv_coord_t nextRow = 0;
+        bool failed = false;
+
+        void EncodeBand(const lv_area_t* area, const lv_color_t* pixels);
+        void DecodeRow(lv_coord_t y, lv_coord_t x, lv_coord_t length, lv_color_t* pixels) const;
+        static size_t EncodeRow(const lv_color_t* pixels, lv_coord_t length, uint8_t* output);
+        static void Encode(void* context, const lv_area_t* area, const lv_color_t* pixels);
+        static lv_design_res_t Draw(lv_obj_t* obj, const lv_area_t* clipArea, lv_design_mode_t mode);
+      };
+    }
+  }
+}
@@ -1,20 +1,118 @@
 #include "drivers/Spi.h"
 #include <hal/nrf_gpio.h>
 #include <nrfx_log.h>
+#include <nrf_assert.h>
+#include <task.h>
+#include <cstring>
 
 using namespace Pinetime::Drivers;
 
-Spi::Spi(SpiMaster& spiMaster, uint8_t pinCsn) : spiMaster {spiMaster}, pinCsn {pinCsn} {
+Spi::Spi(SpiMaster& spiMaster, uint8_t pinCsn, SpiMaster::Priority priority) : spiMaster {spiMaster}, pinCsn {pinCsn} {
   nrf_gpio_cfg_output(pinCsn);
   nrf_gpio_pin_set(pinCsn);
+
+  transaction.pinCsn = pinCsn;
+  transaction.priority = priority;
+  transaction.transactionCompleteHook = [this]() {
+    OnTransactionComplete();
+  };
+
+  mutex = xSemaphoreCreateBinary();
+  ASSERT(mutex != nullptr);
+  xSemaphoreGive(mutex);
+}
+
+// The blocking wait cannot be used before the scheduler is started (recovery loader), spin on the busy flag instead
+void Spi::Acquire() {
+  if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) {
+    while (busy) {
+    }
+  } else {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+  }
+  busy = true;
+}
+
+void Spi::Release() {
+  busy = false;
+  xSemaphoreGive(mutex);
 }
 
-bool Spi::Write(const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook) {
-  return spiMaster.Write(pinCsn, data, size, preTransactionHook);
+void Spi::Submit() {
+  spiMaster.Submit(&transaction);
+}
+
+void Spi::OnTransactionComplete() {
+  if (userCompleteHook != nullptr) {
+    userCompleteHook();
+  }
+
+  busy = false;
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+  xSemaphoreGiveFromISR(mutex, &xHigherPriorityTaskWoken);
+  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+bool Spi::Write(const uint8_t* data,
+                size_t size,
+                const std::function<void()>& preTransactionHook,
+                const std::function<void()>& transactionCompleteHook) {
+  if (data == nullptr || size == 0) {
+    return false;
+  }
+  Acquire();
+
+  // Command and argument bytes usually live on the stack of the caller or in flash (not reachable by EasyDMA)
+  if (size <= inlineBufferSize) {
+    std::memcpy(inlineBuffer, data, size);
+    data = inlineBuffer;
+  }
+
+  transaction.preTransactionHook = preTransactionHook;
+  transaction.command = data;
+  transaction.commandSize = size;
+  transaction.txData = nullptr;
+  transaction.txDataSize = 0;
+  transaction.rxData = nullptr;
+  transaction.rxDataSize = 0;
+  userCompleteHook = transactionCompleteHook;
+  Submit();
+  return true;
 }
 
 bool Spi::Read(uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize) {
-  return spiMaster.Read(pinCsn, cmd, cmdSize, data, dataSize);
+  Acquire();
+  transaction.preTransactionHook = nullptr;
+  transaction.command = cmd;
+  transaction.commandSize = cmdSize;
+  transaction.txData = nullptr;
+  transaction.txDataSize = 0;
+  transaction.rxData = data;
+  transaction.rxDataSize = dataSize;
+  userCompleteHook = nullptr;
+  Submit();
+
+  // Wait for the end of the transaction
+  Acquire();
+  Release();
+  return true;
+}
+
+bool Spi::WriteCmdAndBuffer(const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize) {
+  Acquire();
+  transaction.preTransactionHook = nullptr;
+  transaction.command = cmd;
+  transaction.commandSize = cmdSize;
+  transaction.txData = data;
+  transaction.txDataSize = dataSize;
+  transaction.rxData = nullptr;
+  transaction.rxDataSize = 0;
+  userCompleteHook = nullptr;
+  Submit();
+
+  Acquire();
+  Release();
+  return true;
 }
 
 void Spi::Sleep() {
@@ -22,10 +120,6 @@ void Spi::Sleep() {
   NRF_LOG_INFO("[SPI] Sleep")
 }
 
-bool Spi::WriteCmdAndBuffer(const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize) {
-  return spiMaster.WriteCmdAndBuffer(pinCsn, cmd, cmdSize, data, dataSize);
-}
-
 bool Spi::Init() {
   nrf_gpio_cfg_output(pinCsn);
   nrf_gpio_pin_set(pinCsn);
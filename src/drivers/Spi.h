@@ -2,28 +2,48 @@
 #include <cstdint>
 #include <cstddef>
 #include <functional>
+#include <FreeRTOS.h>
+#include <semphr.h>
 #include "drivers/SpiMaster.h"
 
 namespace Pinetime {
   namespace Drivers {
     class Spi {
     public:
-      Spi(SpiMaster& spiMaster, uint8_t pinCsn);
+      Spi(SpiMaster& spiMaster, uint8_t pinCsn, SpiMaster::Priority priority);
       Spi(const Spi&) = delete;
       Spi& operator=(const Spi&) = delete;
       Spi(Spi&&) = delete;
       Spi& operator=(Spi&&) = delete;
 
       bool Init();
-      bool Write(const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook);
+      // Queues the write and returns without waiting for the end of the transfer. Writes of up to
+      // inlineBufferSize bytes are copied, larger buffers must stay valid until transactionCompleteHook is called.
+      bool Write(const uint8_t* data,
+                 size_t size,
+                 const std::function<void()>& preTransactionHook,
+                 const std::function<void()>& transactionCompleteHook);
       bool Read(uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize);
       bool WriteCmdAndBuffer(const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize);
       void Sleep();
       void Wakeup();
 
     private:
+      static constexpr size_t inlineBufferSize = 8;
+
+      void Acquire();
+      void Release();
+      void Submit();
+      void OnTransactionComplete();
+
       SpiMaster& spiMaster;
       uint8_t pinCsn;
+      // Each device has a single transaction in flight, the mutex is released by the SPI interrupt handler when it completes
+      SpiMaster::Transaction transaction;
+      std::function<void()> userCompleteHook;
+      SemaphoreHandle_t mutex = nullptr;
+      volatile bool busy = false;
+      uint8_t inlineBuffer[inlineBufferSize];
     };
   }
 }
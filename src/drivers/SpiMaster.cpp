@@ -6,15 +6,15 @@
 
 using namespace Pinetime::Drivers;
 
+namespace {
+  // reinterpret_cast is not constexpr so this is the best we can do
+  NRF_TIMER_Type* const ListCounter = reinterpret_cast<NRF_TIMER_Type*>(NRF_TIMER3_BASE);
+}
+
 SpiMaster::SpiMaster(const SpiMaster::SpiModule spi, const SpiMaster::Parameters& params) : spi {spi}, params {params} {
 }
 
 bool SpiMaster::Init() {
-  if (mutex == nullptr) {
-    mutex = xSemaphoreCreateBinary();
-    ASSERT(mutex != nullptr);
-  }
-
   /* Configure GPIO pins used for pselsck, pselmosi, pselmiso and pselss for SPI0 */
   nrf_gpio_pin_set(params.pinSCK);
   nrf_gpio_cfg_output(params.pinSCK);
@@ -81,79 +81,150 @@ bool SpiMaster::Init() {
   spiBaseAddress->EVENTS_ENDTX = 0;
   spiBaseAddress->EVENTS_END = 0;
 
+  // Transfers are chained from the END interrupt only, STARTED is not needed anymore
   spiBaseAddress->INTENSET = ((unsigned) 1 << (unsigned) 6);
   spiBaseAddress->INTENSET = ((unsigned) 1 << (unsigned) 1);
-  spiBaseAddress->INTENSET = ((unsigned) 1 << (unsigned) 19);
+  spiBaseAddress->INTENCLR = ((unsigned) 1 << (unsigned) 19);
 
   spiBaseAddress->ENABLE = (SPIM_ENABLE_ENABLE_Enabled << SPIM_ENABLE_ENABLE_Pos);
 
   NRFX_IRQ_PRIORITY_SET(SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQn, 2);
   NRFX_IRQ_ENABLE(SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQn);
 
-  xSemaphoreGive(mutex);
+  // TIMER3 counts END events during list transfers
+  ListCounter->TASKS_STOP = 1;
+  ListCounter->MODE = TIMER_MODE_MODE_Counter << TIMER_MODE_MODE_Pos;
+  ListCounter->BITMODE = TIMER_BITMODE_BITMODE_16Bit << TIMER_BITMODE_BITMODE_Pos;
+  ListCounter->EVENTS_COMPARE[0] = 0;
+  ListCounter->EVENTS_COMPARE[1] = 0;
+  ListCounter->INTENSET = TIMER_INTENSET_COMPARE1_Msk;
+  NRFX_IRQ_PRIORITY_SET(TIMER3_IRQn, 2);
+  NRFX_IRQ_ENABLE(TIMER3_IRQn);
+
+  nrf_ppi_channel_endpoint_setup(listRestartPpi,
+                                 static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&spiBaseAddress->EVENTS_END)),
+                                 static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&spiBaseAddress->TASKS_START)));
+  nrf_ppi_channel_endpoint_setup(listCountPpi,
+                                 static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&spiBaseAddress->EVENTS_END)),
+                                 static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&ListCounter->TASKS_COUNT)));
+  nrf_ppi_channel_endpoint_setup(listStopPpi,
+                                 static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&ListCounter->EVENTS_COMPARE[0])),
+                                 nrf_ppi_task_group_disable_address_get(listPpiGroup));
+  nrf_ppi_group_clear(listPpiGroup);
+  nrf_ppi_channel_include_in_group(listRestartPpi, listPpiGroup);
+
   return true;
 }
 
-void SpiMaster::SetupWorkaroundForErratum58() {
-  nrfx_gpiote_pin_t pin = spiBaseAddress->PSEL.SCK;
-  nrfx_gpiote_in_config_t gpioteCfg = {.sense = NRF_GPIOTE_POLARITY_TOGGLE,
-                                       .pull = NRF_GPIO_PIN_NOPULL,
-                                       .is_watcher = false,
-                                       .hi_accuracy = true,
-                                       .skip_gpio_setup = true};
-  if (!workaroundActive) {
-    // Create an event when SCK toggles.
-    APP_ERROR_CHECK(nrfx_gpiote_in_init(pin, &gpioteCfg, NULL));
-    nrfx_gpiote_in_event_enable(pin, false);
-
-    // Stop the spim instance when SCK toggles.
-    nrf_ppi_channel_endpoint_setup(workaroundPpi, nrfx_gpiote_in_event_addr_get(pin), spiBaseAddress->TASKS_STOP);
-    nrf_ppi_channel_enable(workaroundPpi);
+void SpiMaster::Submit(Transaction* transaction) {
+  auto priority = static_cast<uint8_t>(transaction->priority);
+  transaction->next = nullptr;
+
+  taskENTER_CRITICAL();
+  if (queueTail[priority] == nullptr) {
+    queueHead[priority] = transaction;
+  } else {
+    queueTail[priority]->next = transaction;
   }
+  queueTail[priority] = transaction;
 
-  spiBaseAddress->EVENTS_END = 0;
+  if (activeTransaction == nullptr) {
+    StartTransaction(NextTransaction());
+  }
+  taskEXIT_CRITICAL();
+}
 
-  // Disable IRQ
-  spiBaseAddress->INTENCLR = (1 << 6);
-  spiBaseAddress->INTENCLR = (1 << 1);
-  spiBaseAddress->INTENCLR = (1 << 19);
-  workaroundActive = true;
+SpiMaster::Transaction* SpiMaster::NextTransaction() {
+  for (uint8_t priority = 0; priority < nbPriorities; priority++) {
+    Transaction* transaction = queueHead[priority];
+    if (transaction != nullptr) {
+      queueHead[priority] = transaction->next;
+      if (queueHead[priority] == nullptr) {
+        queueTail[priority] = nullptr;
+      }
+      return transaction;
+    }
+  }
+  return nullptr;
 }
 
-void SpiMaster::DisableWorkaroundForErratum58() {
-  nrfx_gpiote_pin_t pin = spiBaseAddress->PSEL.SCK;
-  if (workaroundActive) {
-    nrfx_gpiote_in_uninit(pin);
-    nrf_ppi_channel_disable(workaroundPpi);
+void SpiMaster::StartTransaction(Transaction* transaction) {
+  activeTransaction = transaction;
+  if (transaction == nullptr) {
+    return;
   }
-  spiBaseAddress->EVENTS_END = 0;
 
-  // Enable IRQ
-  spiBaseAddress->INTENSET = (1 << 6);
-  spiBaseAddress->INTENSET = (1 << 1);
-  spiBaseAddress->INTENSET = (1 << 19);
-  workaroundActive = false;
+  if (transaction->preTransactionHook != nullptr) {
+    transaction->preTransactionHook();
+  }
+  nrf_gpio_pin_clear(transaction->pinCsn);
+
+  phase = Phases::Command;
+  StartNextPhase();
+}
+
+// Starts the first non-empty phase of the active transaction, from the current one.
+// Returns false when there is nothing left to transfer.
+bool SpiMaster::StartNextPhase() {
+  while (phase != Phases::Done) {
+    const Transaction* transaction = activeTransaction;
+    switch (phase) {
+      case Phases::Command:
+        currentBufferAddr = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(transaction->command));
+        currentBufferSize = transaction->commandSize;
+        receiving = false;
+        phase = Phases::TxData;
+        break;
+      case Phases::TxData:
+        currentBufferAddr = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(transaction->txData));
+        currentBufferSize = transaction->txDataSize;
+        receiving = false;
+        phase = Phases::RxData;
+        break;
+      case Phases::RxData:
+        currentBufferAddr = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(transaction->rxData));
+        currentBufferSize = transaction->rxDataSize;
+        receiving = true;
+        phase = Phases::Done;
+        break;
+      default:
+        break;
+    }
+
+    if (currentBufferSize > 0) {
+      StartTransfer();
+      return true;
+    }
+  }
+  return false;
 }
 
 void SpiMaster::OnEndEvent() {
-  if (currentBufferAddr == 0) {
+  if (activeTransaction == nullptr) {
     return;
   }
 
-  auto s = currentBufferSize;
-  if (s > 0) {
-    auto currentSize = std::min((size_t) 255, s);
-    PrepareTx(currentBufferAddr, currentSize);
-    currentBufferAddr = currentBufferAddr + currentSize;
-    currentBufferSize = currentBufferSize - currentSize;
+  if (listTransferActive) {
+    DisableListTransfer();
+  }
 
-    spiBaseAddress->TASKS_START = 1;
-  } else {
-    nrf_gpio_pin_set(this->pinCsn);
-    currentBufferAddr = 0;
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    xSemaphoreGiveFromISR(mutex, &xHigherPriorityTaskWoken);
-    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+  if (currentBufferSize > 0) {
+    StartTransfer();
+    return;
+  }
+
+  if (StartNextPhase()) {
+    return;
+  }
+
+  Transaction* completed = activeTransaction;
+  nrf_gpio_pin_set(completed->pinCsn);
+
+  // Chain the next transaction right away, the hook may release the descriptor to its owner
+  StartTransaction(NextTransaction());
+
+  if (completed->transactionCompleteHook != nullptr) {
+    completed->transactionCompleteHook();
   }
 }
 
@@ -180,80 +251,84 @@ void SpiMaster::PrepareRx(const uint32_t bufferAddress, const size_t size) {
   spiBaseAddress->EVENTS_END = 0;
 }
 
-bool SpiMaster::Write(uint8_t pinCsn, const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook) {
-  if (data == nullptr)
-    return false;
-  auto ok = xSemaphoreTake(mutex, portMAX_DELAY);
-  ASSERT(ok == true);
-
-  this->pinCsn = pinCsn;
-
-  if (size == 1) {
-    SetupWorkaroundForErratum58();
-  } else {
-    DisableWorkaroundForErratum58();
+// Starts the transfer of the next part of the current buffer.
+// As many bytes as possible are sent in a single list transfer, the remainder (if any) is sent when it completes.
+void SpiMaster::StartTransfer() {
+  size_t size = std::min(maxTransferSize, static_cast<size_t>(currentBufferSize));
+  size_t chunkSize = size;
+  size_t nbChunks = 1;
+  if (currentBufferSize > maxTransferSize) {
+    chunkSize = ListChunkSize(currentBufferSize);
+    nbChunks = currentBufferSize / chunkSize;
   }
 
-  if (preTransactionHook != nullptr) {
-    preTransactionHook();
+  if (nbChunks > 1) {
+    size = chunkSize * nbChunks;
+    PrepareList(currentBufferAddr, chunkSize, nbChunks);
+  } else if (receiving) {
+    PrepareRx(currentBufferAddr, size);
+  } else {
+    PrepareTx(currentBufferAddr, size);
   }
-  nrf_gpio_pin_clear(this->pinCsn);
-
-  currentBufferAddr = (uint32_t) data;
-  currentBufferSize = size;
-
-  auto currentSize = std::min((size_t) 255, (size_t) currentBufferSize);
-  PrepareTx(currentBufferAddr, currentSize);
-  currentBufferSize = currentBufferSize - currentSize;
-  currentBufferAddr = currentBufferAddr + currentSize;
+  currentBufferAddr = currentBufferAddr + size;
+  currentBufferSize = currentBufferSize - size;
   spiBaseAddress->TASKS_START = 1;
+}
 
-  if (size == 1) {
-    while (spiBaseAddress->EVENTS_END == 0)
-      ;
-    nrf_gpio_pin_set(this->pinCsn);
-    currentBufferAddr = 0;
-
-    DisableWorkaroundForErratum58();
-
-    xSemaphoreGive(mutex);
+// Returns the largest chunk size that evenly divides the buffer, so that it can be sent in a single list transfer.
+// Pixel buffers are always a multiple of the line size, so this usually succeeds.
+size_t SpiMaster::ListChunkSize(size_t size) {
+  for (size_t chunkSize = maxTransferSize; chunkSize >= minListChunkSize; chunkSize--) {
+    if (size % chunkSize == 0) {
+      return chunkSize;
+    }
   }
-
-  return true;
+  return maxTransferSize;
 }
 
-bool SpiMaster::Read(uint8_t pinCsn, uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize) {
-  xSemaphoreTake(mutex, portMAX_DELAY);
-
-  this->pinCsn = pinCsn;
-  DisableWorkaroundForErratum58();
-  spiBaseAddress->INTENCLR = (1 << 6);
-  spiBaseAddress->INTENCLR = (1 << 1);
-  spiBaseAddress->INTENCLR = (1 << 19);
-
-  nrf_gpio_pin_clear(this->pinCsn);
-
-  currentBufferAddr = 0;
-  currentBufferSize = 0;
-
-  PrepareTx((uint32_t) cmd, cmdSize);
-  spiBaseAddress->TASKS_START = 1;
-  while (spiBaseAddress->EVENTS_END == 0)
-    ;
-
-  PrepareRx((uint32_t) data, dataSize);
-  spiBaseAddress->TASKS_START = 1;
+void SpiMaster::PrepareList(uint32_t bufferAddress, size_t chunkSize, size_t nbChunks) {
+  if (receiving) {
+    PrepareRx(bufferAddress, chunkSize);
+    spiBaseAddress->RXD.LIST = SPIM_RXD_LIST_LIST_ArrayList << SPIM_RXD_LIST_LIST_Pos;
+  } else {
+    PrepareTx(bufferAddress, chunkSize);
+    spiBaseAddress->TXD.LIST = SPIM_TXD_LIST_LIST_ArrayList << SPIM_TXD_LIST_LIST_Pos;
+  }
 
-  while (spiBaseAddress->EVENTS_END == 0)
-    ;
-  nrf_gpio_pin_set(this->pinCsn);
+  ListCounter->TASKS_STOP = 1;
+  ListCounter->TASKS_CLEAR = 1;
+  ListCounter->CC[0] = nbChunks - 1;
+  ListCounter->CC[1] = nbChunks;
+  ListCounter->EVENTS_COMPARE[0] = 0;
+  ListCounter->EVENTS_COMPARE[1] = 0;
+  ListCounter->TASKS_START = 1;
 
-  xSemaphoreGive(mutex);
+  // Only the TIMER3 interrupt is needed until the end of the list
+  spiBaseAddress->INTENCLR = (1 << 6);
+  nrf_ppi_channel_enable(listCountPpi);
+  nrf_ppi_channel_enable(listStopPpi);
+  nrf_ppi_group_enable(listPpiGroup);
+  listTransferActive = true;
+}
 
-  return true;
+void SpiMaster::DisableListTransfer() {
+  nrf_ppi_group_disable(listPpiGroup);
+  nrf_ppi_channel_disable(listCountPpi);
+  nrf_ppi_channel_disable(listStopPpi);
+  ListCounter->TASKS_STOP = 1;
+  spiBaseAddress->TXD.LIST = 0;
+  spiBaseAddress->RXD.LIST = 0;
+  spiBaseAddress->EVENTS_END = 0;
+  spiBaseAddress->INTENSET = (1 << 6);
+  listTransferActive = false;
 }
 
 void SpiMaster::Sleep() {
+  // Let queued transactions (e.g. the flash deep power down command) go out first
+  while (activeTransaction != nullptr) {
+    vTaskDelay(1);
+  }
+
   while (spiBaseAddress->ENABLE != 0) {
     spiBaseAddress->ENABLE = (SPIM_ENABLE_ENABLE_Disabled << SPIM_ENABLE_ENABLE_Pos);
   }
@@ -268,34 +343,3 @@ void SpiMaster::Wakeup() {
   Init();
   NRF_LOG_INFO("[SPIMASTER] Wakeup");
 }
-
-bool SpiMaster::WriteCmdAndBuffer(uint8_t pinCsn, const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize) {
-  xSemaphoreTake(mutex, portMAX_DELAY);
-
-  this->pinCsn = pinCsn;
-  DisableWorkaroundForErratum58();
-  spiBaseAddress->INTENCLR = (1 << 6);
-  spiBaseAddress->INTENCLR = (1 << 1);
-  spiBaseAddress->INTENCLR = (1 << 19);
-
-  nrf_gpio_pin_clear(this->pinCsn);
-
-  currentBufferAddr = 0;
-  currentBufferSize = 0;
-
-  PrepareTx((uint32_t) cmd, cmdSize);
-  spiBaseAddress->TASKS_START = 1;
-  while (spiBaseAddress->EVENTS_END == 0)
-    ;
-
-  PrepareTx((uint32_t) data, dataSize);
-  spiBaseAddress->TASKS_START = 1;
-
-  while (spiBaseAddress->EVENTS_END == 0)
-    ;
-  nrf_gpio_pin_set(this->pinCsn);
-
-  xSemaphoreGive(mutex);
-
-  return true;
-}
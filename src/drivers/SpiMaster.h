@@ -17,6 +17,9 @@ namespace Pinetime {
       enum class BitOrder : uint8_t { Msb_Lsb, Lsb_Msb };
       enum class Modes : uint8_t { Mode0, Mode1, Mode2, Mode3 };
       enum class Frequencies : uint8_t { Freq8Mhz };
+      // Transactions are started in priority order, a higher priority transaction
+      // preempts lower priority ones at the next transaction boundary
+      enum class Priority : uint8_t { High, Normal };
 
       struct Parameters {
         BitOrder bitOrder;
@@ -27,6 +30,27 @@ namespace Pinetime {
         uint8_t pinMISO;
       };
 
+      /* Descriptor of a single chip-select cycle on the bus: the command bytes are sent first,
+       * followed by txData, and rxData is received last. Empty phases are skipped.
+       * Buffers must be located in RAM (EasyDMA) and the descriptor and its buffers must stay valid until
+       * transactionCompleteHook is called.
+       * Both hooks are called from the SPI interrupt handler (or from Submit() when the bus is idle for
+       * preTransactionHook), so they must be short and ISR-safe.
+       */
+      struct Transaction {
+        uint8_t pinCsn = 0;
+        Priority priority = Priority::Normal;
+        std::function<void()> preTransactionHook;
+        const uint8_t* command = nullptr;
+        size_t commandSize = 0;
+        const uint8_t* txData = nullptr;
+        size_t txDataSize = 0;
+        uint8_t* rxData = nullptr;
+        size_t rxDataSize = 0;
+        std::function<void()> transactionCompleteHook;
+        Transaction* next = nullptr;
+      };
+
       SpiMaster(const SpiModule spi, const Parameters& params);
       SpiMaster(const SpiMaster&) = delete;
       SpiMaster& operator=(const SpiMaster&) = delete;
@@ -34,34 +58,55 @@ namespace Pinetime {
       SpiMaster& operator=(SpiMaster&&) = delete;
 
       bool Init();
-      bool Write(uint8_t pinCsn, const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook);
-      bool Read(uint8_t pinCsn, uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize);
-
-      bool WriteCmdAndBuffer(uint8_t pinCsn, const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize);
+      // Queues the transaction and returns immediately. At least one phase must be non-empty.
+      void Submit(Transaction* transaction);
 
       void OnStartedEvent();
+      // Called from the SPIM END interrupt, and from the TIMER3 COMPARE[1] interrupt at the end of a list transfer
       void OnEndEvent();
 
       void Sleep();
       void Wakeup();
 
     private:
-      void SetupWorkaroundForErratum58();
-      void DisableWorkaroundForErratum58();
-      void PrepareTx(const volatile uint32_t bufferAddress, const volatile size_t size);
-      void PrepareRx(const volatile uint32_t bufferAddress, const volatile size_t size);
+      enum class Phases : uint8_t { Command, TxData, RxData, Done };
+
+      void PrepareTx(uint32_t bufferAddress, size_t size);
+      void PrepareRx(uint32_t bufferAddress, size_t size);
+      Transaction* NextTransaction();
+      void StartTransaction(Transaction* transaction);
+      bool StartNextPhase();
+      void StartTransfer();
+      void PrepareList(uint32_t bufferAddress, size_t chunkSize, size_t nbChunks);
+      void DisableListTransfer();
+      static size_t ListChunkSize(size_t size);
 
       NRF_SPIM_Type* spiBaseAddress;
-      uint8_t pinCsn;
 
       SpiMaster::SpiModule spi;
       SpiMaster::Parameters params;
 
+      static constexpr uint8_t nbPriorities = 2;
+      Transaction* queueHead[nbPriorities] = {};
+      Transaction* queueTail[nbPriorities] = {};
+      Transaction* volatile activeTransaction = nullptr;
+      Phases phase = Phases::Done;
+      bool receiving = false;
+
       volatile uint32_t currentBufferAddr = 0;
       volatile size_t currentBufferSize = 0;
-      SemaphoreHandle_t mutex = nullptr;
-      static constexpr nrf_ppi_channel_t workaroundPpi = NRF_PPI_CHANNEL0;
-      bool workaroundActive = false;
+
+      // EasyDMA can transfer at most 255 bytes at once. Larger buffers are sent in ArrayList mode:
+      // the END event restarts the SPIM (through a PPI group) and is counted by TIMER3. After the
+      // second to last chunk, the group is disabled, and the last END raises a single interrupt.
+      static constexpr size_t maxTransferSize = 255;
+      static constexpr size_t minListChunkSize = 128;
+      // PPI 1 and 2 are used by BrightnessController, 4, 5 and 17+ are reserved by NimBLE
+      static constexpr nrf_ppi_channel_t listRestartPpi = NRF_PPI_CHANNEL3;
+      static constexpr nrf_ppi_channel_t listCountPpi = NRF_PPI_CHANNEL6;
+      static constexpr nrf_ppi_channel_t listStopPpi = NRF_PPI_CHANNEL7;
+      static constexpr nrf_ppi_channel_group_t listPpiGroup = NRF_PPI_CHANNEL_GROUP0;
+      bool listTransferActive = false;
     };
   }
 }
@@ -2,11 +2,23 @@
 #include <hal/nrf_gpio.h>
 #include <libraries/delay/nrf_delay.h>
 #include <libraries/log/nrf_log.h>
+#include <nrf_assert.h>
+#include <cstring>
 #include "drivers/Spi.h"
 
 using namespace Pinetime::Drivers;
 
+namespace {
+  void AsyncTimerCallback(TimerHandle_t xTimer) {
+    auto* flash = static_cast<SpiNorFlash*>(pvTimerGetTimerID(xTimer));
+    flash->OnAsyncTimer();
+  }
+}
+
 SpiNorFlash::SpiNorFlash(Spi& spi) : spi {spi} {
+  mutex = xSemaphoreCreateMutex();
+  ASSERT(mutex != nullptr);
+  asyncTimer = xTimerCreate("flash", 1, pdFALSE, this, AsyncTimerCallback);
 }
 
 void SpiNorFlash::Init() {
@@ -21,8 +33,19 @@ void SpiNorFlash::Uninit() {
 }
 
 void SpiNorFlash::Sleep() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  // The asynchronous operation doesn't start its next step until Wakeup()
+  asyncPaused = true;
+  // The flash ignores the deep power down command while an erase or a program is in progress: only the current
+  // step is waited for, not the rest of the asynchronous operation
+  while (operation != Operations::None) {
+    xSemaphoreGive(mutex);
+    vTaskDelay(1);
+    xSemaphoreTake(mutex, portMAX_DELAY);
+  }
   auto cmd = static_cast<uint8_t>(Commands::DeepPowerDown);
-  spi.Write(&cmd, sizeof(uint8_t), nullptr);
+  spi.Write(&cmd, sizeof(uint8_t), nullptr, nullptr);
+  xSemaphoreGive(mutex);
   NRF_LOG_INFO("[SpiNorFlash] Sleep")
 }
 
@@ -38,6 +61,13 @@ void SpiNorFlash::Wakeup() {
   } else {
     NRF_LOG_INFO("[SpiNorFlash] ID on Wakeup: %d", id);
   }
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  InvalidateReadAhead();
+  asyncPaused = false;
+  if (asyncRunning) {
+    xTimerStart(asyncTimer, 0);
+  }
+  xSemaphoreGive(mutex);
   NRF_LOG_INFO("[SpiNorFlash] Wakeup")
 }
 
@@ -71,34 +101,190 @@ uint8_t SpiNorFlash::ReadConfigurationRegister() {
 }
 
 void SpiNorFlash::Read(uint32_t address, uint8_t* buffer, size_t size) {
-  static constexpr uint8_t cmdSize = 4;
-  uint8_t cmd[cmdSize] = {static_cast<uint8_t>(Commands::Read),
+  TakeMutexToSuspend();
+  bool suspended = Suspend();
+
+  if (size >= readAheadSize || operation != Operations::None) {
+    // Large reads go straight to the destination buffer. So do the reads during an erase or a program: the range
+    // being modified must not end up in the read-ahead buffer.
+    FastRead(address, buffer, size);
+  } else {
+    if (address < readAheadAddress || (address + size) > (readAheadAddress + readAheadCount)) {
+      FastRead(address, readAheadBuffer, readAheadSize);
+      readAheadAddress = address;
+      readAheadCount = readAheadSize;
+    }
+    std::memcpy(buffer, readAheadBuffer + (address - readAheadAddress), size);
+  }
+
+  if (suspended) {
+    Resume();
+  }
+  xSemaphoreGive(mutex);
+}
+
+void SpiNorFlash::FastRead(uint32_t address, uint8_t* buffer, size_t size) {
+  // Fast Read needs a dummy byte after the address
+  static constexpr uint8_t cmdSize = 5;
+  uint8_t cmd[cmdSize] = {static_cast<uint8_t>(Commands::FastRead),
                           static_cast<uint8_t>(address >> 16U),
                           static_cast<uint8_t>(address >> 8U),
-                          static_cast<uint8_t>(address)};
+                          static_cast<uint8_t>(address),
+                          0x00};
   spi.Read(reinterpret_cast<uint8_t*>(&cmd), cmdSize, buffer, size);
 }
 
+void SpiNorFlash::InvalidateReadAhead() {
+  readAheadCount = 0;
+}
+
+// Takes the mutex, once an erase in progress may be suspended again. The erase must progress between two suspends,
+// back to back reads or programs would stall it otherwise: the mutex is not held while waiting for the next tick.
+void SpiNorFlash::TakeMutexToSuspend() {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  while (operation == Operations::Erase && xTaskGetTickCount() == lastResume) {
+    xSemaphoreGive(mutex);
+    vTaskDelay(1);
+    xSemaphoreTake(mutex, portMAX_DELAY);
+  }
+}
+
+// Makes the array readable. An erase is suspended (returns true), a page program is short enough to wait for.
+// Must be called with the mutex held.
+bool SpiNorFlash::Suspend() {
+  if (operation == Operations::None || !WriteInProgress()) {
+    return false;
+  }
+
+  if (operation == Operations::Program) {
+    while (WriteInProgress()) {
+    }
+    return false;
+  }
+
+  auto cmd = static_cast<uint8_t>(Commands::Suspend);
+  spi.Read(&cmd, sizeof(cmd), nullptr, 0);
+  // The suspend latency is a few tens of microseconds
+  while (WriteInProgress()) {
+  }
+  return true;
+}
+
+void SpiNorFlash::Resume() {
+  auto cmd = static_cast<uint8_t>(Commands::Resume);
+  spi.Read(&cmd, sizeof(cmd), nullptr, 0);
+  lastResume = xTaskGetTickCount();
+}
+
 void SpiNorFlash::WriteEnable() {
   auto cmd = static_cast<uint8_t>(Commands::WriteEnable);
   spi.Read(&cmd, sizeof(cmd), nullptr, 0);
 }
 
-void SpiNorFlash::SectorErase(uint32_t sectorAddress) {
-  static constexpr uint8_t cmdSize = 4;
-  uint8_t cmd[cmdSize] = {static_cast<uint8_t>(Commands::SectorErase),
-                          static_cast<uint8_t>(sectorAddress >> 16U),
-                          static_cast<uint8_t>(sectorAddress >> 8U),
-                          static_cast<uint8_t>(sectorAddress)};
-
+// Sends Write Enable, returns false if the flash didn't latch it yet
+bool SpiNorFlash::TryWriteEnable() {
   WriteEnable();
-  while (!WriteEnabled())
+  return WriteEnabled();
+}
+
+// Waits for the end of the running erase/program (if any), reserves the flash for a new one and latches Write Enable.
+// Returns with the mutex held. The mutex is released while waiting, so that other tasks can read in the meantime.
+// The asynchronous operation doesn't start its next step while an operation waits here.
+void SpiNorFlash::AcquireOperation(Operations newOperation) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  waitingOperations++;
+  while (operation != Operations::None || !TryWriteEnable()) {
+    xSemaphoreGive(mutex);
     vTaskDelay(1);
+    xSemaphoreTake(mutex, portMAX_DELAY);
+  }
+  waitingOperations--;
+  operation = newOperation;
+}
 
-  spi.Read(reinterpret_cast<uint8_t*>(&cmd), cmdSize, nullptr, 0);
+// Must be called with the mutex held, releases it
+void SpiNorFlash::ReleaseOperation() {
+  InvalidateReadAhead();
+  operation = Operations::None;
+  xSemaphoreGive(mutex);
+}
 
-  while (WriteInProgress())
+// Polls the status register until the current command is done. The mutex is only held while polling
+// so that other tasks can read (and suspend an erase) in the meantime.
+void SpiNorFlash::WaitWhileBusy() {
+  while (true) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    bool busy = WriteInProgress();
+    xSemaphoreGive(mutex);
+    if (!busy) {
+      return;
+    }
     vTaskDelay(1);
+  }
+}
+
+// Starts the erase of the largest block that starts at address and fits in size. Returns the size of that block.
+// Must be called with the mutex held, after Write Enable is latched.
+size_t SpiNorFlash::StartErase(uint32_t address, size_t size) {
+  auto command = Commands::SectorErase;
+  size_t eraseSize = sectorSize;
+  if ((address % blockSize64K) == 0 && size >= blockSize64K) {
+    command = Commands::BlockErase64K;
+    eraseSize = blockSize64K;
+  } else if ((address % blockSize32K) == 0 && size >= blockSize32K) {
+    command = Commands::BlockErase32K;
+    eraseSize = blockSize32K;
+  }
+
+  static constexpr uint8_t cmdSize = 4;
+  uint8_t cmd[cmdSize] = {static_cast<uint8_t>(command),
+                          static_cast<uint8_t>(address >> 16U),
+                          static_cast<uint8_t>(address >> 8U),
+                          static_cast<uint8_t>(address)};
+
+  InvalidateReadAhead();
+  spi.Read(reinterpret_cast<uint8_t*>(&cmd), cmdSize, nullptr, 0);
+  erasingAddress = address;
+  erasingSize = eraseSize;
+  return eraseSize;
+}
+
+// Starts programming the part of buffer that fits in the page containing address. Returns the number of bytes.
+// Must be called with the mutex held, after Write Enable is latched.
+size_t SpiNorFlash::StartPageProgram(uint32_t address, const uint8_t* buffer, size_t size) {
+  static constexpr uint8_t cmdSize = 4;
+
+  uint32_t pageLimit = (address & ~(pageSize - 1u)) + pageSize;
+  uint32_t toWrite = pageLimit - address > size ? size : pageLimit - address;
+
+  uint8_t cmd[cmdSize] = {static_cast<uint8_t>(Commands::PageProgram),
+                          static_cast<uint8_t>(address >> 16U),
+                          static_cast<uint8_t>(address >> 8U),
+                          static_cast<uint8_t>(address)};
+
+  InvalidateReadAhead();
+  spi.WriteCmdAndBuffer(cmd, cmdSize, buffer, toWrite);
+  return toWrite;
+}
+
+void SpiNorFlash::SectorErase(uint32_t sectorAddress) {
+  Erase(sectorAddress, sectorSize);
+}
+
+void SpiNorFlash::Erase(uint32_t address, size_t size) {
+  while (size > 0) {
+    AcquireOperation(Operations::Erase);
+    size_t erased = StartErase(address, size);
+    xSemaphoreGive(mutex);
+
+    WaitWhileBusy();
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    ReleaseOperation();
+
+    address += erased;
+    size -= (erased < size) ? erased : size;
+  }
 }
 
 uint8_t SpiNorFlash::ReadSecurityRegister() {
@@ -117,32 +303,140 @@ bool SpiNorFlash::EraseFailed() {
 }
 
 void SpiNorFlash::Write(uint32_t address, const uint8_t* buffer, size_t size) {
-  static constexpr uint8_t cmdSize = 4;
-
   size_t len = size;
   uint32_t addr = address;
   const uint8_t* b = buffer;
   while (len > 0) {
-    uint32_t pageLimit = (addr & ~(pageSize - 1u)) + pageSize;
-    uint32_t toWrite = pageLimit - addr > len ? len : pageLimit - addr;
+    size_t written = ProgramDuringErase(addr, b, len);
+    if (written == 0) {
+      AcquireOperation(Operations::Program);
+      written = StartPageProgram(addr, b, len);
+      xSemaphoreGive(mutex);
 
-    uint8_t cmd[cmdSize] = {static_cast<uint8_t>(Commands::PageProgram),
-                            static_cast<uint8_t>(addr >> 16U),
-                            static_cast<uint8_t>(addr >> 8U),
-                            static_cast<uint8_t>(addr)};
+      WaitWhileBusy();
 
-    WriteEnable();
-    while (!WriteEnabled())
-      vTaskDelay(1);
+      xSemaphoreTake(mutex, portMAX_DELAY);
+      ReleaseOperation();
+    }
 
-    spi.WriteCmdAndBuffer(cmd, cmdSize, b, toWrite);
+    addr += written;
+    b += written;
+    len -= written;
+  }
+}
+
+// Programs the part of buffer that fits in the page containing address while the erase in progress is suspended, the
+// way Read() does, instead of waiting for the end of the erase. Returns the number of bytes, 0 if no erase of another
+// block is in progress.
+size_t SpiNorFlash::ProgramDuringErase(uint32_t address, const uint8_t* buffer, size_t size) {
+  TakeMutexToSuspend();
+  size_t written = 0;
+  bool erasingPage = address >= erasingAddress && address < erasingAddress + erasingSize;
+  if (operation == Operations::Erase && !erasingPage && Suspend()) {
+    if (TryWriteEnable()) {
+      written = StartPageProgram(address, buffer, size);
+      // A page program takes about a millisecond, the erase is resumed as soon as it is done
+      while (WriteInProgress()) {
+      }
+    }
+    Resume();
+  }
+  xSemaphoreGive(mutex);
+  return written;
+}
+
+bool SpiNorFlash::EraseAsync(uint32_t address, size_t size, const CompletionCallback& completed) {
+  return StartAsync(Operations::Erase, address, nullptr, size, completed);
+}
+
+bool SpiNorFlash::WriteAsync(uint32_t address, const uint8_t* buffer, size_t size, const CompletionCallback& completed) {
+  return StartAsync(Operations::Program, address, buffer, size, completed);
+}
+
+bool SpiNorFlash::StartAsync(Operations newOperation,
+                             uint32_t address,
+                             const uint8_t* buffer,
+                             size_t size,
+                             const CompletionCallback& completed) {
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  if (asyncRunning || size == 0) {
+    xSemaphoreGive(mutex);
+    return false;
+  }
+  asyncRunning = true;
+  asyncOperation = newOperation;
+  asyncStepRunning = false;
+  asyncAddress = address;
+  asyncBuffer = buffer;
+  asyncRemaining = size;
+  asyncCompleted = completed;
+  StartAsyncStep();
+  xSemaphoreGive(mutex);
+  return true;
+}
+
+bool SpiNorFlash::IsBusy() const {
+  return asyncRunning;
+}
+
+// Sends the next erase or page program command of the asynchronous operation if the flash is free, and nothing waits
+// for it. The flash is only reserved for the duration of a step: synchronous operations and Sleep() get it in between.
+// Must be called with the mutex held. This runs in the timer task, which must not wait: if the step can't start, it is
+// retried on the next tick.
+void SpiNorFlash::StartAsyncStep() {
+  if (asyncPaused) {
+    // Wakeup() restarts the timer
+    return;
+  }
+  if (operation == Operations::None && waitingOperations == 0 && TryWriteEnable()) {
+    operation = asyncOperation;
+    asyncStepRunning = true;
+    size_t done;
+    if (operation == Operations::Erase) {
+      done = StartErase(asyncAddress, asyncRemaining);
+    } else {
+      done = StartPageProgram(asyncAddress, asyncBuffer, asyncRemaining);
+      asyncBuffer += done;
+    }
+    asyncAddress += done;
+    asyncRemaining -= (done < asyncRemaining) ? done : asyncRemaining;
+  }
+  xTimerStart(asyncTimer, 0);
+}
+
+void SpiNorFlash::OnAsyncTimer() {
+  // Another task is reading the flash: poll again on the next tick instead of blocking the timer task
+  if (xSemaphoreTake(mutex, 0) == pdFALSE) {
+    xTimerStart(asyncTimer, 0);
+    return;
+  }
+
+  bool failed = false;
+  if (asyncStepRunning) {
+    if (WriteInProgress()) {
+      xSemaphoreGive(mutex);
+      xTimerStart(asyncTimer, 0);
+      return;
+    }
+    failed = (asyncOperation == Operations::Erase) ? EraseFailed() : ProgramFailed();
+    asyncStepRunning = false;
+    InvalidateReadAhead();
+    operation = Operations::None;
+  }
+
+  if (!failed && asyncRemaining > 0) {
+    StartAsyncStep();
+    xSemaphoreGive(mutex);
+    return;
+  }
 
-    while (WriteInProgress())
-      vTaskDelay(1);
+  CompletionCallback completed = std::move(asyncCompleted);
+  asyncCompleted = nullptr;
+  asyncRunning = false;
+  xSemaphoreGive(mutex);
 
-    addr += toWrite;
-    b += toWrite;
-    len -= toWrite;
+  if (completed != nullptr) {
+    completed(!failed);
   }
 }
 
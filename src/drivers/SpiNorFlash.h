@@ -1,6 +1,10 @@
 #pragma once
 #include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <FreeRTOS.h>
+#include <semphr.h>
+#include <timers.h>
 
 namespace Pinetime {
   namespace Drivers {
@@ -20,18 +24,37 @@ namespace Pinetime {
         uint8_t density = 0;
       };
 
+      // Called from the timer task at the end of an asynchronous operation, success is false if the flash reported an error.
+      // It must not block: the timer task also runs the other software timers.
+      using CompletionCallback = std::function<void(bool success)>;
+
+      static constexpr uint32_t sectorSize = 0x1000;
+
       uint8_t ReadStatusRegister();
       bool WriteInProgress();
       bool WriteEnabled();
       uint8_t ReadConfigurationRegister();
+      // Reads can be issued during an erase: the erase is suspended while the data is read
       void Read(uint32_t address, uint8_t* buffer, size_t size);
+      // So can writes outside of the block being erased
       void Write(uint32_t address, const uint8_t* buffer, size_t size);
       void WriteEnable();
       void SectorErase(uint32_t sectorAddress);
+      // Erases [address, address + size), aligned on sectorSize, with 64KB/32KB block erases where possible
+      void Erase(uint32_t address, size_t size);
       uint8_t ReadSecurityRegister();
       bool ProgramFailed();
       bool EraseFailed();
 
+      // Asynchronous versions of Erase() and Write(): they return as soon as the first command is sent, and
+      // completed is called when the whole range is done. The buffer must stay valid until then.
+      // Return false if another asynchronous operation is still running.
+      // The flash is only held for one block erase or page program at a time: the synchronous operations
+      // don't wait for the whole range, and Sleep() pauses the operation until Wakeup().
+      bool EraseAsync(uint32_t address, size_t size, const CompletionCallback& completed);
+      bool WriteAsync(uint32_t address, const uint8_t* buffer, size_t size, const CompletionCallback& completed);
+      bool IsBusy() const;
+
       Identification GetIdentification() const;
 
       void Init();
@@ -40,25 +63,83 @@ namespace Pinetime {
       void Sleep();
       void Wakeup();
 
+      void OnAsyncTimer();
+
     private:
+      enum class Operations : uint8_t { None, Erase, Program };
+
       Identification ReadIdentification();
+      void FastRead(uint32_t address, uint8_t* buffer, size_t size);
+      void InvalidateReadAhead();
+      bool TryWriteEnable();
+      void TakeMutexToSuspend();
+      bool Suspend();
+      void Resume();
+      void AcquireOperation(Operations newOperation);
+      void ReleaseOperation();
+      void WaitWhileBusy();
+      size_t StartErase(uint32_t address, size_t size);
+      size_t StartPageProgram(uint32_t address, const uint8_t* buffer, size_t size);
+      size_t ProgramDuringErase(uint32_t address, const uint8_t* buffer, size_t size);
+      bool StartAsync(Operations newOperation,
+                      uint32_t address,
+                      const uint8_t* buffer,
+                      size_t size,
+                      const CompletionCallback& completed);
+      void StartAsyncStep();
 
       enum class Commands : uint8_t {
         PageProgram = 0x02,
         Read = 0x03,
         ReadStatusRegister = 0x05,
         WriteEnable = 0x06,
+        FastRead = 0x0B,
         ReadConfigurationRegister = 0x15,
         SectorErase = 0x20,
         ReadSecurityRegister = 0x2B,
+        BlockErase32K = 0x52,
+        Suspend = 0x75,
+        Resume = 0x7A,
         ReadIdentification = 0x9F,
         ReleaseFromDeepPowerDown = 0xAB,
-        DeepPowerDown = 0xB9
+        DeepPowerDown = 0xB9,
+        BlockErase64K = 0xD8
       };
       static constexpr uint16_t pageSize = 256;
+      static constexpr uint32_t blockSize32K = 0x8000;
+      static constexpr uint32_t blockSize64K = 0x10000;
 
       Spi& spi;
       Identification device_id;
+
+      // Protects the command sequences and the read-ahead buffer, the flash is used from several tasks
+      SemaphoreHandle_t mutex = nullptr;
+      // Erase or program in progress (synchronous or a step of the asynchronous operation), only one at a time
+      volatile Operations operation = Operations::None;
+      // Range of the last erase command
+      uint32_t erasingAddress = 0;
+      size_t erasingSize = 0;
+      TickType_t lastResume = 0;
+      // Synchronous operations waiting for the flash
+      uint8_t waitingOperations = 0;
+
+      // State of the asynchronous operation, polled by asyncTimer
+      TimerHandle_t asyncTimer = nullptr;
+      bool asyncRunning = false;
+      bool asyncPaused = false;
+      bool asyncStepRunning = false;
+      Operations asyncOperation = Operations::None;
+      uint32_t asyncAddress = 0;
+      const uint8_t* asyncBuffer = nullptr;
+      size_t asyncRemaining = 0;
+      CompletionCallback asyncCompleted;
+
+      // Small reads (littlefs reads 16 bytes at a time) are served from a buffer filled with a single
+      // burst starting at the requested address, so sequential reads only cost one transaction per burst.
+      static constexpr size_t readAheadSize = 256;
+      uint8_t readAheadBuffer[readAheadSize];
+      uint32_t readAheadAddress = 0;
+      size_t readAheadCount = 0;
     };
   }
 }
@@ -1,4 +1,3 @@
-#include <cstring>
 #include "drivers/St7789.h"
 #include <hal/nrf_gpio.h>
 #include <nrfx_log.h>
@@ -18,7 +17,7 @@ void St7789::Init() {
   SoftwareReset();
   Command2Enable();
   SleepOut();
-  PixelFormat();
+  SetPixelFormat(PixelFormats::Rgb565);
   MemoryDataAccessControl();
   SetAddrWindow(0, 0, Width, Height);
 // P8B Mirrored version does not need display inversion.
@@ -40,9 +39,17 @@ void St7789::WriteData(uint8_t data) {
 }
 
 void St7789::WriteData(const uint8_t* data, size_t size) {
-  WriteSpi(data, size, [pinDataCommand = pinDataCommand]() {
-    nrf_gpio_pin_set(pinDataCommand);
-  });
+  WriteData(data, size, nullptr);
+}
+
+void St7789::WriteData(const uint8_t* data, size_t size, const std::function<void()>& transactionCompleteHook) {
+  WriteSpi(
+    data,
+    size,
+    [pinDataCommand = pinDataCommand]() {
+      nrf_gpio_pin_set(pinDataCommand);
+    },
+    transactionCompleteHook);
 }
 
 void St7789::WriteCommand(uint8_t data) {
@@ -50,18 +57,28 @@ void St7789::WriteCommand(uint8_t data) {
 }
 
 void St7789::WriteCommand(const uint8_t* data, size_t size) {
-  WriteSpi(data, size, [pinDataCommand = pinDataCommand]() {
-    nrf_gpio_pin_clear(pinDataCommand);
-  });
+  statistics.commands++;
+  WriteSpi(
+    data,
+    size,
+    [pinDataCommand = pinDataCommand]() {
+      nrf_gpio_pin_clear(pinDataCommand);
+    },
+    nullptr);
 }
 
-void St7789::WriteSpi(const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook) {
-  spi.Write(data, size, preTransactionHook);
+void St7789::WriteSpi(const uint8_t* data,
+                      size_t size,
+                      const std::function<void()>& preTransactionHook,
+                      const std::function<void()>& transactionCompleteHook) {
+  statistics.bytes += size;
+  spi.Write(data, size, preTransactionHook, transactionCompleteHook);
 }
 
 void St7789::SoftwareReset() {
   EnsureSleepOutPostDelay();
   WriteCommand(static_cast<uint8_t>(Commands::SoftwareReset));
+  windowValid = false;
   // If sleep in: must wait 120ms before sleep out can sent (see driver datasheet)
   // Unconditionally wait as software reset doesn't need to be performant
   sleepIn = true;
@@ -114,10 +131,16 @@ void St7789::SleepIn() {
   sleepIn = true;
 }
 
-void St7789::PixelFormat() {
+void St7789::SetPixelFormat(PixelFormats format) {
   WriteCommand(static_cast<uint8_t>(Commands::PixelFormat));
-  // 65K colours, 16-bit per pixel
-  WriteData(0x55);
+  if (format == PixelFormats::Rgb444) {
+    // 4K colours, 12-bit per pixel
+    WriteData(0x53);
+  } else {
+    // 65K colours, 16-bit per pixel
+    WriteData(0x55);
+  }
+  pixelFormat = format;
 }
 
 void St7789::MemoryDataAccessControl() {
@@ -217,29 +240,44 @@ void St7789::GateControl() {
 }
 
 void St7789::SetAddrWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
-  WriteCommand(static_cast<uint8_t>(Commands::ColumnAddressSet));
-  uint8_t colArgs[] = {
-    static_cast<uint8_t>(x0 >> 8), // x start MSB
-    static_cast<uint8_t>(x0),      // x start LSB
-    static_cast<uint8_t>(x1 >> 8), // x end MSB
-    static_cast<uint8_t>(x1)       // x end LSB
-  };
-  WriteData(colArgs, sizeof(colArgs));
-
-  WriteCommand(static_cast<uint8_t>(Commands::RowAddressSet));
-  uint8_t rowArgs[] = {
-    static_cast<uint8_t>(y0 >> 8), // y start MSB
-    static_cast<uint8_t>(y0),      // y start LSB
-    static_cast<uint8_t>(y1 >> 8), // y end MSB
-    static_cast<uint8_t>(y1)       // y end LSB
-  };
-  memcpy(addrWindowArgs, rowArgs, sizeof(rowArgs));
-  WriteData(addrWindowArgs, sizeof(addrWindowArgs));
+  // The window is kept by the controller across RAMWR commands, so only send the parts that changed.
+  // Consecutive bands of a full width refresh only need a new RASET.
+  if (!windowValid || x0 != windowX0 || x1 != windowX1) {
+    WriteCommand(static_cast<uint8_t>(Commands::ColumnAddressSet));
+    uint8_t colArgs[] = {
+      static_cast<uint8_t>(x0 >> 8), // x start MSB
+      static_cast<uint8_t>(x0),      // x start LSB
+      static_cast<uint8_t>(x1 >> 8), // x end MSB
+      static_cast<uint8_t>(x1)       // x end LSB
+    };
+    WriteData(colArgs, sizeof(colArgs));
+    windowX0 = x0;
+    windowX1 = x1;
+  } else {
+    statistics.skippedCommands++;
+  }
+
+  if (!windowValid || y0 != windowY0 || y1 != windowY1) {
+    WriteCommand(static_cast<uint8_t>(Commands::RowAddressSet));
+    uint8_t rowArgs[] = {
+      static_cast<uint8_t>(y0 >> 8), // y start MSB
+      static_cast<uint8_t>(y0),      // y start LSB
+      static_cast<uint8_t>(y1 >> 8), // y end MSB
+      static_cast<uint8_t>(y1)       // y end LSB
+    };
+    WriteData(rowArgs, sizeof(rowArgs));
+    windowY0 = y0;
+    windowY1 = y1;
+  } else {
+    statistics.skippedCommands++;
+  }
+
+  windowValid = true;
 }
 
-void St7789::WriteToRam(const uint8_t* data, size_t size) {
+void St7789::WriteToRam(const uint8_t* data, size_t size, const std::function<void()>& transferCompleteCallback) {
   WriteCommand(static_cast<uint8_t>(Commands::WriteToRam));
-  WriteData(data, size);
+  WriteData(data, size, transferCompleteCallback);
 }
 
 void St7789::SetVdv() {
@@ -260,22 +298,29 @@ void St7789::VerticalScrollStartAddress(uint16_t line) {
     static_cast<uint8_t>(line >> 8), // Frame memory line pointer MSB
     static_cast<uint8_t>(line)       // Frame memory line pointer LSB
   };
-  memcpy(verticalScrollArgs, args, sizeof(args));
-  WriteData(verticalScrollArgs, sizeof(verticalScrollArgs));
+  WriteData(args, sizeof(args));
 }
 
 void St7789::Uninit() {
 }
 
-void St7789::DrawBuffer(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* data, size_t size) {
+void St7789::DrawBuffer(uint16_t x,
+                        uint16_t y,
+                        uint16_t width,
+                        uint16_t height,
+                        const uint8_t* data,
+                        size_t size,
+                        const std::function<void()>& transferCompleteCallback) {
+  statistics.areas++;
   SetAddrWindow(x, y, x + width - 1, y + height - 1);
-  WriteToRam(data, size);
+  WriteToRam(data, size, transferCompleteCallback);
 }
 
 void St7789::HardwareReset() {
   nrf_gpio_pin_clear(pinReset);
   vTaskDelay(pdMS_TO_TICKS(1));
   nrf_gpio_pin_set(pinReset);
+  windowValid = false;
   // If hardware reset started while sleep out, reset time may be up to 120ms
   // Unconditionally wait as hardware reset doesn't need to be performant
   sleepIn = true;
@@ -286,12 +331,15 @@ void St7789::HardwareReset() {
 void St7789::LowPowerOn() {
   IdleModeOn();
   IdleFrameRateOn();
+  // The frame memory keeps its content, only the pixels written from now on use 12 bits
+  SetPixelFormat(PixelFormats::Rgb444);
   NRF_LOG_INFO("[LCD] Low power mode");
 }
 
 void St7789::LowPowerOff() {
   IdleModeOff();
   IdleFrameRateOff();
+  SetPixelFormat(PixelFormats::Rgb565);
   NRF_LOG_INFO("[LCD] Normal power mode");
 }
 
@@ -11,6 +11,17 @@ namespace Pinetime {
 
     class St7789 {
     public:
+      // Rgb444 packs 2 pixels in 3 bytes (R1G1 B1R2 G2B2), used in low power mode where the panel only shows 8 colours
+      enum class PixelFormats : uint8_t { Rgb565, Rgb444 };
+
+      // Running totals since boot, used to measure the cost of partial refreshes
+      struct Statistics {
+        uint32_t areas = 0;
+        uint32_t bytes = 0;
+        uint32_t commands = 0;
+        uint32_t skippedCommands = 0;
+      };
+
       explicit St7789(Spi& spi, uint8_t pinDataCommand, uint8_t pinReset);
       St7789(const St7789&) = delete;
       St7789& operator=(const St7789&) = delete;
@@ -22,7 +33,24 @@ namespace Pinetime {
 
       void VerticalScrollStartAddress(uint16_t line);
 
-      void DrawBuffer(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t* data, size_t size);
+      // Returns as soon as the pixel data transfer is started. transferCompleteCallback is called from
+      // the SPI interrupt handler once data has been sent and can be reused.
+      void DrawBuffer(uint16_t x,
+                      uint16_t y,
+                      uint16_t width,
+                      uint16_t height,
+                      const uint8_t* data,
+                      size_t size,
+                      const std::function<void()>& transferCompleteCallback);
+
+      const Statistics& GetStatistics() const {
+        return statistics;
+      }
+
+      // Format of the pixel data expected by DrawBuffer()
+      PixelFormats GetPixelFormat() const {
+        return pixelFormat;
+      }
 
       void LowPowerOn();
       void LowPowerOff();
@@ -43,11 +71,11 @@ namespace Pinetime {
       void SleepOut();
       void EnsureSleepOutPostDelay();
       void SleepIn();
-      void PixelFormat();
+      void SetPixelFormat(PixelFormats format);
       void MemoryDataAccessControl();
       void DisplayInversionOn();
       void NormalModeOn();
-      void WriteToRam(const uint8_t* data, size_t size);
+      void WriteToRam(const uint8_t* data, size_t size, const std::function<void()>& transferCompleteCallback);
       void IdleModeOn();
       void IdleModeOff();
       void FrameRateNormalSet();
@@ -63,7 +91,10 @@ namespace Pinetime {
       void SetVdv();
       void WriteCommand(uint8_t cmd);
       void WriteCommand(const uint8_t* data, size_t size);
-      void WriteSpi(const uint8_t* data, size_t size, const std::function<void()>& preTransactionHook);
+      void WriteSpi(const uint8_t* data,
+                    size_t size,
+                    const std::function<void()>& preTransactionHook,
+                    const std::function<void()>& transactionCompleteHook);
 
       enum class Commands : uint8_t {
         SoftwareReset = 0x01,
@@ -93,12 +124,20 @@ namespace Pinetime {
       };
       void WriteData(uint8_t data);
       void WriteData(const uint8_t* data, size_t size);
+      void WriteData(const uint8_t* data, size_t size, const std::function<void()>& transactionCompleteHook);
 
       static constexpr uint16_t Width = 240;
       static constexpr uint16_t Height = 320;
 
-      uint8_t addrWindowArgs[4];
-      uint8_t verticalScrollArgs[2];
+      // Current column/row window of the controller, CASET/RASET are only sent when it changes
+      uint16_t windowX0 = 0;
+      uint16_t windowX1 = 0;
+      uint16_t windowY0 = 0;
+      uint16_t windowY1 = 0;
+      bool windowValid = false;
+
+      Statistics statistics;
+      PixelFormats pixelFormat = PixelFormats::Rgb565;
     };
   }
 }
@@ -23,6 +23,7 @@
 // FreeRTOS
 #include <FreeRTOS.h>
 #include <task.h>
+#include <heap_4_infinitime.h>
 #include <timers.h>
 #include <drivers/Hrs3300.h>
 #include <drivers/Bma421.h>
@@ -68,10 +69,10 @@ Pinetime::Drivers::SpiMaster spi {Pinetime::Drivers::SpiMaster::SpiModule::SPI0,
                                    Pinetime::PinMap::SpiMosi,
                                    Pinetime::PinMap::SpiMiso}};
 
-Pinetime::Drivers::Spi lcdSpi {spi, Pinetime::PinMap::SpiLcdCsn};
+Pinetime::Drivers::Spi lcdSpi {spi, Pinetime::PinMap::SpiLcdCsn, Pinetime::Drivers::SpiMaster::Priority::High};
 Pinetime::Drivers::St7789 lcd {lcdSpi, Pinetime::PinMap::LcdDataCommand, Pinetime::PinMap::LcdReset};
 
-Pinetime::Drivers::Spi flashSpi {spi, Pinetime::PinMap::SpiFlashCsn};
+Pinetime::Drivers::Spi flashSpi {spi, Pinetime::PinMap::SpiFlashCsn, Pinetime::Drivers::SpiMaster::Priority::Normal};
 Pinetime::Drivers::SpiNorFlash spiNorFlash {flashSpi};
 
 // The TWI device should work @ up to 400Khz but there is a HW bug which prevent it from
@@ -230,6 +231,13 @@ void RTC0_IRQHandler(void) {
   ((void (*)()) rtc0_isr_addr)();
 }
 
+void TIMER3_IRQHandler(void) {
+  if (NRF_TIMER3->EVENTS_COMPARE[1] == 1) {
+    NRF_TIMER3->EVENTS_COMPARE[1] = 0;
+    spi.OnEndEvent();
+  }
+}
+
 void WDT_IRQHandler(void) {
   nrf_wdt_event_clear(NRF_WDT_EVENT_TIMEOUT);
 }
@@ -277,6 +285,7 @@ void nimble_port_run(void) {
 }
 
 void BleHost(void* /*unused*/) {
+  vPortHeapSetTaskOwner(heapOWNER_NIMBLE);
   nimble_port_run();
 }
 
@@ -299,6 +308,7 @@ void nimble_port_init(void) {
 
 void nimble_port_ll_task_func(void* args) {
   extern void ble_ll_task(void*);
+  vPortHeapSetTaskOwner(heapOWNER_NIMBLE);
   ble_ll_task(args);
 }
 }
@@ -6,9 +6,11 @@
 #include <libraries/log/nrf_log.h>
 #include <FreeRTOS.h>
 #include <task.h>
+#include <semphr.h>
 #include <legacy/nrf_drv_gpiote.h>
 #include <libraries/gpiote/app_gpiote.h>
 #include <hal/nrf_wdt.h>
+#include <nrf_assert.h>
 #include <cstring>
 #include <drivers/St7789.h>
 #include <components/brightness/BrightnessController.h>
@@ -30,6 +32,9 @@ Pinetime::Logging::DummyLogger logger;
 static constexpr uint8_t displayWidth = 240;
 static constexpr uint8_t displayHeight = 240;
 static constexpr uint8_t bytesPerPixel = 2;
+// The logo is decoded and sent a few lines at a time
+static constexpr uint8_t logoLinesPerDraw = 2;
+static_assert(displayHeight % logoLinesPerDraw == 0);
 
 static constexpr uint16_t colorWhite = 0xFFFF;
 static constexpr uint16_t colorGreen = 0xE007;
@@ -41,10 +46,10 @@ Pinetime::Drivers::SpiMaster spi {Pinetime::Drivers::SpiMaster::SpiModule::SPI0,
                                    Pinetime::PinMap::SpiSck,
                                    Pinetime::PinMap::SpiMosi,
                                    Pinetime::PinMap::SpiMiso}};
-Pinetime::Drivers::Spi flashSpi {spi, Pinetime::PinMap::SpiFlashCsn};
+Pinetime::Drivers::Spi flashSpi {spi, Pinetime::PinMap::SpiFlashCsn, Pinetime::Drivers::SpiMaster::Priority::Normal};
 Pinetime::Drivers::SpiNorFlash spiNorFlash {flashSpi};
 
-Pinetime::Drivers::Spi lcdSpi {spi, Pinetime::PinMap::SpiLcdCsn};
+Pinetime::Drivers::Spi lcdSpi {spi, Pinetime::PinMap::SpiLcdCsn, Pinetime::Drivers::SpiMaster::Priority::High};
 Pinetime::Drivers::St7789 lcd {lcdSpi, Pinetime::PinMap::LcdDataCommand, Pinetime::PinMap::LcdReset};
 
 Pinetime::Controllers::BrightnessController brightnessController;
@@ -72,13 +77,22 @@ void SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQHandler(void) {
     NRF_SPIM0->EVENTS_STOPPED = 0;
   }
 }
+
+void TIMER3_IRQHandler(void) {
+  if (NRF_TIMER3->EVENTS_COMPARE[1] == 1) {
+    NRF_TIMER3->EVENTS_COMPARE[1] = 0;
+    spi.OnEndEvent();
+  }
+}
 }
 
 void RefreshWatchdog() {
   NRF_WDT->RR[0] = WDT_RR_RR_Reload;
 }
 
-uint8_t displayBuffer[displayWidth * bytesPerPixel];
+uint8_t displayBuffer[displayWidth * bytesPerPixel * logoLinesPerDraw * 2];
+// Given when the last line of the progress bar has been sent, and displayBuffer can be filled again
+SemaphoreHandle_t progressBarSent = nullptr;
 
 void Process(void* /*instance*/) {
   RefreshWatchdog();
@@ -91,6 +105,10 @@ void Process(void* /*instance*/) {
   brightnessController.Init();
   lcd.Init();
 
+  progressBarSent = xSemaphoreCreateBinary();
+  ASSERT(progressBarSent != nullptr);
+  xSemaphoreGive(progressBarSent);
+
   NRF_LOG_INFO("Display logo")
   DisplayLogo();
 
@@ -119,18 +137,38 @@ void Process(void* /*instance*/) {
 
 void DisplayLogo() {
   Pinetime::Tools::RleDecoder rleDecoder(infinitime_nb, sizeof(infinitime_nb));
-  for (int i = 0; i < displayWidth; i++) {
-    rleDecoder.DecodeNext(displayBuffer, displayWidth * bytesPerPixel);
-    lcd.DrawBuffer(0, i, displayWidth, 1, reinterpret_cast<const uint8_t*>(displayBuffer), displayWidth * bytesPerPixel);
+  static constexpr size_t bytesPerDraw = displayWidth * bytesPerPixel * logoLinesPerDraw;
+  // The halves of the buffer are used alternately: DrawBuffer() returns before the transfer is done, but it waits
+  // for the end of the previous one, so a half is free again once the other one is being sent.
+  for (int i = 0; i < displayWidth; i += logoLinesPerDraw) {
+    uint8_t* lines = displayBuffer + ((i / logoLinesPerDraw) % 2) * bytesPerDraw;
+    rleDecoder.DecodeNext(lines, bytesPerDraw);
+    lcd.DrawBuffer(0, i, displayWidth, logoLinesPerDraw, lines, bytesPerDraw, nullptr);
   }
 }
 
 void DisplayProgressBar(uint8_t percent, uint16_t color) {
   static constexpr uint8_t barHeight = 20;
+  // DrawBuffer() returns while the line is being sent: the previous bar may still be read from displayBuffer
+  xSemaphoreTake(progressBarSent, portMAX_DELAY);
   std::fill(displayBuffer, displayBuffer + (displayWidth * bytesPerPixel), color);
   for (int i = 0; i < barHeight; i++) {
     uint16_t barWidth = std::min(static_cast<float>(percent) * 2.4f, static_cast<float>(displayWidth));
-    lcd.DrawBuffer(0, displayWidth - barHeight + i, barWidth, 1, reinterpret_cast<const uint8_t*>(displayBuffer), barWidth * bytesPerPixel);
+    std::function<void()> transferCompleteCallback;
+    if (i == barHeight - 1) {
+      transferCompleteCallback = []() {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        xSemaphoreGiveFromISR(progressBarSent, &xHigherPriorityTaskWoken);
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+      };
+    }
+    lcd.DrawBuffer(0,
+                   displayWidth - barHeight + i,
+                   barWidth,
+                   1,
+                   reinterpret_cast<const uint8_t*>(displayBuffer),
+                   barWidth * bytesPerPixel,
+                   transferCompleteCallback);
   }
 }
 
@@ -5,16 +5,44 @@ import sys
 import json
 import shutil
 import typing
+import zlib
+import struct
 import os.path
 import argparse
 import subprocess
 from zipfile import ZipFile
 
+# Resource pack installed by components/fs/ResourceInstaller
+PACK_MAGIC = 0x50525449 # "ITRP"
+PACK_VERSION = 1
+ENTRY_FILE = 0
+ENTRY_DELETE = 1
+MAX_PATH_LENGTH = 63
+
+def pack_entry(entry_type, path, data):
+    encoded_path = path.encode()
+    if not 0 < len(encoded_path) <= MAX_PATH_LENGTH:
+        sys.exit(f'Error: the path {path} is too long for a resource pack.')
+    return struct.pack('<BBHII', entry_type, len(encoded_path), 0, len(data), zlib.crc32(data)) + encoded_path + data
+
+def write_pack(output, files, obsolete_files):
+    # Obsolete files are deleted first, to make room for the new ones
+    entries = [pack_entry(ENTRY_DELETE, obsolete['path'], b'') for obsolete in obsolete_files]
+    for path, target_path in files:
+        with open(path, 'rb') as fd:
+            entries.append(pack_entry(ENTRY_FILE, target_path, fd.read()))
+
+    body = b''.join(entries)
+    header = struct.pack('<IHHII', PACK_MAGIC, PACK_VERSION, len(entries), 16 + len(body), zlib.crc32(body))
+    with open(output, 'wb') as fd:
+        fd.write(header + body)
+
 def main():
     ap = argparse.ArgumentParser(description='auto generate LVGL font files from fonts')
     ap.add_argument('--config', '-c', type=str, action='append', help='config file to use')
     ap.add_argument('--obsolete', type=str, help='List of obsolete files')
     ap.add_argument('--output', type=str, help='output file name')
+    ap.add_argument('--pack', type=str, help='also write a resource pack, installed in a single transfer')
     args = ap.parse_args()
 
     for config_file in args.config:
@@ -32,6 +60,7 @@ def main():
 
     zf = ZipFile(args.output, mode='w')
     resource_files = []
+    pack_files = []
 
     for config_file in args.config:
         with open(config_file, 'r') as fd:
@@ -49,6 +78,7 @@ def main():
             if not os.path.exists(path):
                 path = os.path.join(os.path.dirname(sys.argv[0]), path)
             zf.write(path)
+            pack_files.append((path, resource['target_path'] + name + '.bin'))
 
     if args.obsolete:
         obsolete_file_path = os.path.join(os.path.dirname(sys.argv[0]), args.obsolete)
@@ -68,5 +98,8 @@ def main():
     zf.write('resources.json')
     zf.close()
 
+    if args.pack:
+        write_pack(args.pack, pack_files, obsolete_data)
+
 if __name__ == '__main__':
     main()
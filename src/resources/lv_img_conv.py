@@ -30,6 +30,63 @@ def test_classify_pixel():
     assert classify_pixel(18, 6) == 20
 
 
+# Compressed images (--compress) are decoded by src/displayapp/CompressedImage.cpp
+LV_IMG_CF_USER_ENCODED_0 = 24
+COMPRESSED_VERSION = 1
+COMPRESSED_ROWS_PER_BLOCK = 16
+COMPRESSED_FORMAT_TRUE_COLOR_ALPHA = 0
+COMPRESSED_FORMAT_INDEXED_1_BIT = 1
+
+
+def encode_row(row, unit_size):
+    """Encodes the units (pixels or bytes of pixels) of a row in runs.
+    A control byte c < 0x80 is followed by c + 1 literal units,
+    c >= 0x80 is followed by one unit repeated c - 0x80 + 2 times.
+    """
+    units = [bytes(row[i:i + unit_size]) for i in range(0, len(row), unit_size)]
+    out = bytearray()
+    literals = []
+
+    def flush_literals():
+        while literals:
+            chunk = literals[:128]
+            del literals[:128]
+            out.append(len(chunk) - 1)
+            out.extend(b''.join(chunk))
+
+    i = 0
+    while i < len(units):
+        run = 1
+        while i + run < len(units) and run < 129 and units[i + run] == units[i]:
+            run += 1
+        if run >= 2:
+            flush_literals()
+            out.append(0x80 + run - 2)
+            out.extend(units[i])
+            i += run
+        else:
+            literals.append(units[i])
+            i += 1
+    flush_literals()
+    return out
+
+
+def compress(pixels, palette, compressed_format, row_size, unit_size, img_height):
+    """Returns the data that follows the lv_img_header_t of a compressed image:
+    header, palette, offsets of the blocks of rows (from the start of the header) and the encoded rows.
+    """
+    block_count = (img_height + COMPRESSED_ROWS_PER_BLOCK - 1) // COMPRESSED_ROWS_PER_BLOCK
+    header = bytes([COMPRESSED_VERSION, compressed_format, COMPRESSED_ROWS_PER_BLOCK, 0]) + palette
+    rows_start = len(header) + 4 * block_count
+    offsets = bytearray()
+    rows = bytearray()
+    for y in range(img_height):
+        if y % COMPRESSED_ROWS_PER_BLOCK == 0:
+            offsets.extend((rows_start + len(rows)).to_bytes(4, 'little'))
+        rows.extend(encode_row(pixels[y * row_size:(y + 1) * row_size], unit_size))
+    return header + offsets + rows
+
+
 def main():
     parser = argparse.ArgumentParser()
 
@@ -61,6 +118,9 @@ def main():
         help="binary color format (needed if output-format is binary)",
         default="ARGB8565_RBSWAP",
         choices=["ARGB8332", "ARGB8565", "ARGB8565_RBSWAP", "ARGB8888"])
+    parser.add_argument("--compress",
+        help="run length encode the rows (decoded by InfiniTime's CompressedImage decoder)",
+        action="store_true")
     parser.add_argument("-s", "--swap-endian",
         help="swap endian of image (not implemented)",
         action="store_true")
@@ -175,6 +235,16 @@ def main():
         case _:
             # raise just to be sure
             raise NotImplementedError(f"args.color_format '{args.color_format}' not implemented")
+    if args.compress:
+        if args.color_format == "CF_INDEXED_1_BIT":
+            row_size = (img_width + 7) // 8
+            buf = compress(buf[8:], buf[:8], COMPRESSED_FORMAT_INDEXED_1_BIT, row_size, 1, img_height)
+        elif args.binary_format == "ARGB8565_RBSWAP":
+            buf = compress(buf, b'', COMPRESSED_FORMAT_TRUE_COLOR_ALPHA, img_width * 3, 3, img_height)
+        else:
+            raise NotImplementedError(f"argument --compress not implemented for --binary-format '{args.binary_format}'")
+        lv_cf = LV_IMG_CF_USER_ENCODED_0
+
     header_32bit = lv_cf | (img_width << 10) | (img_height << 21)
     buf_out = bytearray(4 + len(buf))
     buf_out[0] = header_32bit & 0xFF
@@ -10,6 +10,7 @@ namespace Pinetime {
       OnNewNotification,
       OnNewCall,
       BleConnected,
+      BleDisconnected,
       BleFirmwareUpdateStarted,
       BleFirmwareUpdateFinished,
       OnTouchEvent,
@@ -27,9 +28,13 @@ namespace Pinetime {
       SetOffAlarm,
       MeasureBatteryTimerExpired,
       BatteryPercentageUpdated,
+      HeartRateUpdated,
+      WeatherUpdated,
       StartFileTransfer,
       StopFileTransfer,
-      BleRadioEnableToggle
+      BleRadioEnableToggle,
+      OnDfuSlotErased,
+      PreEraseDfuSlot
     };
   }
 }
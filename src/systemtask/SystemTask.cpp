@@ -32,6 +32,11 @@ void MeasureBatteryTimerCallback(TimerHandle_t xTimer) {
   sysTask->PushMessage(Pinetime::System::Messages::MeasureBatteryTimerExpired);
 }
 
+void PreEraseDfuSlotTimerCallback(TimerHandle_t xTimer) {
+  auto* sysTask = static_cast<SystemTask*>(pvTimerGetTimerID(xTimer));
+  sysTask->PushMessage(Pinetime::System::Messages::PreEraseDfuSlot);
+}
+
 SystemTask::SystemTask(Drivers::SpiMaster& spi,
                        Pinetime::Drivers::SpiNorFlash& spiNorFlash,
                        Drivers::TwiMaster& twiMaster,
@@ -128,6 +133,7 @@ void SystemTask::Work() {
   touchPanel.Init();
   dateTimeController.Register(this);
   batteryController.Register(this);
+  heartRateController.Register(this);
   motionSensor.SoftReset();
   alarmController.Init(this);
 
@@ -182,6 +188,9 @@ void SystemTask::Work() {
   measureBatteryTimer = xTimerCreate("measureBattery", batteryMeasurementPeriod, pdTRUE, this, MeasureBatteryTimerCallback);
   xTimerStart(measureBatteryTimer, portMAX_DELAY);
 
+  dfuSlotTimer = xTimerCreate("dfuSlot", dfuSlotEraseDelay, pdFALSE, this, PreEraseDfuSlotTimerCallback);
+  xTimerStart(dfuSlotTimer, portMAX_DELAY);
+
   constexpr TickType_t stateUpdatePeriod = pdMS_TO_TICKS(100);
   // Stores when the state (motion, watchdog, time persistence etc) was last updated
   // If there are many events being received by the message queue, this prevents
@@ -229,6 +238,8 @@ void SystemTask::Work() {
               GoToRunning();
             }
             displayApp.PushMessage(Pinetime::Applications::Display::Messages::NewNotification);
+          } else {
+            displayApp.PushMessage(Pinetime::Applications::Display::Messages::UpdateNotifications);
           }
           break;
         case Messages::SetOffAlarm:
@@ -237,6 +248,7 @@ void SystemTask::Work() {
           break;
         case Messages::BleConnected:
           displayApp.PushMessage(Pinetime::Applications::Display::Messages::NotifyDeviceActivity);
+          displayApp.PushMessage(Pinetime::Applications::Display::Messages::UpdateBleConnection);
           isBleDiscoveryTimerRunning = true;
           bleDiscoveryTimer = 5;
           break;
@@ -257,6 +269,20 @@ void SystemTask::Work() {
           wakeLocksHeld++;
           // TODO add intent of fs access icon or something
           break;
+        case Messages::OnDfuSlotErased:
+          // The flash is in deep power down while sleeping, the state is persisted on wake up
+          if (!IsSleeping()) {
+            nimbleController.PersistDfuSlotState();
+          }
+          break;
+        case Messages::PreEraseDfuSlot:
+          // The flash is in deep power down while sleeping, try again later
+          if (IsSleeping()) {
+            xTimerStart(dfuSlotTimer, 0);
+          } else {
+            nimbleController.PreEraseDfuSlot();
+          }
+          break;
         case Messages::StopFileTransfer:
           NRF_LOG_INFO("[systemtask] FS Stopped");
           wakeLocksHeld--;
@@ -351,8 +377,12 @@ void SystemTask::Work() {
             displayApp.PushMessage(Pinetime::Applications::Display::Messages::Chime);
           }
           break;
+        case Messages::BleDisconnected:
+          displayApp.PushMessage(Pinetime::Applications::Display::Messages::UpdateBleConnection);
+          break;
         case Messages::OnChargingEvent:
           batteryController.ReadPowerState();
+          displayApp.PushMessage(Pinetime::Applications::Display::Messages::UpdateBattery);
           GoToRunning();
           break;
         case Messages::MeasureBatteryTimerExpired:
@@ -360,6 +390,17 @@ void SystemTask::Work() {
           break;
         case Messages::BatteryPercentageUpdated:
           nimbleController.NotifyBatteryLevel(batteryController.PercentRemaining());
+          displayApp.PushMessage(Pinetime::Applications::Display::Messages::UpdateBattery);
+          break;
+        case Messages::HeartRateUpdated:
+          if (!IsSleeping()) {
+            displayApp.PushMessage(Pinetime::Applications::Display::Messages::UpdateHeartRate);
+          }
+          break;
+        case Messages::WeatherUpdated:
+          if (!IsSleeping()) {
+            displayApp.PushMessage(Pinetime::Applications::Display::Messages::UpdateWeather);
+          }
           break;
         case Messages::OnPairing:
           GoToRunning();
@@ -371,6 +412,7 @@ void SystemTask::Work() {
           } else {
             nimbleController.DisableRadio();
           }
+          displayApp.PushMessage(Pinetime::Applications::Display::Messages::UpdateBleConnection);
           break;
         default:
           break;
@@ -416,6 +458,7 @@ void SystemTask::GoToRunning() {
     }
 
     spiNorFlash.Wakeup();
+    nimbleController.PersistDfuSlotState();
   }
 
   displayApp.PushMessage(Pinetime::Applications::Display::Messages::GoToRunning);
@@ -452,7 +495,12 @@ void SystemTask::UpdateMotion() {
 
   auto motionValues = motionSensor.Process();
 
+  uint32_t previousSteps = motionController.NbSteps();
   motionController.Update(motionValues.x, motionValues.y, motionValues.z, motionValues.steps);
+  // The screens catch up on the steps counted while sleeping when they wake up
+  if (!IsSleeping() && motionController.NbSteps() != previousSteps) {
+    displayApp.PushMessage(Pinetime::Applications::Display::Messages::UpdateSteps);
+  }
 
   if (settingsController.GetNotificationStatus() != Controllers::Settings::Notification::Sleep) {
     if ((settingsController.isWakeUpModeOn(Pinetime::Controllers::Settings::WakeUpMode::RaiseWrist) &&
@@ -133,6 +133,7 @@ namespace Pinetime {
       bool isBleDiscoveryTimerRunning = false;
       uint8_t bleDiscoveryTimer = 0;
       TimerHandle_t measureBatteryTimer;
+      TimerHandle_t dfuSlotTimer;
       uint8_t wakeLocksHeld = 0;
       SystemTaskState state = SystemTaskState::Running;
 
@@ -143,6 +144,8 @@ namespace Pinetime {
       void GoToSleep();
       void UpdateMotion();
       static constexpr TickType_t batteryMeasurementPeriod = pdMS_TO_TICKS(10 * 60 * 1000);
+      // The DFU slot is not erased while the boot and the first connection of the companion app use the flash
+      static constexpr TickType_t dfuSlotEraseDelay = pdMS_TO_TICKS(60 * 1000);
 
       SystemMonitor monitor;
     };
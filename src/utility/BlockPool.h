@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Utility {
+    // Fixed-size block allocator: allocating and freeing are O(1) and never fragment. Not thread safe.
+    template <size_t BlockSize, size_t BlockCount>
+    class BlockPool {
+    public:
+      static constexpr size_t alignment = 8;
+      static constexpr size_t blockSize = (BlockSize + alignment - 1) / alignment * alignment;
+      static constexpr size_t blockCount = BlockCount;
+
+      BlockPool() {
+        for (size_t i = BlockCount; i > 0; i--) {
+          auto* block = reinterpret_cast<FreeBlock*>(storage + (i - 1) * blockSize);
+          block->next = freeList;
+          freeList = block;
+        }
+      }
+
+      BlockPool(const BlockPool&) = delete;
+      BlockPool& operator=(const BlockPool&) = delete;
+
+      // Returns nullptr when all the blocks are used
+      void* Allocate() {
+        if (freeList == nullptr) {
+          return nullptr;
+        }
+        FreeBlock* block = freeList;
+        freeList = block->next;
+        used++;
+        if (used > peak) {
+          peak = used;
+        }
+        return block;
+      }
+
+      void Free(void* pointer) {
+        auto* block = static_cast<FreeBlock*>(pointer);
+        block->next = freeList;
+        freeList = block;
+        used--;
+      }
+
+      bool Owns(const void* pointer) const {
+        auto address = reinterpret_cast<uintptr_t>(pointer);
+        auto start = reinterpret_cast<uintptr_t>(storage);
+        return address >= start && address < start + sizeof(storage);
+      }
+
+      size_t Used() const {
+        return used;
+      }
+
+      size_t Peak() const {
+        return peak;
+      }
+
+    private:
+      struct FreeBlock {
+        FreeBlock* next;
+      };
+
+      static_assert(BlockSize >= sizeof(FreeBlock));
+      static_assert(BlockCount > 0);
+
+      alignas(alignment) uint8_t storage[blockSize * BlockCount];
+      FreeBlock* freeList = nullptr;
+      size_t used = 0;
+      size_t peak = 0;
+    };
+  }
+}
@@ -0,0 +1,38 @@
+#include "utility/Crc16.h"
+
+#include <array>
+
+namespace {
+  // crcTables[n][i] is the CRC of byte i followed by n zero bytes
+  constexpr size_t crcSlices = 4;
+
+  constexpr std::array<std::array<uint16_t, 256>, crcSlices> GenerateCrcTables() {
+    std::array<std::array<uint16_t, 256>, crcSlices> tables {};
+    for (uint32_t i = 0; i < 256; i++) {
+      uint16_t crc = static_cast<uint16_t>(i << 8);
+      for (uint8_t bit = 0; bit < 8; bit++) {
+        crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+      }
+      tables[0][i] = crc;
+    }
+    for (size_t slice = 1; slice < crcSlices; slice++) {
+      for (uint32_t i = 0; i < 256; i++) {
+        uint16_t previous = tables[slice - 1][i];
+        tables[slice][i] = static_cast<uint16_t>(previous << 8) ^ tables[0][previous >> 8];
+      }
+    }
+    return tables;
+  }
+
+  constexpr auto crcTables = GenerateCrcTables();
+}
+
+uint16_t Pinetime::Utility::Crc16(const uint8_t* data, size_t size, uint16_t crc) {
+  for (; size >= crcSlices; size -= crcSlices, data += crcSlices) {
+    crc = crcTables[3][(crc >> 8) ^ data[0]] ^ crcTables[2][(crc & 0xFF) ^ data[1]] ^ crcTables[1][data[2]] ^ crcTables[0][data[3]];
+  }
+  for (; size > 0; size--, data++) {
+    crc = static_cast<uint16_t>(crc << 8) ^ crcTables[0][(crc >> 8) ^ *data];
+  }
+  return crc;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Pinetime {
+  namespace Utility {
+    // CRC16-CCITT (polynomial 0x1021) of size bytes of data, continued from crc. Processes 4 bytes per step (slice-by-4).
+    uint16_t Crc16(const uint8_t* data, size_t size, uint16_t crc = 0xFFFF);
+  }
+}
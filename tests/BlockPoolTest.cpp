@@ -0,0 +1,108 @@
+#include "utility/BlockPool.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "Test.h"
+
+using namespace Pinetime::Utility;
+
+namespace {
+  // Every block is distinct, aligned, owned by the pool, and the pool runs out after blockCount allocations
+  void TestAllocate() {
+    BlockPool<20, 5> pool;
+    CHECK(pool.blockSize == 24);
+
+    std::vector<uint8_t*> blocks;
+    for (size_t i = 0; i < pool.blockCount; i++) {
+      auto* block = static_cast<uint8_t*>(pool.Allocate());
+      CHECK(block != nullptr);
+      CHECK(reinterpret_cast<uintptr_t>(block) % pool.alignment == 0);
+      CHECK(pool.Owns(block));
+      std::memset(block, static_cast<int>(i), 20);
+      blocks.push_back(block);
+    }
+    CHECK(pool.Allocate() == nullptr);
+    CHECK(pool.Used() == 5);
+
+    std::vector<uint8_t*> sorted = blocks;
+    std::sort(sorted.begin(), sorted.end());
+    for (size_t i = 1; i < sorted.size(); i++) {
+      CHECK(sorted[i] - sorted[i - 1] >= static_cast<ptrdiff_t>(pool.blockSize));
+    }
+    // Writing a block does not overwrite the others
+    for (size_t i = 0; i < blocks.size(); i++) {
+      CHECK(blocks[i][0] == i && blocks[i][19] == i);
+    }
+
+    int outside;
+    CHECK(!pool.Owns(&outside));
+    CHECK(!pool.Owns(sorted.back() + pool.blockSize));
+  }
+
+  // A freed block is the next one allocated, the peak is kept
+  void TestFree() {
+    BlockPool<8, 3> pool;
+    void* a = pool.Allocate();
+    void* b = pool.Allocate();
+    pool.Free(a);
+    CHECK(pool.Used() == 1);
+    CHECK(pool.Peak() == 2);
+    CHECK(pool.Allocate() == a);
+    pool.Free(b);
+    pool.Free(a);
+    CHECK(pool.Used() == 0);
+    CHECK(pool.Peak() == 2);
+
+    void* blocks[3];
+    for (auto& block : blocks) {
+      block = pool.Allocate();
+    }
+    CHECK(pool.Peak() == 3);
+    CHECK(pool.Allocate() == nullptr);
+    CHECK(pool.Peak() == 3);
+  }
+
+  // Random allocations and frees, the content of the live blocks is preserved
+  void TestRandom() {
+    BlockPool<16, 32> pool;
+    struct Live {
+      uint8_t* block;
+      uint8_t value;
+    };
+    std::vector<Live> live;
+    size_t peak = 0;
+    bool preserved = true;
+    std::srand(1);
+    for (int i = 0; i < 10000; i++) {
+      if (std::rand() % 2 == 0) {
+        auto* block = static_cast<uint8_t*>(pool.Allocate());
+        CHECK((block == nullptr) == (live.size() == pool.blockCount));
+        if (block != nullptr) {
+          auto value = static_cast<uint8_t>(std::rand());
+          std::memset(block, value, 16);
+          live.push_back({block, value});
+          peak = std::max(peak, live.size());
+        }
+      } else if (!live.empty()) {
+        size_t index = std::rand() % live.size();
+        const Live& freed = live[index];
+        preserved = preserved && std::all_of(freed.block, freed.block + 16, [&](uint8_t byte) {
+                      return byte == freed.value;
+                    });
+        pool.Free(freed.block);
+        live.erase(live.begin() + index);
+      }
+    }
+    CHECK(preserved);
+    CHECK(pool.Used() == live.size());
+    CHECK(pool.Peak() == peak);
+  }
+}
+
+int main() {
+  TestAllocate();
+  TestFree();
+  TestRandom();
+  return Test::Result();
+}
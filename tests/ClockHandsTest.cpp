@@ -0,0 +1,151 @@
+#include "displayapp/widgets/ClockHands.h"
+#include <cmath>
+#include "Test.h"
+
+using namespace Pinetime::Applications::Widgets;
+
+namespace {
+  constexpr double pi = 3.14159265358979323846;
+  constexpr lv_area_t screen {0, 0, LV_HOR_RES - 1, LV_VER_RES - 1};
+
+  // Draws the clock hands within clip, returns the lines drawn
+  std::vector<FakeLine> Draw(const lv_area_t& clip) {
+    fakeLines.clear();
+    lv_obj_t& object = fakeObjects.back();
+    CHECK(object.design_cb(&object, &clip, LV_DESIGN_COVER_CHK) == LV_DESIGN_RES_NOT_COVER);
+    object.design_cb(&object, &clip, LV_DESIGN_DRAW_MAIN);
+    return fakeLines;
+  }
+
+  double Distance(double x, double y, const lv_point_t& start, const lv_point_t& end) {
+    const double dx = end.x - start.x;
+    const double dy = end.y - start.y;
+    const double lengthSquared = dx * dx + dy * dy;
+    const double t = lengthSquared == 0 ? 0 : std::clamp(((x - start.x) * dx + (y - start.y) * dy) / lengthSquared, 0.0, 1.0);
+    return std::hypot(x - (start.x + t * dx), y - (start.y + t * dy));
+  }
+
+  bool Invalidated(lv_coord_t x, lv_coord_t y) {
+    return std::any_of(fakeInvalidatedAreas.begin(), fakeInvalidatedAreas.end(), [&](const lv_area_t& area) {
+      return x >= area.x1 && x <= area.x2 && y >= area.y1 && y <= area.y2;
+    });
+  }
+
+  // Every pixel LVGL may draw for the line, including the rounded ends and the anti-aliasing, was invalidated
+  bool Covered(const FakeLine& line) {
+    const double reach = line.dsc.width / 2.0 + 1;
+    const int reachPixels = static_cast<int>(std::ceil(reach));
+    for (int y = std::min(line.start.y, line.end.y) - reachPixels; y <= std::max(line.start.y, line.end.y) + reachPixels; y++) {
+      for (int x = std::min(line.start.x, line.end.x) - reachPixels; x <= std::max(line.start.x, line.end.x) + reachPixels; x++) {
+        if (Distance(x, y, line.start, line.end) <= reach && !Invalidated(x, y)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  // Offset of a point at radius and angle, from std::sin scaled like _lv_trigo_sin() and rounded to the nearest integer.
+  // Either rounding of an exact half (sin(30°)) is accepted.
+  bool MatchesSine(lv_coord_t offset, int16_t radius, uint16_t angle) {
+    const double sine = std::sin(angle * pi / (ClockHands::fullTurn / 2));
+    for (double tie : {-1e-6, 1e-6}) {
+      const auto rounded = static_cast<int32_t>(std::copysign(std::floor(std::abs(sine) * INT16_MAX + 0.5 + tie), sine));
+      if (radius * rounded / INT16_MAX == offset) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // The constexpr sine table matches std::sin for every angle, at a radius long enough to show a difference of one unit
+  void TestSineTable() {
+    constexpr int16_t radius = 16384;
+    ClockHands hands;
+    hands.Create(nullptr);
+    uint8_t hand = hands.AddHand({0, radius, 1, false, {}});
+
+    bool matches = true;
+    for (uint16_t angle = 0; angle < 2 * ClockHands::fullTurn; angle++) {
+      hands.SetAngle(hand, angle);
+      const std::vector<FakeLine> lines = Draw(screen);
+      CHECK(lines.size() == 1);
+      matches = matches && lines[0].start.x == LV_HOR_RES / 2 && lines[0].start.y == LV_VER_RES / 2 &&
+                MatchesSine(lines[0].end.x - LV_HOR_RES / 2, radius, angle) &&
+                MatchesSine(LV_VER_RES / 2 - lines[0].end.y, radius, angle + ClockHands::fullTurn / 4);
+    }
+    CHECK(matches);
+
+    hands.SetAngle(hand, 0);
+    lv_point_t end = Draw(screen)[0].end;
+    CHECK(end.x == LV_HOR_RES / 2 && end.y == LV_VER_RES / 2 - radius);
+    hands.SetAngle(hand, ClockHands::fullTurn / 4);
+    end = Draw(screen)[0].end;
+    CHECK(end.x == LV_HOR_RES / 2 + radius && end.y == LV_VER_RES / 2);
+  }
+
+  // Moving a hand invalidates its previous and new positions, with less than half of the bounding boxes of the lines
+  void TestInvalidation() {
+    ClockHands hands;
+    hands.Create(nullptr);
+    const uint8_t second = hands.AddHand({-20, 100, 3, false, {}});
+    const uint8_t minute = hands.AddHand({0, 60, 7, true, {}});
+    hands.SetAngle(minute, 0);
+
+    bool covered = true;
+    size_t invalidatedPixels = 0;
+    size_t boundingBoxPixels = 0;
+    hands.SetAngle(second, 0);
+    for (uint16_t angle = 3; angle <= ClockHands::fullTurn; angle += 3) {
+      const FakeLine before = Draw(screen)[second];
+      fakeInvalidatedAreas.clear();
+      hands.SetAngle(second, angle % ClockHands::fullTurn);
+      const FakeLine after = Draw(screen)[second];
+      covered = covered && Covered(before) && Covered(after);
+
+      for (const lv_area_t& area : fakeInvalidatedAreas) {
+        invalidatedPixels += (area.x2 - area.x1 + 1) * (area.y2 - area.y1 + 1);
+      }
+      for (const FakeLine& line : {before, after}) {
+        const int padding = line.dsc.width / 2 + 2;
+        boundingBoxPixels +=
+          (std::abs(line.end.x - line.start.x) + 2 * padding + 1) * (std::abs(line.end.y - line.start.y) + 2 * padding + 1);
+      }
+    }
+    CHECK(covered);
+    CHECK(2 * invalidatedPixels < boundingBoxPixels);
+    std::printf("Second hand, a turn: %zu pixels invalidated, %zu with bounding boxes\n", invalidatedPixels, boundingBoxPixels);
+
+    // The minute hand, which did not move, is not invalidated
+    fakeInvalidatedAreas.clear();
+    hands.SetAngle(minute, 0);
+    CHECK(fakeInvalidatedAreas.empty());
+  }
+
+  // Only the hands that cross the area being redrawn are drawn, clipped to it
+  void TestClip() {
+    ClockHands hands;
+    hands.Create(nullptr);
+    const uint8_t hour = hands.AddHand({0, 50, 7, true, {}});
+    const uint8_t minute = hands.AddHand({0, 90, 5, true, {}});
+    CHECK(Draw(screen).empty());
+
+    hands.SetAngle(hour, 0);
+    hands.SetAngle(minute, ClockHands::fullTurn / 4);
+    CHECK(Draw(screen).size() == 2);
+
+    // Crosses the hour hand and its padding, not the minute hand
+    const lv_area_t topLeft {0, 0, 119, 100};
+    const std::vector<FakeLine> lines = Draw(topLeft);
+    CHECK(lines.size() == 1);
+    CHECK(lines[0].dsc.width == 7 && lines[0].dsc.round_start && lines[0].dsc.round_end);
+    CHECK(lines[0].clip.x1 == 115 && lines[0].clip.y1 == 65 && lines[0].clip.x2 == 119 && lines[0].clip.y2 == 100);
+  }
+}
+
+int main() {
+  TestSineTable();
+  TestInvalidation();
+  TestClip();
+  return Test::Result();
+}
@@ -0,0 +1,227 @@
+#include "displayapp/CompressedImage.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "Test.h"
+
+using namespace Pinetime::Components;
+
+namespace {
+  constexpr uint8_t formatTrueColorAlpha = 0;
+  constexpr uint8_t formatIndexed1Bit = 1;
+  constexpr size_t rowsPerBlock = 16;
+
+  // Same encoding as encode_row() in src/resources/lv_img_conv.py
+  void EncodeRow(const uint8_t* row, size_t rowSize, size_t unitSize, std::vector<uint8_t>& output) {
+    const size_t count = rowSize / unitSize;
+    auto unit = [&](size_t i) {
+      return std::vector<uint8_t>(row + i * unitSize, row + (i + 1) * unitSize);
+    };
+    std::vector<size_t> literals;
+    auto flushLiterals = [&]() {
+      for (size_t start = 0; start < literals.size(); start += 128) {
+        size_t chunk = std::min<size_t>(128, literals.size() - start);
+        output.push_back(chunk - 1);
+        for (size_t i = start; i < start + chunk; i++) {
+          output.insert(output.end(), row + literals[i] * unitSize, row + (literals[i] + 1) * unitSize);
+        }
+      }
+      literals.clear();
+    };
+
+    size_t i = 0;
+    while (i < count) {
+      size_t run = 1;
+      while (i + run < count && run < 129 && unit(i + run) == unit(i)) {
+        run++;
+      }
+      if (run >= 2) {
+        flushLiterals();
+        output.push_back(0x80 + run - 2);
+        output.insert(output.end(), row + i * unitSize, row + (i + 1) * unitSize);
+        i += run;
+      } else {
+        literals.push_back(i);
+        i++;
+      }
+    }
+    flushLiterals();
+  }
+
+  // Same layout as compress() in src/resources/lv_img_conv.py: the data that follows the lv_img_header_t
+  std::vector<uint8_t> Compress(const std::vector<uint8_t>& pixels,
+                                const std::vector<uint8_t>& palette,
+                                uint8_t format,
+                                size_t rowSize,
+                                size_t unitSize,
+                                size_t height) {
+    const size_t blockCount = (height + rowsPerBlock - 1) / rowsPerBlock;
+    std::vector<uint8_t> output {1, format, rowsPerBlock, 0};
+    output.insert(output.end(), palette.begin(), palette.end());
+    const size_t offsetsStart = output.size();
+    output.resize(offsetsStart + 4 * blockCount);
+    for (size_t y = 0; y < height; y++) {
+      if (y % rowsPerBlock == 0) {
+        auto offset = static_cast<uint32_t>(output.size());
+        std::memcpy(output.data() + offsetsStart + 4 * (y / rowsPerBlock), &offset, sizeof(offset));
+      }
+      EncodeRow(pixels.data() + y * rowSize, rowSize, unitSize, output);
+    }
+    return output;
+  }
+
+  // Rows mixing long runs, short runs and literals
+  std::vector<uint8_t> GenerateUnits(size_t count, size_t unitSize) {
+    std::vector<uint8_t> units;
+    while (units.size() < count * unitSize) {
+      std::vector<uint8_t> unit(unitSize);
+      for (auto& byte : unit) {
+        byte = static_cast<uint8_t>(std::rand() % 4);
+      }
+      size_t repeat = (std::rand() % 3 == 0) ? std::rand() % 300 : 1;
+      for (size_t i = 0; i < repeat && units.size() < count * unitSize; i++) {
+        units.insert(units.end(), unit.begin(), unit.end());
+      }
+    }
+    return units;
+  }
+
+  struct Image {
+    lv_img_header_t header;
+    std::vector<uint8_t> data;
+    // Expected output of read_line, LV_IMG_CF_TRUE_COLOR_ALPHA
+    std::vector<uint8_t> pixels;
+
+    lv_img_dsc_t Descriptor() const {
+      return {header, static_cast<uint32_t>(data.size()), data.data()};
+    }
+
+    std::vector<uint8_t> File() const {
+      std::vector<uint8_t> file(sizeof(header));
+      std::memcpy(file.data(), &header, sizeof(header));
+      file.insert(file.end(), data.begin(), data.end());
+      return file;
+    }
+  };
+
+  Image TrueColorImage(uint16_t width, uint16_t height) {
+    Image image {{LV_IMG_CF_USER_ENCODED_0, 0, 0, width, height}, {}, GenerateUnits(width * height, LV_IMG_PX_SIZE_ALPHA_BYTE)};
+    image.data = Compress(image.pixels, {}, formatTrueColorAlpha, width * LV_IMG_PX_SIZE_ALPHA_BYTE, LV_IMG_PX_SIZE_ALPHA_BYTE, height);
+    return image;
+  }
+
+  Image IndexedImage(uint16_t width, uint16_t height) {
+    const size_t rowSize = (width + 7) / 8;
+    const std::vector<uint8_t> bits = GenerateUnits(rowSize * height, 1);
+    const lv_color32_t colors[2] = {{{0x10, 0x20, 0x30, 0x00}}, {{0xF0, 0x80, 0x40, 0xFF}}};
+    std::vector<uint8_t> palette(sizeof(colors));
+    std::memcpy(palette.data(), colors, sizeof(colors));
+
+    Image image {{LV_IMG_CF_USER_ENCODED_0, 0, 0, width, height}, Compress(bits, palette, formatIndexed1Bit, rowSize, 1, height), {}};
+    for (size_t y = 0; y < height; y++) {
+      for (size_t x = 0; x < width; x++) {
+        const lv_color32_t& color = colors[(bits[y * rowSize + x / 8] >> (7 - x % 8)) & 0x01];
+        lv_color_t pixel = lv_color_make(color.ch.red, color.ch.green, color.ch.blue);
+        image.pixels.push_back(pixel.full & 0xFF);
+        image.pixels.push_back(pixel.full >> 8);
+        image.pixels.push_back(color.ch.alpha);
+      }
+    }
+    return image;
+  }
+
+  // Reads lines in order, then random parts of random lines, through the callbacks registered to LVGL
+  void CheckDecode(const Image& image, const void* source) {
+    lv_img_decoder_t* decoder = &fakeImageDecoder;
+    lv_img_header_t info;
+    CHECK(decoder->info_cb(decoder, source, &info) == LV_RES_OK);
+    CHECK(info.cf == LV_IMG_CF_TRUE_COLOR_ALPHA);
+    CHECK(info.w == image.header.w && info.h == image.header.h);
+
+    lv_img_decoder_dsc_t dsc {};
+    dsc.decoder = decoder;
+    dsc.src = source;
+    CHECK(decoder->open_cb(decoder, &dsc) == LV_RES_OK);
+
+    const lv_coord_t width = image.header.w;
+    const lv_coord_t height = image.header.h;
+    std::vector<uint8_t> line(width * LV_IMG_PX_SIZE_ALPHA_BYTE);
+    bool matches = true;
+    for (lv_coord_t y = 0; y < height; y++) {
+      matches = matches && decoder->read_line_cb(decoder, &dsc, 0, y, width, line.data()) == LV_RES_OK &&
+                std::equal(line.begin(), line.end(), image.pixels.begin() + y * line.size());
+    }
+    for (int i = 0; i < 500; i++) {
+      lv_coord_t y = std::rand() % height;
+      lv_coord_t x = std::rand() % width;
+      lv_coord_t length = 1 + std::rand() % (width - x);
+      auto expected = image.pixels.begin() + (y * width + x) * LV_IMG_PX_SIZE_ALPHA_BYTE;
+      matches = matches && decoder->read_line_cb(decoder, &dsc, x, y, length, line.data()) == LV_RES_OK &&
+                std::equal(line.begin(), line.begin() + length * LV_IMG_PX_SIZE_ALPHA_BYTE, expected);
+    }
+    CHECK(matches);
+
+    CHECK(decoder->read_line_cb(decoder, &dsc, 0, height, 1, line.data()) == LV_RES_INV);
+    CHECK(decoder->read_line_cb(decoder, &dsc, 1, 0, width, line.data()) == LV_RES_INV);
+    decoder->close_cb(decoder, &dsc);
+    CHECK(dsc.user_data == nullptr);
+  }
+
+  void TestRoundTrip() {
+    for (const Image& image : {TrueColorImage(40, 70), TrueColorImage(240, 17), IndexedImage(45, 50), IndexedImage(8, 1)}) {
+      lv_img_dsc_t descriptor = image.Descriptor();
+      CheckDecode(image, &descriptor);
+
+      fakeFiles["F:/images/test.bin"] = image.File();
+      CheckDecode(image, "F:/images/test.bin");
+    }
+  }
+
+  // Truncated or unsupported data is rejected, without reading past its end
+  void TestInvalidImages() {
+    lv_img_decoder_t* decoder = &fakeImageDecoder;
+    const Image image = TrueColorImage(30, 40);
+    lv_img_header_t info;
+
+    Image badVersion = image;
+    badVersion.data[0] = 2;
+    lv_img_dsc_t descriptor = badVersion.Descriptor();
+    CHECK(decoder->info_cb(decoder, &descriptor, &info) == LV_RES_INV);
+
+    Image uncompressed = image;
+    uncompressed.header.cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+    descriptor = uncompressed.Descriptor();
+    CHECK(decoder->info_cb(decoder, &descriptor, &info) == LV_RES_INV);
+
+    const std::vector<uint8_t> file = image.File();
+    fakeFiles["F:/images/short.bin"] = std::vector<uint8_t>(file.begin(), file.begin() + 6);
+    CHECK(decoder->info_cb(decoder, "F:/images/short.bin", &info) == LV_RES_INV);
+    CHECK(decoder->info_cb(decoder, "F:/images/missing.bin", &info) == LV_RES_INV);
+
+    for (size_t size : {image.data.size() / 2, image.data.size() - 1}) {
+      Image truncated = image;
+      truncated.data.resize(size);
+      descriptor = truncated.Descriptor();
+      lv_img_decoder_dsc_t dsc {};
+      dsc.decoder = decoder;
+      dsc.src = &descriptor;
+      CHECK(decoder->open_cb(decoder, &dsc) == LV_RES_OK);
+      std::vector<uint8_t> line(image.header.w * LV_IMG_PX_SIZE_ALPHA_BYTE);
+      lv_res_t result = LV_RES_OK;
+      for (lv_coord_t y = 0; y < image.header.h && result == LV_RES_OK; y++) {
+        result = decoder->read_line_cb(decoder, &dsc, 0, y, image.header.w, line.data());
+      }
+      CHECK(result == LV_RES_INV);
+      decoder->close_cb(decoder, &dsc);
+    }
+  }
+}
+
+int main() {
+  std::srand(1);
+  CompressedImage::RegisterDecoder();
+  TestRoundTrip();
+  TestInvalidImages();
+  return Test::Result();
+}
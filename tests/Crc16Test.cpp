@@ -0,0 +1,61 @@
+#include "utility/Crc16.h"
+#include <algorithm>
+#include <cstdlib>
+#include "Test.h"
+
+using namespace Pinetime::Utility;
+
+namespace {
+  // Bit by bit reference
+  uint16_t ReferenceCrc16(const uint8_t* data, size_t size, uint16_t crc) {
+    for (size_t i = 0; i < size; i++) {
+      crc ^= static_cast<uint16_t>(data[i] << 8);
+      for (int bit = 0; bit < 8; bit++) {
+        crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+      }
+    }
+    return crc;
+  }
+
+  void TestCheckValue() {
+    const uint8_t data[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    CHECK(Crc16(data, sizeof(data)) == 0x29B1);
+    CHECK(Crc16(data, 0) == 0xFFFF);
+  }
+
+  // Every length and alignment, computed at once and in packets of random sizes like the DFU data
+  void TestAgainstReference() {
+    std::srand(1);
+    uint8_t data[1024];
+    for (auto& byte : data) {
+      byte = static_cast<uint8_t>(std::rand());
+    }
+
+    bool matches = true;
+    for (size_t offset = 0; offset < 4; offset++) {
+      for (size_t size = 0; size <= 64; size++) {
+        matches = matches && Crc16(data + offset, size) == ReferenceCrc16(data + offset, size, 0xFFFF);
+      }
+    }
+    CHECK(matches);
+
+    const uint16_t expected = ReferenceCrc16(data, sizeof(data), 0xFFFF);
+    for (int iteration = 0; iteration < 100; iteration++) {
+      uint16_t crc = 0xFFFF;
+      size_t position = 0;
+      while (position < sizeof(data)) {
+        size_t size = std::min<size_t>(std::rand() % 21, sizeof(data) - position);
+        crc = Crc16(data + position, size, crc);
+        position += size;
+      }
+      matches = matches && crc == expected;
+    }
+    CHECK(matches);
+  }
+}
+
+int main() {
+  TestCheckValue();
+  TestAgainstReference();
+  return Test::Result();
+}
@@ -0,0 +1,163 @@
+#include "FakeFlash.h"
+#include <algorithm>
+#include <cstring>
+#include "drivers/Spi.h"
+
+using namespace Pinetime::Drivers;
+
+namespace {
+  uint32_t Address(const uint8_t* command) {
+    return (command[1] << 16) | (command[2] << 8) | command[3];
+  }
+}
+
+void FakeFlash::Reset() {
+  *this = FakeFlash {};
+}
+
+void FakeFlash::StartWrite(unsigned duration, bool erase) {
+  busy = duration;
+  erasing = erase;
+}
+
+void FakeFlash::Transaction(const uint8_t* command,
+                            size_t commandSize,
+                            const uint8_t* txData,
+                            size_t txDataSize,
+                            uint8_t* rxData,
+                            size_t rxDataSize) {
+  transactions++;
+  switch (command[0]) {
+    case 0x03:
+    case 0x0B: {
+      // Read, and Fast Read with a dummy byte
+      if (commandSize != (command[0] == 0x0B ? 5U : 4U)) {
+        unknownCommands++;
+        break;
+      }
+      if (busy > 0) {
+        readsWhileBusy++;
+      }
+      const uint32_t address = Address(command);
+      std::memcpy(rxData, memory.data() + address, rxDataSize);
+      arrayReads++;
+      bytesRead += rxDataSize;
+      break;
+    }
+    case 0x05:
+      rxData[0] = (busy > 0 ? 0x01 : 0x00) | (writeEnabled ? 0x02 : 0x00);
+      if (busy > 0 && --busy == 0) {
+        writeEnabled = false;
+      }
+      break;
+    case 0x06:
+      if (busy == 0) {
+        writeEnabled = true;
+      }
+      break;
+    case 0x02: {
+      if (!writeEnabled || busy > 0) {
+        writesNotEnabled++;
+        break;
+      }
+      // The address wraps around in the page
+      const uint32_t address = Address(command);
+      const uint32_t page = address & ~(pageSize - 1);
+      if (suspended && page >= eraseAddress && page < eraseAddress + eraseSize) {
+        programsInSuspendedErase++;
+      }
+      for (size_t i = 0; i < txDataSize; i++) {
+        memory[page + ((address + i) % pageSize)] &= txData[i];
+      }
+      pagePrograms++;
+      StartWrite(programDuration, false);
+      break;
+    }
+    case 0x20:
+    case 0x52:
+    case 0xD8: {
+      if (!writeEnabled || busy > 0 || suspended) {
+        writesNotEnabled++;
+        break;
+      }
+      const uint32_t blockSize = command[0] == 0x20 ? 0x1000 : (command[0] == 0x52 ? 0x8000 : 0x10000);
+      const uint32_t address = Address(command) & ~(blockSize - 1);
+      std::fill(memory.begin() + address, memory.begin() + address + blockSize, 0xFF);
+      erases++;
+      eraseAddress = address;
+      eraseSize = blockSize;
+      StartWrite(eraseDuration, true);
+      break;
+    }
+    case 0x75:
+      // A page program is not suspended
+      if (busy > 0 && erasing) {
+        suspendedBusy = busy;
+        busy = 0;
+        suspended = true;
+      }
+      break;
+    case 0x7A:
+      if (suspended) {
+        busy = suspendedBusy;
+        erasing = true;
+        suspended = false;
+      }
+      break;
+    case 0x2B:
+      rxData[0] = 0;
+      break;
+    case 0x9F:
+      if (rxDataSize == 3) {
+        rxData[0] = 0x0B;
+        rxData[1] = 0x40;
+        rxData[2] = 0x16;
+      }
+      break;
+    case 0xB9:
+      if (busy > 0 || suspended) {
+        deepPowerDownsWhileBusy++;
+      }
+      [[fallthrough]];
+    case 0xAB:
+      std::fill(rxData, rxData + rxDataSize, 0);
+      break;
+    default:
+      unknownCommands++;
+      break;
+  }
+}
+
+Spi::Spi(SpiMaster& spiMaster, uint8_t pinCsn, SpiMaster::Priority /*priority*/) : spiMaster {spiMaster}, pinCsn {pinCsn} {
+}
+
+bool Spi::Init() {
+  return true;
+}
+
+bool Spi::Write(const uint8_t* data,
+                size_t size,
+                const std::function<void()>& /*preTransactionHook*/,
+                const std::function<void()>& transactionCompleteHook) {
+  fakeFlash.Transaction(data, size, nullptr, 0, nullptr, 0);
+  if (transactionCompleteHook != nullptr) {
+    transactionCompleteHook();
+  }
+  return true;
+}
+
+bool Spi::Read(uint8_t* cmd, size_t cmdSize, uint8_t* data, size_t dataSize) {
+  fakeFlash.Transaction(cmd, cmdSize, nullptr, 0, data, dataSize);
+  return true;
+}
+
+bool Spi::WriteCmdAndBuffer(const uint8_t* cmd, size_t cmdSize, const uint8_t* data, size_t dataSize) {
+  fakeFlash.Transaction(cmd, cmdSize, data, dataSize, nullptr, 0);
+  return true;
+}
+
+void Spi::Sleep() {
+}
+
+void Spi::Wakeup() {
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// RAM model of the SPI NOR flash. FakeFlash.cpp replaces the Spi driver, so that SpiNorFlash sends its commands to this
+// model instead of the bus.
+class FakeFlash {
+public:
+  static constexpr size_t size = 4 * 1024 * 1024;
+  static constexpr size_t pageSize = 256;
+
+  void Reset();
+  void Transaction(const uint8_t* command,
+                   size_t commandSize,
+                   const uint8_t* txData,
+                   size_t txDataSize,
+                   uint8_t* rxData,
+                   size_t rxDataSize);
+
+  std::vector<uint8_t> memory = std::vector<uint8_t>(size, 0xFF);
+
+  // Number of status register reads that report an erase or a program in progress
+  unsigned eraseDuration = 4;
+  unsigned programDuration = 1;
+
+  size_t transactions = 0;
+  size_t arrayReads = 0;
+  size_t bytesRead = 0;
+  size_t erases = 0;
+  size_t pagePrograms = 0;
+  // Protocol errors: must stay 0
+  size_t readsWhileBusy = 0;
+  size_t writesNotEnabled = 0;
+  size_t programsInSuspendedErase = 0;
+  size_t deepPowerDownsWhileBusy = 0;
+  size_t unknownCommands = 0;
+
+  bool IsEraseSuspended() const {
+    return suspended;
+  }
+
+private:
+  void StartWrite(unsigned duration, bool erase);
+
+  // Status register reads left for the erase or program in progress, and for the suspended erase
+  unsigned busy = 0;
+  unsigned suspendedBusy = 0;
+  bool erasing = false;
+  bool suspended = false;
+  uint32_t eraseAddress = 0;
+  uint32_t eraseSize = 0;
+  bool writeEnabled = false;
+};
+
+inline FakeFlash fakeFlash;
@@ -0,0 +1,225 @@
+#include "FreeRTOS/heap_4_infinitime.h"
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "task.h"
+#include "Test.h"
+
+extern "C" {
+  // Declared by portable.h in the firmware
+  void* pvPortMalloc(size_t xWantedSize);
+  void vPortFree(void* pv);
+  void* pvPortRealloc(void* pv, size_t xWantedSize);
+  size_t xPortGetFreeHeapSize(void);
+  size_t xPortGetHeapSize(void);
+
+  alignas(portBYTE_ALIGNMENT) uint8_t* fakeHeap[fakeHeapSize / sizeof(uint8_t*)];
+  TaskHandle_t fakeCurrentTask = nullptr;
+  BaseType_t fakeSchedulerState = taskSCHEDULER_NOT_STARTED;
+
+  size_t mallocFailures = 0;
+
+  void vApplicationMallocFailedHook(void) {
+    mallocFailures++;
+  }
+}
+
+namespace {
+  // Size of the block header and of the alignment, see xHeapStructSize
+  constexpr size_t headerSize = 16;
+
+  int taskDisplay;
+  int taskNimble;
+  int taskOther;
+
+  HeapStatistics_t Statistics() {
+    HeapStatistics_t statistics;
+    vPortGetHeapStatistics(&statistics);
+    return statistics;
+  }
+
+  size_t OwnedBytes(const HeapStatistics_t& statistics) {
+    size_t total = 0;
+    for (size_t owner = 0; owner < heapOWNER_COUNT; owner++) {
+      total += statistics.xOwnerBytes[owner];
+    }
+    return total;
+  }
+
+  // Allocations before the scheduler starts belong to OTHER, then to the owner of the calling task
+  void TestOwners() {
+    HeapStatistics_t statistics = Statistics();
+    CHECK(statistics.xNumberOfFreeBlocks == 0);
+
+    void* early = pvPortMalloc(10);
+    CHECK(early != nullptr);
+    statistics = Statistics();
+    // The end of the heap holds the header that ends the free list
+    const size_t usable = fakeHeapSize - headerSize;
+    CHECK(xPortGetHeapSize() == fakeHeapSize);
+    CHECK(statistics.xAvailableHeapSpaceInBytes == usable - 2 * headerSize);
+    CHECK(statistics.xOwnerBlocks[heapOWNER_OTHER] == 1);
+    CHECK(statistics.xOwnerBytes[heapOWNER_OTHER] == 2 * headerSize);
+    CHECK(statistics.xNumberOfFreeBlocks == 1);
+    CHECK(statistics.xSizeOfLargestFreeBlockInBytes == statistics.xAvailableHeapSpaceInBytes);
+
+    fakeSchedulerState = taskSCHEDULER_RUNNING;
+    fakeCurrentTask = &taskDisplay;
+    vPortHeapSetTaskOwner(heapOWNER_SCREENS);
+    fakeCurrentTask = &taskNimble;
+    vPortHeapSetTaskOwner(heapOWNER_NIMBLE);
+
+    void* nimble = pvPortMalloc(100);
+    fakeCurrentTask = &taskDisplay;
+    void* screen = pvPortMalloc(200);
+    void* lvgl = pvPortMallocLvgl(300);
+    void* explicitOther = pvPortMallocOwned(16, heapOWNER_OTHER);
+    fakeCurrentTask = &taskOther;
+    void* other = pvPortMalloc(1);
+
+    statistics = Statistics();
+    CHECK(statistics.xOwnerBlocks[heapOWNER_OTHER] == 3);
+    CHECK(statistics.xOwnerBlocks[heapOWNER_NIMBLE] == 1);
+    CHECK(statistics.xOwnerBlocks[heapOWNER_SCREENS] == 1);
+    CHECK(statistics.xOwnerBlocks[heapOWNER_LVGL] == 1);
+    CHECK(statistics.xOwnerBytes[heapOWNER_NIMBLE] == 104 + headerSize);
+    CHECK(statistics.xOwnerBytes[heapOWNER_SCREENS] == 200 + headerSize);
+    CHECK(statistics.xOwnerBytes[heapOWNER_LVGL] == 304 + headerSize);
+    CHECK(statistics.xAvailableHeapSpaceInBytes + OwnedBytes(statistics) == usable);
+    CHECK(statistics.xNumberOfSuccessfulAllocations == 6);
+
+    // A task can change its owner
+    fakeCurrentTask = &taskNimble;
+    vPortHeapSetTaskOwner(heapOWNER_LVGL);
+    void* changed = pvPortMalloc(8);
+    CHECK(Statistics().xOwnerBlocks[heapOWNER_LVGL] == 2);
+
+    for (void* block : {early, nimble, screen, lvgl, explicitOther, other, changed}) {
+      vPortFree(block);
+    }
+    statistics = Statistics();
+    for (size_t owner = 0; owner < heapOWNER_COUNT; owner++) {
+      CHECK(statistics.xOwnerBlocks[owner] == 0);
+      CHECK(statistics.xOwnerBytes[owner] == 0);
+    }
+    CHECK(statistics.xNumberOfSuccessfulFrees == 7);
+    CHECK(statistics.xNumberOfFreeBlocks == 1);
+    CHECK(statistics.xAvailableHeapSpaceInBytes == usable);
+    CHECK(statistics.xMinimumEverFreeBytesRemaining < statistics.xAvailableHeapSpaceInBytes);
+  }
+
+  // The free list reports the holes left by the freed blocks, and merges them back
+  void TestFragmentation() {
+    const size_t available = xPortGetFreeHeapSize();
+    std::vector<void*> blocks;
+    for (int i = 0; i < 8; i++) {
+      blocks.push_back(pvPortMallocOwned(112, heapOWNER_SCREENS));
+    }
+    for (size_t i = 0; i < blocks.size(); i += 2) {
+      vPortFree(blocks[i]);
+    }
+    HeapStatistics_t statistics = Statistics();
+    CHECK(statistics.xNumberOfFreeBlocks == 5);
+    CHECK(statistics.xSizeOfLargestFreeBlockInBytes == available - 8 * (112 + headerSize));
+    CHECK(statistics.xOwnerBlocks[heapOWNER_SCREENS] == 4);
+    CHECK(statistics.xAvailableHeapSpaceInBytes == available - 4 * (112 + headerSize));
+
+    // A block larger than the holes comes from the end of the heap
+    void* large = pvPortMalloc(200);
+    CHECK(static_cast<uint8_t*>(large) > static_cast<uint8_t*>(blocks.back()));
+    CHECK(Statistics().xNumberOfFreeBlocks == 5);
+    vPortFree(large);
+
+    for (size_t i = 1; i < blocks.size(); i += 2) {
+      vPortFree(blocks[i]);
+    }
+    statistics = Statistics();
+    CHECK(statistics.xNumberOfFreeBlocks == 1);
+    CHECK(statistics.xSizeOfLargestFreeBlockInBytes == available);
+  }
+
+  // Realloc keeps the data and the owner of the block
+  void TestRealloc() {
+    auto* data = static_cast<uint8_t*>(pvPortMallocOwned(24, heapOWNER_NIMBLE));
+    for (uint8_t i = 0; i < 24; i++) {
+      data[i] = i;
+    }
+    auto* grown = static_cast<uint8_t*>(pvPortRealloc(data, 100));
+    bool kept = true;
+    for (uint8_t i = 0; i < 24; i++) {
+      kept = kept && grown[i] == i;
+    }
+    CHECK(kept);
+    HeapStatistics_t statistics = Statistics();
+    CHECK(statistics.xOwnerBlocks[heapOWNER_NIMBLE] == 1);
+    CHECK(statistics.xOwnerBytes[heapOWNER_NIMBLE] == 104 + headerSize);
+
+    auto* shrunk = static_cast<uint8_t*>(pvPortRealloc(grown, 4));
+    CHECK(std::memcmp(shrunk, "\x00\x01\x02\x03", 4) == 0);
+    // Reuses the block of the first 24 bytes, the rest is too small to be split off
+    CHECK(Statistics().xOwnerBytes[heapOWNER_NIMBLE] == 24 + headerSize);
+    vPortFree(shrunk);
+    CHECK(Statistics().xOwnerBlocks[heapOWNER_NIMBLE] == 0);
+  }
+
+  // Failed allocations are not counted, and call the hook
+  void TestFailure() {
+    HeapStatistics_t before = Statistics();
+    CHECK(pvPortMalloc(fakeHeapSize) == nullptr);
+    CHECK(pvPortMalloc(static_cast<size_t>(1) << (sizeof(size_t) * 8 - 2)) == nullptr);
+    HeapStatistics_t after = Statistics();
+    CHECK(mallocFailures == 2);
+    CHECK(after.xNumberOfSuccessfulAllocations == before.xNumberOfSuccessfulAllocations);
+    CHECK(after.xAvailableHeapSpaceInBytes == before.xAvailableHeapSpaceInBytes);
+    CHECK(OwnedBytes(after) == 0);
+  }
+
+  // Random allocations and frees: the statistics match the live blocks
+  void TestRandom() {
+    const size_t available = xPortGetFreeHeapSize();
+    struct Block {
+      void* data;
+      HeapOwner_t owner;
+    };
+    std::vector<Block> blocks;
+    size_t blocksPerOwner[heapOWNER_COUNT] = {};
+    bool consistent = true;
+    std::srand(1);
+    for (int i = 0; i < 2000; i++) {
+      if (blocks.empty() || std::rand() % 3 != 0) {
+        auto owner = static_cast<HeapOwner_t>(std::rand() % heapOWNER_COUNT);
+        void* data = pvPortMallocOwned(1 + std::rand() % 256, owner);
+        if (data != nullptr) {
+          blocks.push_back({data, owner});
+          blocksPerOwner[owner]++;
+        }
+      } else {
+        size_t index = std::rand() % blocks.size();
+        vPortFree(blocks[index].data);
+        blocksPerOwner[blocks[index].owner]--;
+        blocks.erase(blocks.begin() + index);
+      }
+      HeapStatistics_t statistics = Statistics();
+      consistent = consistent && statistics.xAvailableHeapSpaceInBytes + OwnedBytes(statistics) == available &&
+                   statistics.xSizeOfLargestFreeBlockInBytes <= statistics.xAvailableHeapSpaceInBytes;
+      for (size_t owner = 0; owner < heapOWNER_COUNT; owner++) {
+        consistent = consistent && statistics.xOwnerBlocks[owner] == blocksPerOwner[owner];
+      }
+    }
+    CHECK(consistent);
+    for (const Block& block : blocks) {
+      vPortFree(block.data);
+    }
+    CHECK(Statistics().xNumberOfFreeBlocks == 1);
+    CHECK(xPortGetFreeHeapSize() == available);
+  }
+}
+
+int main() {
+  TestOwners();
+  TestFragmentation();
+  TestRealloc();
+  TestFailure();
+  TestRandom();
+  return Test::Result();
+}
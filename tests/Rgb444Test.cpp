@@ -0,0 +1,80 @@
+#include "displayapp/Rgb444.h"
+#include <vector>
+#include "Test.h"
+
+using namespace Pinetime::Components;
+
+namespace {
+  struct Rgb444 {
+    uint8_t red;
+    uint8_t green;
+    uint8_t blue;
+  };
+
+  // The 4 most significant bits of each component of the RGB565 pixel
+  Rgb444 Reference(lv_color_t pixel) {
+    const uint8_t green = (pixel.ch.green_h << 3) | pixel.ch.green_l;
+    return {static_cast<uint8_t>(pixel.ch.red >> 1), static_cast<uint8_t>(green >> 2), static_cast<uint8_t>(pixel.ch.blue >> 1)};
+  }
+
+  // Nibble n of the packed data, in the order they are sent
+  uint8_t Nibble(const std::vector<lv_color_t>& pixels, size_t n) {
+    const auto* data = reinterpret_cast<const uint8_t*>(pixels.data());
+    return (n % 2 == 0) ? data[n / 2] >> 4 : data[n / 2] & 0x0F;
+  }
+
+  bool Matches(const std::vector<lv_color_t>& packed, const std::vector<lv_color_t>& original, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+      const Rgb444 expected = Reference(original[i]);
+      if (Nibble(packed, 3 * i) != expected.red || Nibble(packed, 3 * i + 1) != expected.green ||
+          Nibble(packed, 3 * i + 2) != expected.blue) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Every RGB565 value, packed in place
+  void TestAllColors() {
+    std::vector<lv_color_t> original(0x10000);
+    for (size_t i = 0; i < original.size(); i++) {
+      original[i].full = static_cast<uint16_t>(i);
+    }
+    std::vector<lv_color_t> pixels = original;
+    CHECK(PackRgb444(pixels.data(), pixels.size()) == pixels.size() * 3 / 2);
+    CHECK(Matches(pixels, original, original.size()));
+  }
+
+  // An odd number of pixels ends with a padded byte, and the bytes after the packed data are left untouched
+  void TestCounts() {
+    for (size_t count : {1, 2, 3, 239, 240}) {
+      std::vector<lv_color_t> original(count + 1);
+      for (size_t i = 0; i < original.size(); i++) {
+        original[i] = lv_color_make(static_cast<uint8_t>(i * 37), static_cast<uint8_t>(i * 91), static_cast<uint8_t>(i * 13));
+      }
+      std::vector<lv_color_t> pixels = original;
+      const size_t written = PackRgb444(pixels.data(), count);
+      CHECK(written == (count * 3 + 1) / 2);
+      CHECK(Matches(pixels, original, count));
+      if (count % 2 == 1) {
+        CHECK(Nibble(pixels, 3 * count) == 0);
+      }
+      CHECK(pixels[count].full == original[count].full);
+    }
+  }
+
+  // Pure colors keep their most significant bits
+  void TestPrimaries() {
+    std::vector<lv_color_t> pixels {lv_color_make(0xFF, 0x00, 0x00), lv_color_make(0x00, 0xFF, 0xFF)};
+    PackRgb444(pixels.data(), pixels.size());
+    const auto* data = reinterpret_cast<const uint8_t*>(pixels.data());
+    CHECK(data[0] == 0xF0 && data[1] == 0x00 && data[2] == 0xFF);
+  }
+}
+
+int main() {
+  TestAllColors();
+  TestCounts();
+  TestPrimaries();
+  return Test::Result();
+}
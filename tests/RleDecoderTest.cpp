@@ -0,0 +1,94 @@
+#include "components/rle/RleDecoder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "displayapp/icons/infinitime/infinitime-nb.c"
+#include "Test.h"
+
+using namespace Pinetime::Tools;
+
+namespace {
+  constexpr size_t width = 240;
+  constexpr size_t height = 240;
+  constexpr size_t lineSize = width * 2;
+  constexpr uint16_t foreground = 0xF81F;
+  constexpr uint16_t background = 0x07E0;
+
+  // Pixel by pixel reference of the 1-bit RLE of tools/rle_encode.py: run lengths alternate between the background and
+  // the foreground, starting with the background
+  std::vector<uint8_t> ReferenceDecode(const uint8_t* data, size_t size) {
+    std::vector<uint8_t> pixels;
+    uint16_t color = background;
+    for (size_t i = 0; i < size; i++) {
+      for (uint8_t n = 0; n < data[i]; n++) {
+        pixels.push_back(color >> 8);
+        pixels.push_back(color & 0xFF);
+      }
+      color = (color == background) ? foreground : background;
+    }
+    return pixels;
+  }
+
+  // Decodes the whole image in calls of maxBytes, into a buffer starting offset bytes after a word boundary
+  std::vector<uint8_t> Decode(size_t maxBytes, size_t offset) {
+    RleDecoder decoder {infinitime_nb, sizeof(infinitime_nb), foreground, background};
+    std::vector<uint32_t> storage((maxBytes + offset) / sizeof(uint32_t) + 1);
+    uint8_t* buffer = reinterpret_cast<uint8_t*>(storage.data()) + offset;
+    std::vector<uint8_t> pixels;
+    while (true) {
+      size_t count = decoder.DecodeNext(buffer, maxBytes);
+      pixels.insert(pixels.end(), buffer, buffer + count);
+      if (count < maxBytes) {
+        return pixels;
+      }
+    }
+  }
+
+  // The logo shipped in the recovery firmware decodes to a full screen, whatever the number of lines per call
+  void TestRoundTrip() {
+    const std::vector<uint8_t> expected = ReferenceDecode(infinitime_nb, sizeof(infinitime_nb));
+    CHECK(expected.size() == width * height * 2);
+
+    for (size_t maxBytes : {lineSize, 4 * lineSize, 10 * lineSize, size_t {2}, size_t {6}, size_t {254}}) {
+      for (size_t offset : {0, 2}) {
+        CHECK(Decode(maxBytes, offset) == expected);
+      }
+    }
+  }
+
+  // Nothing is written past the bytes returned
+  void TestBufferBounds() {
+    RleDecoder decoder {infinitime_nb, sizeof(infinitime_nb), foreground, background};
+    uint8_t buffer[lineSize + 8];
+    std::fill(std::begin(buffer), std::end(buffer), 0xAA);
+    size_t count = decoder.DecodeNext(buffer, lineSize + 1);
+    CHECK(count == lineSize);
+    CHECK(buffer[lineSize] == 0xAA);
+  }
+
+  void Benchmark() {
+    constexpr size_t linesPerCall = 4;
+    constexpr int iterations = 200;
+    uint32_t storage[linesPerCall * lineSize / sizeof(uint32_t)];
+    auto* buffer = reinterpret_cast<uint8_t*>(storage);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+      RleDecoder decoder {infinitime_nb, sizeof(infinitime_nb), foreground, background};
+      while (decoder.DecodeNext(buffer, sizeof(storage)) == sizeof(storage)) {
+      }
+    }
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    std::printf("Logo decoded %d lines per call: %.1f us per frame (host)\n",
+                static_cast<int>(linesPerCall),
+                static_cast<double>(duration.count()) / iterations);
+  }
+}
+
+int main() {
+  TestRoundTrip();
+  TestBufferBounds();
+  Benchmark();
+  return Test::Result();
+}
@@ -0,0 +1,323 @@
+#include "drivers/SpiMaster.h"
+#include <hal/nrf_gpio.h>
+#include <hal/nrf_spim.h>
+#include <cstdint>
+#include <vector>
+#include "Test.h"
+
+using namespace Pinetime::Drivers;
+
+namespace {
+  constexpr SpiMaster::Parameters parameters {SpiMaster::BitOrder::Msb_Lsb,
+                                              SpiMaster::Modes::Mode3,
+                                              SpiMaster::Frequencies::Freq8Mhz,
+                                              2,
+                                              3,
+                                              4};
+  constexpr uint8_t pinDisplayCsn = 25;
+  constexpr uint8_t pinFlashCsn = 5;
+
+  uint32_t Address(const void* buffer) {
+    return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(buffer));
+  }
+
+  // Contiguous bytes put on the wire (or received) by EasyDMA
+  struct Segment {
+    uint32_t address;
+    size_t size;
+    bool received;
+
+    bool operator==(const Segment&) const = default;
+  };
+
+  // Plays the SPIM0 and TIMER3: completes the transfer started by the driver and calls the interrupt handlers
+  // of main.cpp for the interrupts it enabled
+  class FakeBus {
+  public:
+    explicit FakeBus(SpiMaster& spi) : spi {spi} {
+    }
+
+    // Returns false if no transfer was started
+    bool Step() {
+      if (fakeSpim0.TASKS_START == 0) {
+        return false;
+      }
+      fakeSpim0.TASKS_START = 0;
+      transfers++;
+
+      const bool received = fakeSpim0.RXD.MAXCNT != 0;
+      const auto& buffer = received ? fakeSpim0.RXD : fakeSpim0.TXD;
+      size_t nbChunks = 1;
+      const bool list = buffer.LIST == SPIM_TXD_LIST_LIST_ArrayList;
+      if (list) {
+        // The END event restarts the SPIM through the PPI group until COMPARE[0] disables it
+        nbChunks = fakeTimer3.CC[0] + 1;
+      }
+      Record(buffer.PTR, buffer.MAXCNT * nbChunks, received);
+
+      const bool endInterrupt = (fakeSpim0.INTEN & SPIM_INTENSET_END_Msk) != 0;
+      if (endInterrupt) {
+        interrupts += nbChunks;
+      }
+      if (list) {
+        CHECK(fakeTimer3.CC[1] == nbChunks);
+        interrupts++;
+        fakeTimer3.EVENTS_COMPARE[1] = 0;
+        spi.OnEndEvent();
+      } else if (endInterrupt) {
+        fakeSpim0.EVENTS_END = 0;
+        spi.OnEndEvent();
+      }
+      return true;
+    }
+
+    void RunUntilIdle() {
+      while (Step()) {
+      }
+    }
+
+    std::vector<Segment> segments;
+    size_t bytes = 0;
+    size_t transfers = 0;
+    size_t interrupts = 0;
+
+  private:
+    void Record(uint32_t address, size_t size, bool received) {
+      bytes += size;
+      if (!segments.empty()) {
+        Segment& last = segments.back();
+        if (last.received == received && last.address + last.size == address) {
+          last.size += size;
+          return;
+        }
+      }
+      segments.push_back({address, size, received});
+    }
+
+    SpiMaster& spi;
+  };
+
+  // The completion hook of a transaction is called once, when its last byte is sent: the chip select is already released and
+  // the next transaction already started, so that the wire doesn't wait for the hook (LittleVgl renders the next band in it).
+  void TestCompletionHook() {
+    SpiMaster spi {SpiMaster::SpiModule::SPI0, parameters};
+    CHECK(spi.Init());
+    FakeBus bus {spi};
+
+    static uint8_t command[] = {0x2c};
+    static uint8_t pixels[240 * 2];
+    nrf_gpio_pin_set(pinDisplayCsn);
+    nrf_gpio_pin_set(pinFlashCsn);
+
+    struct {
+      int calls = 0;
+      size_t bytes = 0;
+      bool csnReleased = false;
+      bool nextStarted = false;
+    } display, flash;
+
+    SpiMaster::Transaction displayTransaction;
+    displayTransaction.pinCsn = pinDisplayCsn;
+    displayTransaction.command = command;
+    displayTransaction.commandSize = sizeof(command);
+    displayTransaction.txData = pixels;
+    displayTransaction.txDataSize = sizeof(pixels);
+    displayTransaction.transactionCompleteHook = [&]() {
+      display.calls++;
+      display.bytes = bus.bytes;
+      display.csnReleased = fakeGpio[pinDisplayCsn];
+      display.nextStarted = !fakeGpio[pinFlashCsn] && fakeSpim0.TASKS_START == 1;
+    };
+
+    static uint8_t readCommand[] = {0x03, 0x00, 0x10, 0x00};
+    static uint8_t data[16];
+    SpiMaster::Transaction flashTransaction;
+    flashTransaction.pinCsn = pinFlashCsn;
+    flashTransaction.command = readCommand;
+    flashTransaction.commandSize = sizeof(readCommand);
+    flashTransaction.rxData = data;
+    flashTransaction.rxDataSize = sizeof(data);
+    flashTransaction.transactionCompleteHook = [&]() {
+      flash.calls++;
+      flash.bytes = bus.bytes;
+      flash.csnReleased = fakeGpio[pinFlashCsn];
+      flash.nextStarted = fakeSpim0.TASKS_START == 1;
+    };
+
+    spi.Submit(&displayTransaction);
+    spi.Submit(&flashTransaction);
+    CHECK(!fakeGpio[pinDisplayCsn]);
+    CHECK(fakeGpio[pinFlashCsn]);
+    bus.RunUntilIdle();
+
+    CHECK(display.calls == 1);
+    CHECK(display.bytes == sizeof(command) + sizeof(pixels));
+    CHECK(display.csnReleased);
+    CHECK(display.nextStarted);
+    CHECK(flash.calls == 1);
+    CHECK(flash.bytes == display.bytes + sizeof(readCommand) + sizeof(data));
+    CHECK(flash.csnReleased);
+    CHECK(!flash.nextStarted);
+
+    const std::vector<Segment> expected {{Address(command), sizeof(command), false},
+                                         {Address(pixels), sizeof(pixels), false},
+                                         {Address(readCommand), sizeof(readCommand), false},
+                                         {Address(data), sizeof(data), true}};
+    CHECK(bus.segments == expected);
+  }
+
+  // The descriptor is released to its owner by the hook, which can submit it again right away
+  void TestSubmitFromCompletionHook() {
+    SpiMaster spi {SpiMaster::SpiModule::SPI0, parameters};
+    CHECK(spi.Init());
+    FakeBus bus {spi};
+
+    static uint8_t bands[3][64];
+    int band = 0;
+    SpiMaster::Transaction transaction;
+    transaction.pinCsn = pinDisplayCsn;
+    transaction.txData = bands[0];
+    transaction.txDataSize = sizeof(bands[0]);
+    transaction.transactionCompleteHook = [&]() {
+      if (++band < 3) {
+        transaction.txData = bands[band];
+        spi.Submit(&transaction);
+      }
+    };
+
+    spi.Submit(&transaction);
+    bus.RunUntilIdle();
+
+    CHECK(band == 3);
+    CHECK(fakeGpio[pinDisplayCsn]);
+    CHECK(bus.bytes == sizeof(bands));
+    CHECK(bus.transfers == 3);
+  }
+
+  struct ListResult {
+    size_t transfers;
+    size_t interrupts;
+  };
+
+  // Sends (or receives) size bytes and checks that they are transferred in order, once
+  ListResult Transfer(size_t size, bool receive) {
+    SpiMaster spi {SpiMaster::SpiModule::SPI0, parameters};
+    CHECK(spi.Init());
+    FakeBus bus {spi};
+
+    static uint8_t buffer[240 * 240 * 2];
+    SpiMaster::Transaction transaction;
+    transaction.pinCsn = pinDisplayCsn;
+    if (receive) {
+      transaction.rxData = buffer;
+      transaction.rxDataSize = size;
+    } else {
+      transaction.txData = buffer;
+      transaction.txDataSize = size;
+    }
+    int completed = 0;
+    transaction.transactionCompleteHook = [&]() {
+      completed++;
+    };
+
+    spi.Submit(&transaction);
+    bus.RunUntilIdle();
+
+    CHECK(completed == 1);
+    const std::vector<Segment> expected {{Address(buffer), size, receive}};
+    CHECK(bus.segments == expected);
+    // Back to single transfers
+    CHECK((fakeSpim0.INTEN & SPIM_INTENSET_END_Msk) != 0);
+    CHECK(fakeSpim0.TXD.LIST == 0);
+    CHECK(fakeSpim0.RXD.LIST == 0);
+    CHECK(fakePpi.enabledChannels == 0);
+    return {bus.transfers, bus.interrupts};
+  }
+
+  // Buffers larger than 255 bytes are sent in a single list transfer of equal chunks, with a single interrupt, followed by a
+  // single transfer of the remainder if no chunk size from 128 to 255 bytes divides the size
+  void TestListTransfers() {
+    ListResult result = Transfer(255, false);
+    CHECK(result.transfers == 1);
+    CHECK(result.interrupts == 1);
+
+    // 2 * 150
+    result = Transfer(300, false);
+    CHECK(result.transfers == 1);
+    CHECK(result.interrupts == 1);
+
+    // 1009 is prime: 3 * 255, then 244
+    result = Transfer(1009, false);
+    CHECK(result.transfers == 2);
+    CHECK(result.interrupts == 2);
+
+    // 32 * 128, from the flash
+    result = Transfer(4096, true);
+    CHECK(result.transfers == 1);
+    CHECK(result.interrupts == 1);
+
+    // A full frame is 480 * 240: one interrupt instead of one per 255 bytes
+    constexpr size_t frameSize = 240 * 240 * 2;
+    result = Transfer(frameSize, false);
+    CHECK(result.transfers == 1);
+    CHECK(result.interrupts == 1);
+    std::printf("Full frame (%zu bytes): %zu transfer(s), %zu interrupt(s), was %zu\n",
+                frameSize,
+                result.transfers,
+                result.interrupts,
+                (frameSize + 254) / 255);
+  }
+
+  // The transaction in progress is never interrupted, the queued ones start by priority then in submission order
+  void TestPriorities() {
+    SpiMaster spi {SpiMaster::SpiModule::SPI0, parameters};
+    CHECK(spi.Init());
+    FakeBus bus {spi};
+
+    static uint8_t buffers[6][300];
+    SpiMaster::Transaction transactions[6];
+    std::vector<int> order;
+    for (int i = 0; i < 6; i++) {
+      transactions[i].pinCsn = i < 3 ? pinDisplayCsn : pinFlashCsn;
+      transactions[i].priority = i < 3 ? SpiMaster::Priority::Normal : SpiMaster::Priority::High;
+      transactions[i].txData = buffers[i];
+      transactions[i].txDataSize = sizeof(buffers[i]);
+      transactions[i].transactionCompleteHook = [&order, i]() {
+        order.push_back(i);
+      };
+    }
+    // Submitted from a completion hook, while the other high priority transaction is queued
+    transactions[3].transactionCompleteHook = [&]() {
+      order.push_back(3);
+      spi.Submit(&transactions[5]);
+    };
+
+    spi.Submit(&transactions[0]);
+    spi.Submit(&transactions[1]);
+    spi.Submit(&transactions[3]);
+    spi.Submit(&transactions[2]);
+    spi.Submit(&transactions[4]);
+    bus.RunUntilIdle();
+
+    const std::vector<int> expected {0, 3, 4, 5, 1, 2};
+    CHECK(order == expected);
+    CHECK(bus.bytes == sizeof(buffers));
+    CHECK(fakeGpio[pinDisplayCsn]);
+    CHECK(fakeGpio[pinFlashCsn]);
+
+    // The queues are empty: the next transaction starts right away
+    order.clear();
+    spi.Submit(&transactions[1]);
+    CHECK(!fakeGpio[pinDisplayCsn]);
+    bus.RunUntilIdle();
+    CHECK(order == std::vector<int> {1});
+  }
+}
+
+int main() {
+  TestCompletionHook();
+  TestSubmitFromCompletionHook();
+  TestListTransfers();
+  TestPriorities();
+  return Test::Result();
+}
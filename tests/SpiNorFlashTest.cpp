@@ -0,0 +1,200 @@
+#include "drivers/SpiNorFlash.h"
+#include <algorithm>
+#include <cstring>
+#include "drivers/Spi.h"
+#include "FakeFlash.h"
+#include "task.h"
+#include "Test.h"
+
+using namespace Pinetime::Drivers;
+
+namespace {
+  SpiMaster spiMaster {SpiMaster::SpiModule::SPI0, {}};
+  Spi flashSpi {spiMaster, 5, SpiMaster::Priority::High};
+
+  void FillPattern() {
+    fakeFlash.Reset();
+    for (size_t i = 0; i < FakeFlash::size; i++) {
+      fakeFlash.memory[i] = static_cast<uint8_t>(i * 7 + (i >> 8));
+    }
+  }
+
+  bool Matches(uint32_t address, const uint8_t* data, size_t size) {
+    return std::memcmp(fakeFlash.memory.data() + address, data, size) == 0;
+  }
+
+  // Sequential small reads (littlefs reads 16 bytes at a time) are served from the read-ahead buffer, one Fast Read per
+  // 256 bytes. Reads outside of the buffer refill it, large reads go straight to the destination.
+  void TestReadAhead() {
+    FillPattern();
+    SpiNorFlash flash {flashSpi};
+
+    uint8_t data[1024];
+    bool correct = true;
+    for (uint32_t address = 0x1000; address < 0x2000; address += 16) {
+      flash.Read(address, data, 16);
+      correct = correct && Matches(address, data, 16);
+    }
+    CHECK(correct);
+    CHECK(fakeFlash.arrayReads == 0x1000 / 256);
+    std::printf("4 KB in 16 byte reads: %zu flash reads, %zu bytes\n", fakeFlash.arrayReads, fakeFlash.bytesRead);
+
+    // Crosses the end of the buffer
+    size_t arrayReads = fakeFlash.arrayReads;
+    flash.Read(0x1FF8, data, 16);
+    CHECK(Matches(0x1FF8, data, 16));
+    CHECK(fakeFlash.arrayReads == arrayReads + 1);
+
+    // Before the buffer
+    flash.Read(0x1000, data, 16);
+    CHECK(Matches(0x1000, data, 16));
+    CHECK(fakeFlash.arrayReads == arrayReads + 2);
+    // Within the buffer that starts at 0x1000
+    flash.Read(0x10F0, data, 16);
+    CHECK(Matches(0x10F0, data, 16));
+    CHECK(fakeFlash.arrayReads == arrayReads + 2);
+
+    // Large read, not buffered
+    flash.Read(0x3001, data, sizeof(data));
+    CHECK(Matches(0x3001, data, sizeof(data)));
+    CHECK(fakeFlash.arrayReads == arrayReads + 3);
+    CHECK(fakeFlash.bytesRead == 0x1000 + 2 * 256 + sizeof(data));
+
+    CHECK(fakeFlash.unknownCommands == 0);
+  }
+
+  // The buffer is invalidated when the flash is modified
+  void TestReadAheadInvalidation() {
+    FillPattern();
+    SpiNorFlash flash {flashSpi};
+
+    uint8_t data[16];
+    flash.Read(0x5000, data, sizeof(data));
+    flash.SectorErase(0x5000);
+    flash.Read(0x5000, data, sizeof(data));
+    CHECK(Matches(0x5000, data, sizeof(data)));
+    CHECK(data[0] == 0xFF && data[15] == 0xFF);
+
+    const uint8_t written[] = {0x00, 0x01, 0x02, 0x03};
+    flash.Write(0x5004, written, sizeof(written));
+    flash.Read(0x5000, data, sizeof(data));
+    CHECK(Matches(0x5000, data, sizeof(data)));
+    CHECK(std::memcmp(data + 4, written, sizeof(written)) == 0);
+
+    CHECK(fakeFlash.readsWhileBusy == 0);
+    CHECK(fakeFlash.writesNotEnabled == 0);
+    CHECK(fakeFlash.unknownCommands == 0);
+  }
+
+  bool Erased(uint32_t address, size_t size) {
+    return std::all_of(fakeFlash.memory.begin() + address, fakeFlash.memory.begin() + address + size, [](uint8_t byte) {
+      return byte == 0xFF;
+    });
+  }
+
+  void CheckProtocol() {
+    CHECK(fakeFlash.readsWhileBusy == 0);
+    CHECK(fakeFlash.writesNotEnabled == 0);
+    CHECK(fakeFlash.programsInSuspendedErase == 0);
+    CHECK(fakeFlash.deepPowerDownsWhileBusy == 0);
+    CHECK(fakeFlash.unknownCommands == 0);
+    CHECK(!fakeFlash.IsEraseSuspended());
+  }
+
+  // The timer task polls the asynchronous operation while the test waits
+  void RunTimerTask() {
+    RunFakeTimerTask();
+  }
+
+  // The DFU slot is erased in the background. A settings write elsewhere programs its pages while the block erase is
+  // suspended, an erase elsewhere only waits for the block being erased: neither waits for the whole slot.
+  void TestOperationsDuringAsyncErase() {
+    FillPattern();
+    std::fill(fakeFlash.memory.begin() + 0x3FF000, fakeFlash.memory.end(), 0xFF);
+    fakeFlash.eraseDuration = 50;
+    SpiNorFlash flash {flashSpi};
+    fakeOtherTasks = RunTimerTask;
+
+    bool completed = false;
+    bool success = false;
+    constexpr uint32_t slotAddress = 0x40000;
+    constexpr size_t slotSize = 0x70000;
+    CHECK(flash.EraseAsync(slotAddress, slotSize, [&](bool result) {
+      completed = true;
+      success = result;
+    }));
+    CHECK(fakeFlash.erases == 1);
+
+    uint8_t written[300];
+    for (size_t i = 0; i < sizeof(written); i++) {
+      written[i] = static_cast<uint8_t>(i);
+    }
+    flash.Write(0x3FF0F0, written, sizeof(written));
+    CHECK(fakeFlash.pagePrograms == 3);
+    CHECK(fakeFlash.erases == 1);
+    CHECK(Matches(0x3FF0F0, written, sizeof(written)));
+
+    const TickType_t start = fakeTickCount;
+    flash.Erase(0x3FE000, 0x1000);
+    std::printf("Erase during the erase of the slot: %u ticks\n", static_cast<unsigned>(fakeTickCount - start));
+    CHECK(fakeFlash.erases == 2);
+    CHECK(Erased(0x3FE000, 0x1000));
+    CHECK(flash.IsBusy());
+
+    // A write in the block being erased waits for it
+    fakeOtherTasks = nullptr;
+    RunFakeTimers();
+    CHECK(fakeFlash.erases == 3);
+    fakeOtherTasks = RunTimerTask;
+    flash.Write(slotAddress + 0x10010, written, 16);
+    CHECK(fakeFlash.erases == 3);
+    CHECK(Matches(slotAddress + 0x10010, written, 16));
+
+    fakeOtherTasks = nullptr;
+    while (RunFakeTimers()) {
+    }
+    CHECK(completed && success);
+    CHECK(fakeFlash.erases == 1 + slotSize / 0x10000);
+    CHECK(Erased(slotAddress, 0x10010) && Erased(slotAddress + 0x10020, slotSize - 0x10020));
+    CHECK(Matches(slotAddress + 0x10010, written, 16));
+    CheckProtocol();
+  }
+
+  // Sleep() only waits for the block being erased, the rest of the asynchronous erase goes on after Wakeup()
+  void TestSleepDuringAsyncErase() {
+    FillPattern();
+    fakeFlash.eraseDuration = 50;
+    SpiNorFlash flash {flashSpi};
+    fakeOtherTasks = RunTimerTask;
+
+    bool completed = false;
+    CHECK(flash.EraseAsync(0x40000, 0x40000, [&](bool) {
+      completed = true;
+    }));
+    flash.Sleep();
+    CHECK(fakeFlash.erases == 1);
+    CHECK(flash.IsBusy());
+    fakeOtherTasks = nullptr;
+    for (int i = 0; i < 100; i++) {
+      RunFakeTimers();
+    }
+    CHECK(fakeFlash.erases == 1);
+
+    flash.Wakeup();
+    while (RunFakeTimers()) {
+    }
+    CHECK(completed);
+    CHECK(fakeFlash.erases == 4);
+    CHECK(!flash.IsBusy());
+    CHECK(Erased(0x40000, 0x40000));
+    CheckProtocol();
+  }
+}
+
+int main() {
+  TestReadAhead();
+  TestReadAheadInvalidation();
+  TestOperationsDuringAsyncErase();
+  TestSleepDuringAsyncErase();
+  return Test::Result();
+}
@@ -0,0 +1,240 @@
+#include "displayapp/StreamingFont.h"
+#include <cstring>
+#include <vector>
+#include "Test.h"
+
+using namespace Pinetime::Components;
+
+namespace {
+  constexpr const char* fontPath = "F:/fonts/digits.bin";
+  constexpr char symbols[] = "0123456789:";
+  constexpr uint8_t digitWidth = 40;
+  constexpr uint8_t digitHeight = 80;
+  constexpr uint8_t colonWidth = 12;
+  constexpr uint8_t colonHeight = 48;
+  constexpr uint8_t colonOffsetY = 16;
+  constexpr uint8_t advanceWidthBits = 8;
+  constexpr uint8_t xyBits = 6;
+  constexpr uint8_t whBits = 7;
+
+  // Header of the "head" table written by lv_font_conv --format bin
+  struct __attribute__((packed)) FontHeader {
+    uint32_t version;
+    uint16_t tablesCount;
+    uint16_t fontSize;
+    uint16_t ascent;
+    int16_t descent;
+    uint16_t typoAscent;
+    int16_t typoDescent;
+    uint16_t typoLineGap;
+    int16_t minY;
+    int16_t maxY;
+    uint16_t defaultAdvanceWidth;
+    uint16_t kerningScale;
+    uint8_t indexToLocFormat;
+    uint8_t glyphIdFormat;
+    uint8_t advanceWidthFormat;
+    uint8_t bitsPerPixel;
+    uint8_t xyBits;
+    uint8_t whBits;
+    uint8_t advanceWidthBits;
+    uint8_t compressionId;
+    uint8_t subpixelsMode;
+    uint8_t padding;
+  };
+
+  struct __attribute__((packed)) CmapTable {
+    uint32_t dataOffset;
+    uint32_t rangeStart;
+    uint16_t rangeLength;
+    uint16_t glyphIdStart;
+    uint16_t dataEntriesCount;
+    uint8_t formatType;
+    uint8_t padding;
+  };
+
+  // Packs values MSB first, like the glyph metrics and the 1 bpp bitmaps
+  class BitWriter {
+  public:
+    void Write(uint32_t value, uint8_t bits) {
+      while (bits-- > 0) {
+        if (position % 8 == 0) {
+          data.push_back(0);
+        }
+        data.back() |= ((value >> bits) & 1) << (7 - position % 8);
+        position++;
+      }
+    }
+
+    std::vector<uint8_t> data;
+
+  private:
+    size_t position = 0;
+  };
+
+  uint8_t Width(char letter) {
+    return letter == ':' ? colonWidth : digitWidth;
+  }
+
+  uint8_t Height(char letter) {
+    return letter == ':' ? colonHeight : digitHeight;
+  }
+
+  void WriteBitmap(BitWriter& writer, char letter) {
+    for (uint8_t y = 0; y < Height(letter); y++) {
+      for (uint8_t x = 0; x < Width(letter); x++) {
+        writer.Write((x * 3 + y * 5 + letter * 7) % 11 < 5, 1);
+      }
+    }
+  }
+
+  std::vector<uint8_t> Bitmap(char letter) {
+    BitWriter writer;
+    WriteBitmap(writer, letter);
+    return writer.data;
+  }
+
+  template <typename T>
+  void Append(std::vector<uint8_t>& file, const T& value) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+    file.insert(file.end(), bytes, bytes + sizeof(T));
+  }
+
+  void AppendTableHeader(std::vector<uint8_t>& file, uint32_t length, const char* label) {
+    Append(file, length);
+    file.insert(file.end(), label, label + 4);
+  }
+
+  // A font of big digits, in the format of lv_font_conv --format bin --bpp 1 --no-compress. The metrics of each glyph
+  // take 34 bits, so the bitmaps don't start on a byte boundary.
+  std::vector<uint8_t> DigitsFont() {
+    std::vector<uint8_t> file;
+    FontHeader header {};
+    header.version = 1;
+    header.tablesCount = 4;
+    header.fontSize = digitHeight;
+    header.ascent = digitHeight;
+    header.indexToLocFormat = 1;
+    header.bitsPerPixel = 1;
+    header.xyBits = xyBits;
+    header.whBits = whBits;
+    header.advanceWidthBits = advanceWidthBits;
+    AppendTableHeader(file, 8 + sizeof(FontHeader), "head");
+    Append(file, header);
+
+    // All the symbols are consecutive code points, glyph 0 is reserved
+    constexpr uint32_t glyphCount = sizeof(symbols);
+    AppendTableHeader(file, 8 + 4 + sizeof(CmapTable), "cmap");
+    Append(file, uint32_t {1});
+    Append(file, CmapTable {0, '0', glyphCount - 1, 1, 0, 2, 0});
+
+    std::vector<uint8_t> glyphs;
+    std::vector<uint32_t> offsets {8, 8};
+    for (const char* letter = symbols; *letter != 0; letter++) {
+      BitWriter writer;
+      writer.Write(Width(*letter) + 4, advanceWidthBits);
+      writer.Write(0, xyBits);
+      writer.Write(*letter == ':' ? colonOffsetY : 0, xyBits);
+      writer.Write(Width(*letter), whBits);
+      writer.Write(Height(*letter), whBits);
+      WriteBitmap(writer, *letter);
+      glyphs.insert(glyphs.end(), writer.data.begin(), writer.data.end());
+      offsets.push_back(8 + glyphs.size());
+    }
+    offsets.pop_back();
+
+    AppendTableHeader(file, 8 + 4 + glyphCount * sizeof(uint32_t), "loca");
+    Append(file, glyphCount);
+    for (uint32_t offset : offsets) {
+      Append(file, offset);
+    }
+    AppendTableHeader(file, 8 + glyphs.size(), "glyf");
+    file.insert(file.end(), glyphs.begin(), glyphs.end());
+    return file;
+  }
+
+  // Draws the part of a label in the band [top, bottom] the way lv_draw_label() does: the bitmap of each letter that
+  // crosses the band is fetched. Returns false if a bitmap is wrong.
+  bool DrawBand(const lv_font_t* font, const char* text, lv_coord_t labelTop, lv_coord_t top, lv_coord_t bottom) {
+    bool correct = true;
+    for (const char* letter = text; *letter != 0; letter++) {
+      lv_font_glyph_dsc_t glyph;
+      if (!font->get_glyph_dsc(font, &glyph, *letter, letter[1])) {
+        return false;
+      }
+      lv_coord_t glyphTop = labelTop + font->line_height - font->base_line - glyph.box_h - glyph.ofs_y;
+      if (glyphTop > bottom || glyphTop + glyph.box_h - 1 < top) {
+        continue;
+      }
+      const uint8_t* bitmap = font->get_glyph_bitmap(font, *letter);
+      const std::vector<uint8_t> expected = Bitmap(*letter);
+      correct = correct && bitmap != nullptr && std::memcmp(bitmap, expected.data(), expected.size()) == 0;
+    }
+    return correct;
+  }
+
+  // Draws a label in bands of 4 lines, the size of the draw buffers of LittleVgl
+  bool DrawFrame(const lv_font_t* font, const char* text) {
+    constexpr lv_coord_t labelTop = 80;
+    bool correct = true;
+    for (lv_coord_t top = 0; top < LV_VER_RES; top += 4) {
+      correct = DrawBand(font, text, labelTop, top, top + 3) && correct;
+    }
+    return correct;
+  }
+
+  // A time is drawn in 20 bands, which all cross its 5 glyphs: each bitmap is read once, from the file opened by Load()
+  void TestLabelAcrossBands() {
+    fakeFiles[fontPath] = DigitsFont();
+    fakeFileOpens = 0;
+    lv_font_t* font = StreamingFont::Load(fontPath);
+    CHECK(font != nullptr);
+    CHECK(StreamingFont::Owns(font));
+    CHECK(font->line_height == digitHeight);
+
+    size_t reads = fakeFileReads;
+    CHECK(DrawFrame(font, "12:34"));
+    std::printf("12:34 in bands of 4 lines: %zu reads\n", fakeFileReads - reads);
+    CHECK(fakeFileReads - reads == 5);
+
+    // The next frame is drawn from the cache
+    reads = fakeFileReads;
+    CHECK(DrawFrame(font, "12:34"));
+    CHECK(fakeFileReads == reads);
+
+    // A digit changes: the new glyph is read. The colon, which doesn't cross the top bands, can be evicted and read again.
+    reads = fakeFileReads;
+    CHECK(DrawFrame(font, "12:35"));
+    CHECK(fakeFileReads - reads <= 2);
+    CHECK(fakeFileOpens == 1);
+
+    // The cache and the open file are part of the size of the font
+    const size_t bitmapSize = (digitWidth * digitHeight + 2 + 7) / 8;
+    CHECK(StreamingFont::Size(font) > 5 * bitmapSize + fakeFileDriver.file_size);
+    StreamingFont::Free(font);
+  }
+
+  // Invalid files are rejected, the file opened to parse them is closed
+  void TestInvalidFiles() {
+    CHECK(StreamingFont::Load("F:/fonts/missing.bin") == nullptr);
+
+    std::vector<uint8_t> truncated = DigitsFont();
+    truncated.resize(truncated.size() / 2);
+    fakeFiles["F:/fonts/truncated.bin"] = truncated;
+    CHECK(StreamingFont::Load("F:/fonts/truncated.bin") == nullptr);
+
+    std::vector<uint8_t> corrupted = DigitsFont();
+    corrupted[4] = 'x';
+    fakeFiles["F:/fonts/corrupted.bin"] = corrupted;
+    CHECK(StreamingFont::Load("F:/fonts/corrupted.bin") == nullptr);
+
+    CHECK(StreamingFont::Size(nullptr) == 0);
+    CHECK(!StreamingFont::Owns(nullptr));
+  }
+}
+
+int main() {
+  TestLabelAcrossBands();
+  TestInvalidFiles();
+  return Test::Result();
+}
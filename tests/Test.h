@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdio>
+
+// Minimal checks for the host tests: failures are reported and counted, the test returns a non-zero status if any failed
+namespace Test {
+  inline int failures = 0;
+
+  inline int Result() {
+    if (failures != 0) {
+      std::printf("%d check(s) failed\n", failures);
+      return 1;
+    }
+    std::printf("All checks passed\n");
+    return 0;
+  }
+}
+
+#define CHECK(condition)                                                                                                               \
+  do {                                                                                                                                 \
+    if (!(condition)) {                                                                                                                \
+      std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);                                                        \
+      Test::failures++;                                                                                                                \
+    }                                                                                                                                  \
+  } while (0)
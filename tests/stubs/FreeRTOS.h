@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+
+// Host build: the tests run in a single thread. Critical sections have nothing to protect, and the tick count only
+// advances when a task delays.
+using TickType_t = uint32_t;
+using BaseType_t = long;
+using UBaseType_t = unsigned long;
+
+#define pdFALSE            0
+#define pdTRUE             1
+#define pdPASS             pdTRUE
+#define portMAX_DELAY      ((TickType_t) 0xffffffffUL)
+#define configTICK_RATE_HZ 1024
+
+inline TickType_t fakeTickCount = 0;
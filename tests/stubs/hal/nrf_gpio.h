@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include "nrf.h"
+
+enum nrf_gpio_pin_pull_t { NRF_GPIO_PIN_NOPULL, NRF_GPIO_PIN_PULLDOWN, NRF_GPIO_PIN_PULLUP };
+
+// Output level of each pin
+inline bool fakeGpio[32] = {};
+
+inline void nrf_gpio_pin_set(uint32_t pin) {
+  fakeGpio[pin] = true;
+}
+
+inline void nrf_gpio_pin_clear(uint32_t pin) {
+  fakeGpio[pin] = false;
+}
+
+inline void nrf_gpio_cfg_output(uint32_t) {
+}
+
+inline void nrf_gpio_cfg_input(uint32_t, nrf_gpio_pin_pull_t) {
+}
+
+inline void nrf_gpio_cfg_default(uint32_t) {
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Host build of heap_4_infinitime.c, which is C: the configuration of FreeRTOSConfig.h and portmacro_cmsis.h that the
+heap uses, and a heap region that replaces the one of the linker script. */
+typedef long BaseType_t;
+typedef void* TaskHandle_t;
+
+#define configSUPPORT_DYNAMIC_ALLOCATION 1
+#define configUSE_MALLOC_FAILED_HOOK     1
+#define configASSERT(x)                  assert(x)
+#define portBYTE_ALIGNMENT               8
+#define portBYTE_ALIGNMENT_MASK          (0x0007)
+#define mtCOVERAGE_TEST_MARKER()
+#define traceMALLOC(pvAddress, uiSize)
+#define traceFREE(pvAddress, uiSize)
+
+/* nrf_common.ld places the heap between __HeapLimit and __StackLimit, the host heap is fakeHeap[] */
+#define fakeHeapSize (16 * 1024)
+#define __HeapLimit  fakeHeap[0]
+#define __StackLimit fakeHeap[fakeHeapSize / sizeof(uint8_t*)]
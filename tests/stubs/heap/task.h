@@ -0,0 +1,33 @@
+#pragma once
+#include <assert.h>
+#include "FreeRTOS.h"
+
+/* The tests run in a single thread and choose the task that allocates */
+#define taskSCHEDULER_NOT_STARTED ((BaseType_t) 1)
+#define taskSCHEDULER_RUNNING     ((BaseType_t) 2)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern TaskHandle_t fakeCurrentTask;
+extern BaseType_t fakeSchedulerState;
+
+#ifdef __cplusplus
+}
+#endif
+
+static inline TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+  return fakeCurrentTask;
+}
+
+static inline BaseType_t xTaskGetSchedulerState(void) {
+  return fakeSchedulerState;
+}
+
+static inline void vTaskSuspendAll(void) {
+}
+
+static inline BaseType_t xTaskResumeAll(void) {
+  return 0;
+}
@@ -0,0 +1,8 @@
+#pragma once
+#include <cstdint>
+
+inline void nrf_delay_ms(uint32_t) {
+}
+
+inline void nrf_delay_us(uint32_t) {
+}
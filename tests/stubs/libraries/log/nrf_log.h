@@ -0,0 +1,2 @@
+#pragma once
+#include "nrfx_log.h"
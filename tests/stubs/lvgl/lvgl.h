@@ -0,0 +1,411 @@
+#pragma once
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+// The parts of the LVGL v7 API used by the code under test, with the configuration of lv_conf.h (16 bits swapped colors).
+// The file system keeps the files in memory, in fakeFiles, and counts the files opened and read. The areas invalidated
+// and the lines drawn are recorded.
+
+#define LV_HOR_RES_MAX 240
+#define LV_VER_RES_MAX 240
+#define LV_COLOR_DEPTH 16
+#define LV_COLOR_16_SWAP 1
+
+typedef int16_t lv_coord_t;
+typedef uint8_t lv_opa_t;
+
+enum { LV_RES_INV = 0, LV_RES_OK };
+typedef uint8_t lv_res_t;
+
+typedef union {
+  struct {
+    uint16_t green_h : 3;
+    uint16_t red : 5;
+    uint16_t blue : 5;
+    uint16_t green_l : 3;
+  } ch;
+
+  uint16_t full;
+} lv_color_t;
+
+typedef union {
+  struct {
+    uint8_t blue;
+    uint8_t green;
+    uint8_t red;
+    uint8_t alpha;
+  } ch;
+
+  uint32_t full;
+} lv_color32_t;
+
+inline lv_color_t lv_color_make(uint8_t r, uint8_t g, uint8_t b) {
+  lv_color_t color;
+  color.ch.green_h = g >> 5;
+  color.ch.red = r >> 3;
+  color.ch.blue = b >> 3;
+  color.ch.green_l = (g >> 2) & 0x07;
+  return color;
+}
+
+// File system
+
+enum { LV_FS_RES_OK = 0, LV_FS_RES_HW_ERR, LV_FS_RES_FS_ERR, LV_FS_RES_NOT_EX, LV_FS_RES_INV_PARAM = 11 };
+typedef uint8_t lv_fs_res_t;
+
+enum { LV_FS_MODE_WR = 0x01, LV_FS_MODE_RD = 0x02 };
+typedef uint8_t lv_fs_mode_t;
+
+typedef struct {
+  uint16_t file_size;
+} lv_fs_drv_t;
+
+typedef struct {
+  const std::vector<uint8_t>* file;
+  uint32_t position;
+  lv_fs_drv_t* drv;
+} lv_fs_file_t;
+
+inline std::map<std::string, std::vector<uint8_t>> fakeFiles;
+inline lv_fs_drv_t fakeFileDriver {64};
+inline size_t fakeFileOpens = 0;
+inline size_t fakeFileReads = 0;
+
+inline lv_fs_res_t lv_fs_open(lv_fs_file_t* file_p, const char* path, lv_fs_mode_t /*mode*/) {
+  auto file = fakeFiles.find(path);
+  if (file == fakeFiles.end()) {
+    return LV_FS_RES_NOT_EX;
+  }
+  file_p->file = &file->second;
+  file_p->position = 0;
+  file_p->drv = &fakeFileDriver;
+  fakeFileOpens++;
+  return LV_FS_RES_OK;
+}
+
+inline lv_fs_res_t lv_fs_close(lv_fs_file_t* file_p) {
+  file_p->file = nullptr;
+  return LV_FS_RES_OK;
+}
+
+inline lv_fs_res_t lv_fs_read(lv_fs_file_t* file_p, void* buf, uint32_t btr, uint32_t* br) {
+  uint32_t size = file_p->file->size();
+  uint32_t count = (file_p->position < size) ? std::min(btr, size - file_p->position) : 0;
+  std::memcpy(buf, file_p->file->data() + file_p->position, count);
+  file_p->position += count;
+  *br = count;
+  fakeFileReads++;
+  return LV_FS_RES_OK;
+}
+
+inline lv_fs_res_t lv_fs_seek(lv_fs_file_t* file_p, uint32_t pos) {
+  if (pos > file_p->file->size()) {
+    return LV_FS_RES_INV_PARAM;
+  }
+  file_p->position = pos;
+  return LV_FS_RES_OK;
+}
+
+// Fonts, with the uncompressed formats of lv_font_fmt_txt
+
+typedef struct {
+  uint16_t adv_w;
+  uint16_t box_w;
+  uint16_t box_h;
+  int16_t ofs_x;
+  int16_t ofs_y;
+  uint8_t bpp;
+} lv_font_glyph_dsc_t;
+
+typedef struct _lv_font_struct {
+  bool (*get_glyph_dsc)(const struct _lv_font_struct*, lv_font_glyph_dsc_t*, uint32_t letter, uint32_t letter_next);
+  const uint8_t* (*get_glyph_bitmap)(const struct _lv_font_struct*, uint32_t);
+  lv_coord_t line_height;
+  lv_coord_t base_line;
+  uint8_t subpx : 2;
+  int8_t underline_position;
+  int8_t underline_thickness;
+  void* dsc;
+  void* user_data;
+} lv_font_t;
+
+typedef struct {
+  uint32_t bitmap_index : 20;
+  uint32_t adv_w : 12;
+  uint8_t box_w;
+  uint8_t box_h;
+  int8_t ofs_x;
+  int8_t ofs_y;
+} lv_font_fmt_txt_glyph_dsc_t;
+
+enum {
+  LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL,
+  LV_FONT_FMT_TXT_CMAP_SPARSE_FULL,
+  LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY,
+  LV_FONT_FMT_TXT_CMAP_SPARSE_TINY,
+};
+typedef uint8_t lv_font_fmt_txt_cmap_type_t;
+
+typedef struct {
+  uint32_t range_start;
+  uint16_t range_length;
+  uint16_t glyph_id_start;
+  const uint16_t* unicode_list;
+  const void* glyph_id_ofs_list;
+  uint16_t list_length;
+  lv_font_fmt_txt_cmap_type_t type;
+} lv_font_fmt_txt_cmap_t;
+
+typedef struct {
+  const uint8_t* glyph_bitmap;
+  const lv_font_fmt_txt_glyph_dsc_t* glyph_dsc;
+  const lv_font_fmt_txt_cmap_t* cmaps;
+  const void* kern_dsc;
+  uint16_t kern_scale;
+  uint16_t cmap_num : 9;
+  uint16_t bpp : 4;
+  uint16_t kern_classes : 1;
+  uint16_t bitmap_format : 2;
+  uint32_t last_letter;
+  uint32_t last_glyph_id;
+} lv_font_fmt_txt_dsc_t;
+
+inline uint32_t FakeGlyphId(const lv_font_t* font, uint32_t letter) {
+  auto* dsc = static_cast<lv_font_fmt_txt_dsc_t*>(font->dsc);
+  if (letter == dsc->last_letter) {
+    return dsc->last_glyph_id;
+  }
+  uint32_t glyphId = 0;
+  for (uint16_t i = 0; i < dsc->cmap_num && glyphId == 0; i++) {
+    const lv_font_fmt_txt_cmap_t& cmap = dsc->cmaps[i];
+    uint32_t offset = letter - cmap.range_start;
+    if (letter < cmap.range_start || offset >= cmap.range_length) {
+      continue;
+    }
+    switch (cmap.type) {
+      case LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY:
+        glyphId = cmap.glyph_id_start + offset;
+        break;
+      case LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL:
+        glyphId = cmap.glyph_id_start + static_cast<const uint8_t*>(cmap.glyph_id_ofs_list)[offset];
+        break;
+      default:
+        for (uint16_t entry = 0; entry < cmap.list_length; entry++) {
+          if (cmap.unicode_list[entry] == offset) {
+            glyphId = cmap.glyph_id_start + ((cmap.type == LV_FONT_FMT_TXT_CMAP_SPARSE_TINY)
+                                               ? entry
+                                               : static_cast<const uint16_t*>(cmap.glyph_id_ofs_list)[entry]);
+          }
+        }
+        break;
+    }
+  }
+  dsc->last_letter = letter;
+  dsc->last_glyph_id = glyphId;
+  return glyphId;
+}
+
+inline bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t* font, lv_font_glyph_dsc_t* dsc_out, uint32_t letter, uint32_t /*next*/) {
+  auto* dsc = static_cast<lv_font_fmt_txt_dsc_t*>(font->dsc);
+  uint32_t glyphId = FakeGlyphId(font, letter);
+  if (glyphId == 0) {
+    return false;
+  }
+  const lv_font_fmt_txt_glyph_dsc_t& glyph = dsc->glyph_dsc[glyphId];
+  const auto advance = static_cast<uint16_t>((glyph.adv_w + 8) >> 4);
+  *dsc_out = {advance, glyph.box_w, glyph.box_h, glyph.ofs_x, glyph.ofs_y, static_cast<uint8_t>(dsc->bpp)};
+  return true;
+}
+
+inline const uint8_t* lv_font_get_bitmap_fmt_txt(const lv_font_t* font, uint32_t letter) {
+  auto* dsc = static_cast<lv_font_fmt_txt_dsc_t*>(font->dsc);
+  uint32_t glyphId = FakeGlyphId(font, letter);
+  return (glyphId == 0) ? nullptr : dsc->glyph_bitmap + dsc->glyph_dsc[glyphId].bitmap_index;
+}
+
+// Images
+
+#define LV_IMG_PX_SIZE_ALPHA_BYTE 3
+
+enum { LV_IMG_CF_TRUE_COLOR = 4, LV_IMG_CF_TRUE_COLOR_ALPHA = 5, LV_IMG_CF_INDEXED_1BIT = 7, LV_IMG_CF_USER_ENCODED_0 = 24 };
+typedef uint8_t lv_img_cf_t;
+
+typedef struct {
+  uint32_t cf : 5;
+  uint32_t always_zero : 3;
+  uint32_t reserved : 2;
+  uint32_t w : 11;
+  uint32_t h : 11;
+} lv_img_header_t;
+
+typedef struct {
+  lv_img_header_t header;
+  uint32_t data_size;
+  const uint8_t* data;
+} lv_img_dsc_t;
+
+enum { LV_IMG_SRC_VARIABLE, LV_IMG_SRC_FILE, LV_IMG_SRC_SYMBOL, LV_IMG_SRC_UNKNOWN };
+typedef uint8_t lv_img_src_t;
+
+// Paths start with a printable character, lv_img_dsc_t with the color format
+inline lv_img_src_t lv_img_src_get_type(const void* src) {
+  const uint8_t first = *static_cast<const uint8_t*>(src);
+  if (first >= 0x20 && first <= 0x7F) {
+    return LV_IMG_SRC_FILE;
+  }
+  return (first >= 0x80) ? LV_IMG_SRC_SYMBOL : LV_IMG_SRC_VARIABLE;
+}
+
+struct _lv_img_decoder;
+struct _lv_img_decoder_dsc;
+typedef lv_res_t (*lv_img_decoder_info_f_t)(struct _lv_img_decoder* decoder, const void* src, lv_img_header_t* header);
+typedef lv_res_t (*lv_img_decoder_open_f_t)(struct _lv_img_decoder* decoder, struct _lv_img_decoder_dsc* dsc);
+typedef lv_res_t (*lv_img_decoder_read_line_f_t)(
+  struct _lv_img_decoder* decoder, struct _lv_img_decoder_dsc* dsc, lv_coord_t x, lv_coord_t y, lv_coord_t len, uint8_t* buf);
+typedef void (*lv_img_decoder_close_f_t)(struct _lv_img_decoder* decoder, struct _lv_img_decoder_dsc* dsc);
+
+typedef struct _lv_img_decoder {
+  lv_img_decoder_info_f_t info_cb;
+  lv_img_decoder_open_f_t open_cb;
+  lv_img_decoder_read_line_f_t read_line_cb;
+  lv_img_decoder_close_f_t close_cb;
+  void* user_data;
+} lv_img_decoder_t;
+
+typedef struct _lv_img_decoder_dsc {
+  lv_img_decoder_t* decoder;
+  const void* src;
+  lv_color_t color;
+  lv_img_src_t src_type;
+  lv_img_header_t header;
+  const uint8_t* img_data;
+  uint32_t time_to_open;
+  const char* error_msg;
+  void* user_data;
+} lv_img_decoder_dsc_t;
+
+// A single decoder can be registered
+inline lv_img_decoder_t fakeImageDecoder;
+
+inline lv_img_decoder_t* lv_img_decoder_create() {
+  fakeImageDecoder = {};
+  return &fakeImageDecoder;
+}
+
+inline void lv_img_decoder_set_info_cb(lv_img_decoder_t* decoder, lv_img_decoder_info_f_t info_cb) {
+  decoder->info_cb = info_cb;
+}
+
+inline void lv_img_decoder_set_open_cb(lv_img_decoder_t* decoder, lv_img_decoder_open_f_t open_cb) {
+  decoder->open_cb = open_cb;
+}
+
+inline void lv_img_decoder_set_read_line_cb(lv_img_decoder_t* decoder, lv_img_decoder_read_line_f_t read_line_cb) {
+  decoder->read_line_cb = read_line_cb;
+}
+
+inline void lv_img_decoder_set_close_cb(lv_img_decoder_t* decoder, lv_img_decoder_close_f_t close_cb) {
+  decoder->close_cb = close_cb;
+}
+
+// Objects and drawing
+
+#define LV_HOR_RES LV_HOR_RES_MAX
+#define LV_VER_RES LV_VER_RES_MAX
+
+typedef struct {
+  lv_coord_t x;
+  lv_coord_t y;
+} lv_point_t;
+
+typedef struct {
+  lv_coord_t x1;
+  lv_coord_t y1;
+  lv_coord_t x2;
+  lv_coord_t y2;
+} lv_area_t;
+
+enum { LV_DESIGN_DRAW_MAIN, LV_DESIGN_DRAW_POST, LV_DESIGN_COVER_CHK };
+typedef uint8_t lv_design_mode_t;
+
+enum { LV_DESIGN_RES_OK, LV_DESIGN_RES_COVER, LV_DESIGN_RES_NOT_COVER, LV_DESIGN_RES_MASKED };
+typedef uint8_t lv_design_res_t;
+
+struct _lv_obj_t;
+typedef lv_design_res_t (*lv_design_cb_t)(struct _lv_obj_t* obj, const lv_area_t* clip_area, lv_design_mode_t mode);
+
+typedef struct _lv_obj_t {
+  lv_design_cb_t design_cb;
+  void* user_data;
+} lv_obj_t;
+
+typedef struct {
+  lv_color_t color;
+  lv_coord_t width;
+  lv_opa_t opa;
+  uint8_t round_start : 1;
+  uint8_t round_end : 1;
+} lv_draw_line_dsc_t;
+
+struct FakeLine {
+  lv_point_t start;
+  lv_point_t end;
+  lv_area_t clip;
+  lv_draw_line_dsc_t dsc;
+};
+
+inline std::deque<lv_obj_t> fakeObjects;
+inline std::vector<lv_area_t> fakeInvalidatedAreas;
+inline std::vector<FakeLine> fakeLines;
+
+inline lv_obj_t* lv_obj_create(lv_obj_t* /*parent*/, const lv_obj_t* /*copy*/) {
+  return &fakeObjects.emplace_back();
+}
+
+inline void lv_obj_set_size(lv_obj_t* /*obj*/, lv_coord_t /*w*/, lv_coord_t /*h*/) {
+}
+
+inline void lv_obj_set_pos(lv_obj_t* /*obj*/, lv_coord_t /*x*/, lv_coord_t /*y*/) {
+}
+
+inline void lv_obj_set_click(lv_obj_t* /*obj*/, bool /*en*/) {
+}
+
+inline void lv_obj_set_user_data(lv_obj_t* obj, void* data) {
+  obj->user_data = data;
+}
+
+inline void* lv_obj_get_user_data(const lv_obj_t* obj) {
+  return obj->user_data;
+}
+
+inline void lv_obj_set_design_cb(lv_obj_t* obj, lv_design_cb_t design_cb) {
+  obj->design_cb = design_cb;
+}
+
+inline void lv_obj_invalidate_area(const lv_obj_t* /*obj*/, const lv_area_t* area) {
+  fakeInvalidatedAreas.push_back(*area);
+}
+
+inline bool _lv_area_intersect(lv_area_t* res_p, const lv_area_t* a1_p, const lv_area_t* a2_p) {
+  res_p->x1 = std::max(a1_p->x1, a2_p->x1);
+  res_p->y1 = std::max(a1_p->y1, a2_p->y1);
+  res_p->x2 = std::min(a1_p->x2, a2_p->x2);
+  res_p->y2 = std::min(a1_p->y2, a2_p->y2);
+  return res_p->x1 <= res_p->x2 && res_p->y1 <= res_p->y2;
+}
+
+inline void lv_draw_line_dsc_init(lv_draw_line_dsc_t* dsc) {
+  *dsc = {};
+  dsc->width = 1;
+  dsc->opa = 255;
+}
+
+inline void lv_draw_line(const lv_point_t* point1, const lv_point_t* point2, const lv_area_t* clip, const lv_draw_line_dsc_t* dsc) {
+  fakeLines.push_back({*point1, *point2, *clip, *dsc});
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <cstdint>
+
+// Register model of the peripherals used by the drivers under test. The registers are plain memory: the tests play the
+// role of the hardware by reading what the driver programmed and raising the events themselves.
+
+// Write-one-to-set and write-one-to-clear interrupt registers, which update the interrupts enabled in INTEN
+struct FakeIntenSet {
+  volatile uint32_t* inten;
+
+  void operator=(uint32_t mask) {
+    *inten = *inten | mask;
+  }
+
+  operator uint32_t() const {
+    return *inten;
+  }
+};
+
+struct FakeIntenClear {
+  volatile uint32_t* inten;
+
+  void operator=(uint32_t mask) {
+    *inten = *inten & ~mask;
+  }
+
+  operator uint32_t() const {
+    return *inten;
+  }
+};
+
+struct NRF_SPIM_Type {
+  volatile uint32_t TASKS_START = 0;
+  volatile uint32_t TASKS_STOP = 0;
+  volatile uint32_t EVENTS_STOPPED = 0;
+  volatile uint32_t EVENTS_ENDRX = 0;
+  volatile uint32_t EVENTS_END = 0;
+  volatile uint32_t EVENTS_ENDTX = 0;
+  volatile uint32_t EVENTS_STARTED = 0;
+  volatile uint32_t INTEN = 0;
+  FakeIntenSet INTENSET {&INTEN};
+  FakeIntenClear INTENCLR {&INTEN};
+  volatile uint32_t ENABLE = 0;
+  volatile uint32_t PSELSCK = 0;
+  volatile uint32_t PSELMOSI = 0;
+  volatile uint32_t PSELMISO = 0;
+  volatile uint32_t FREQUENCY = 0;
+  volatile uint32_t CONFIG = 0;
+
+  struct {
+    volatile uint32_t PTR = 0;
+    volatile uint32_t MAXCNT = 0;
+    volatile uint32_t AMOUNT = 0;
+    volatile uint32_t LIST = 0;
+  } TXD, RXD;
+};
+
+struct NRF_TIMER_Type {
+  volatile uint32_t TASKS_START = 0;
+  volatile uint32_t TASKS_STOP = 0;
+  volatile uint32_t TASKS_COUNT = 0;
+  volatile uint32_t TASKS_CLEAR = 0;
+  volatile uint32_t EVENTS_COMPARE[6] = {};
+  volatile uint32_t INTENSET = 0;
+  volatile uint32_t MODE = 0;
+  volatile uint32_t BITMODE = 0;
+  volatile uint32_t CC[6] = {};
+};
+
+inline NRF_SPIM_Type fakeSpim0;
+inline NRF_SPIM_Type fakeSpim1;
+inline NRF_TIMER_Type fakeTimer3;
+
+#define NRF_SPIM0       (&fakeSpim0)
+#define NRF_SPIM1       (&fakeSpim1)
+#define NRF_TIMER3_BASE (&fakeTimer3)
+
+#define SPIM_ENABLE_ENABLE_Pos        (0UL)
+#define SPIM_ENABLE_ENABLE_Disabled   (0UL)
+#define SPIM_ENABLE_ENABLE_Enabled    (7UL)
+#define SPIM_TXD_LIST_LIST_Pos        (0UL)
+#define SPIM_TXD_LIST_LIST_ArrayList  (1UL)
+#define SPIM_RXD_LIST_LIST_Pos        (0UL)
+#define SPIM_RXD_LIST_LIST_ArrayList  (1UL)
+#define SPIM_INTENSET_END_Msk         (1UL << 6)
+
+#define TIMER_MODE_MODE_Pos           (0UL)
+#define TIMER_MODE_MODE_Counter       (1UL)
+#define TIMER_BITMODE_BITMODE_Pos     (0UL)
+#define TIMER_BITMODE_BITMODE_16Bit   (0UL)
+#define TIMER_INTENSET_COMPARE1_Msk   (1UL << 17)
+
+enum IRQn_Type { SPIM0_SPIS0_TWIM0_TWIS0_SPI0_TWI0_IRQn = 3, TIMER3_IRQn = 26 };
+
+#define NRFX_IRQ_PRIORITY_SET(irq, priority)
+#define NRFX_IRQ_ENABLE(irq)
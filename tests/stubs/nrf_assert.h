@@ -0,0 +1,4 @@
+#pragma once
+#include <cassert>
+
+#define ASSERT(expression) assert(expression)
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include "nrf.h"
+
+enum nrf_ppi_channel_t { NRF_PPI_CHANNEL3 = 3, NRF_PPI_CHANNEL6 = 6, NRF_PPI_CHANNEL7 = 7 };
+enum nrf_ppi_channel_group_t { NRF_PPI_CHANNEL_GROUP0 = 0 };
+
+// Channels and groups are bit masks, the endpoints are not modelled
+struct FakePpi {
+  uint32_t enabledChannels = 0;
+  uint32_t groups[6] = {};
+  uint32_t enabledGroups = 0;
+};
+
+inline FakePpi fakePpi;
+
+inline void nrf_ppi_channel_endpoint_setup(nrf_ppi_channel_t, uint32_t, uint32_t) {
+}
+
+inline uint32_t nrf_ppi_task_group_disable_address_get(nrf_ppi_channel_group_t) {
+  return 0;
+}
+
+inline void nrf_ppi_channel_enable(nrf_ppi_channel_t channel) {
+  fakePpi.enabledChannels |= 1U << channel;
+}
+
+inline void nrf_ppi_channel_disable(nrf_ppi_channel_t channel) {
+  fakePpi.enabledChannels &= ~(1U << channel);
+}
+
+inline void nrf_ppi_group_clear(nrf_ppi_channel_group_t group) {
+  fakePpi.groups[group] = 0;
+}
+
+inline void nrf_ppi_channel_include_in_group(nrf_ppi_channel_t channel, nrf_ppi_channel_group_t group) {
+  fakePpi.groups[group] |= 1U << channel;
+}
+
+inline void nrf_ppi_group_enable(nrf_ppi_channel_group_t group) {
+  fakePpi.enabledGroups |= 1U << group;
+  fakePpi.enabledChannels |= fakePpi.groups[group];
+}
+
+inline void nrf_ppi_group_disable(nrf_ppi_channel_group_t group) {
+  fakePpi.enabledGroups &= ~(1U << group);
+  fakePpi.enabledChannels &= ~fakePpi.groups[group];
+}
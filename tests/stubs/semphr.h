@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdio>
+#include <cstdlib>
+#include "FreeRTOS.h"
+
+struct FakeSemaphore {
+  UBaseType_t count;
+};
+
+using SemaphoreHandle_t = FakeSemaphore*;
+
+inline FakeSemaphore fakeSemaphores[64];
+inline size_t nbFakeSemaphores = 0;
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex() {
+  fakeSemaphores[nbFakeSemaphores] = {1};
+  return &fakeSemaphores[nbFakeSemaphores++];
+}
+
+inline SemaphoreHandle_t xSemaphoreCreateBinary() {
+  fakeSemaphores[nbFakeSemaphores] = {0};
+  return &fakeSemaphores[nbFakeSemaphores++];
+}
+
+// No other task could give the semaphore: waiting for it is a deadlock
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait) {
+  if (semaphore->count == 0) {
+    if (ticksToWait != 0) {
+      std::printf("Deadlock: waiting for a semaphore that no other task can give\n");
+      std::abort();
+    }
+    return pdFALSE;
+  }
+  semaphore->count = 0;
+  return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+  semaphore->count = 1;
+  return pdTRUE;
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include "FreeRTOS.h"
+
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+
+// Set by the tests that need the other tasks to progress while the code under test waits
+inline void (*fakeOtherTasks)() = nullptr;
+
+inline void vTaskDelay(TickType_t ticks) {
+  fakeTickCount += ticks;
+  if (fakeOtherTasks != nullptr) {
+    fakeOtherTasks();
+  }
+}
+
+inline TickType_t xTaskGetTickCount() {
+  return fakeTickCount;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include "FreeRTOS.h"
+
+struct FakeTimer;
+using TimerHandle_t = FakeTimer*;
+using TimerCallbackFunction_t = void (*)(TimerHandle_t);
+
+struct FakeTimer {
+  TimerCallbackFunction_t callback;
+  void* id;
+  bool active;
+};
+
+inline FakeTimer fakeTimers[64];
+inline size_t nbFakeTimers = 0;
+
+inline TimerHandle_t xTimerCreate(const char*, TickType_t, UBaseType_t, void* id, TimerCallbackFunction_t callback) {
+  fakeTimers[nbFakeTimers] = {callback, id, false};
+  return &fakeTimers[nbFakeTimers++];
+}
+
+inline BaseType_t xTimerStart(TimerHandle_t timer, TickType_t) {
+  timer->active = true;
+  return pdPASS;
+}
+
+inline BaseType_t xTimerStop(TimerHandle_t timer, TickType_t) {
+  timer->active = false;
+  return pdPASS;
+}
+
+inline void* pvTimerGetTimerID(TimerHandle_t timer) {
+  return timer->id;
+}
+
+// Plays the timer task: calls the timers that were started. Returns false if none was.
+inline bool RunFakeTimerTask() {
+  bool ran = false;
+  for (size_t i = 0; i < nbFakeTimers; i++) {
+    if (fakeTimers[i].active) {
+      fakeTimers[i].active = false;
+      fakeTimers[i].callback(&fakeTimers[i]);
+      ran = true;
+    }
+  }
+  return ran;
+}
+
+// Plays the timer task on the next tick
+inline bool RunFakeTimers() {
+  fakeTickCount++;
+  return RunFakeTimerTask();
+}